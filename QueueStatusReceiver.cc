@@ -12,6 +12,7 @@
 
 #include <arpa/inet.h> // Per ntohl
 #include "csv_logger.h"
+#include "hot_path_profiler.h"
 
 namespace ns3
 {
@@ -78,6 +79,7 @@ QueueStatusReceiver::StopApplication()
 void
 QueueStatusReceiver::HandleRead(Ptr<Socket> socket)
 {
+    QSE_PROFILE_SCOPE(QUEUE_STATUS_RECEIVE);
     Ptr<Packet> packet;
     Address from;
     while ((packet = socket->RecvFrom(from)))
@@ -1,6 +1,6 @@
 #include "QueueStatusSender.h"
 
-#include "dag_database.h"
+#include "hot_path_profiler.h"
 
 #include "ns3/core-module.h"
 #include "ns3/ipv6-address.h"
@@ -18,9 +18,13 @@ using namespace ns3;
 
 NS_LOG_COMPONENT_DEFINE("QueueStatusSender");
 
+uint64_t QueueStatusApp::s_packetsSent = 0;
+uint64_t QueueStatusApp::s_bytesSent = 0;
+
 QueueStatusApp::QueueStatusApp()
     : m_socket(0),
-      m_running(false)
+      m_running(false),
+      m_interval(MilliSeconds(10))
 {
 }
 
@@ -35,6 +39,7 @@ QueueStatusApp::Setup(Ipv6Address source,
                       std::string nameSource,
                       std::string nameDestination,
                       std::shared_ptr<std::vector<std::vector<Action>>> q_registerSource,
+                      int32_t indexNodeSource,
                       int32_t indexNodeDestination)
 {
     m_destinationAddress = destination;
@@ -42,9 +47,34 @@ QueueStatusApp::Setup(Ipv6Address source,
     m_nameSource = nameSource;
     m_nameDestination = nameDestination;
     m_q_registerSource = q_registerSource;
+    m_indexNodeSource = indexNodeSource;
     m_indexNodeDestination = indexNodeDestination;
 }
 
+void
+QueueStatusApp::SetInterval(Time interval)
+{
+    m_interval = interval;
+}
+
+void
+QueueStatusApp::SetDags(std::shared_ptr<const DagSet> dags)
+{
+    m_dags = dags;
+}
+
+uint64_t
+QueueStatusApp::GetTotalPacketsSent()
+{
+    return s_packetsSent;
+}
+
+uint64_t
+QueueStatusApp::GetTotalBytesSent()
+{
+    return s_bytesSent;
+}
+
 void
 QueueStatusApp::StartApplication()
 {
@@ -54,31 +84,31 @@ QueueStatusApp::StartApplication()
     m_socket->Bind();
 
     m_running = true;
+    NS_ABORT_MSG_IF(!m_dags, "QueueStatusApp: DAG non impostati (SetDags)");
+    m_selectedLines = selectQRegisterLines(m_indexNodeSource, m_indexNodeDestination);
 
-    Time sendTime = Seconds(2.1);
-    m_sendEvent =
-        Simulator::Schedule(sendTime - Simulator::Now(), &QueueStatusApp::SendQueueStatus, this);
+    // primo invio 100 ms dopo l'avvio (con l'avvio di default a 2 s, a 2.1 s)
+    m_sendEvent = Simulator::Schedule(MilliSeconds(100), &QueueStatusApp::SendQueueStatus, this);
 }
 
 std::vector<uint32_t>
-QueueStatusApp::selectQRegisterLines(int32_t indexNodeDestination, std::string nameSource)
+QueueStatusApp::selectQRegisterLines(int32_t indexNodeSource, int32_t indexNodeDestination)
 {
-    std::vector<Dag> dags = LoadDags();
     std::vector<uint32_t> selectedLines;
-
-    for (uint32_t i = 0; i < dags.size(); ++i)
+    if (indexNodeSource < 0 || indexNodeDestination < 0 ||
+        static_cast<size_t>(indexNodeSource) >= m_dags->GetNNodes() ||
+        static_cast<size_t>(indexNodeDestination) >= m_dags->GetNNodes())
     {
-        const auto& dag = dags[i];
+        return selectedLines;
+    }
+    uint32_t sourceIndex = indexNodeSource;
 
-        if (indexNodeDestination >= 0 &&
-            static_cast<size_t>(indexNodeDestination) < dag.adjacency_list.size())
+    // DAG in cui il vicino può inoltrare verso questo nodo
+    for (uint32_t i = 0; i < m_dags->GetNNodes(); ++i)
+    {
+        if (m_dags->IsSuccessor(i, indexNodeDestination, sourceIndex))
         {
-            const auto& row = dag.adjacency_list[indexNodeDestination];
-
-            if (std::find(row.begin(), row.end(), nameSource) != row.end())
-            {
-                selectedLines.push_back(i);
-            }
+            selectedLines.push_back(i);
         }
     }
 
@@ -151,6 +181,7 @@ QueueStatusApp::PrintQRegisterForNode(
 void
 QueueStatusApp::SendQueueStatus()
 {
+    QSE_PROFILE_SCOPE(QUEUE_STATUS_SEND);
     Time now = Simulator::Now();
 
     //PrintQRegisterForNode(m_nameSource, m_q_registerSource);
@@ -158,16 +189,12 @@ QueueStatusApp::SendQueueStatus()
               << "s Sto mandando il pacchetto contenente i valori q, destinato a: "
               << m_nameDestination << std::endl;
 */
-    // individua le righe da selezionare
-    std::vector<uint32_t> selectedLines =
-        selectQRegisterLines(m_indexNodeDestination, m_nameSource);
-
     if (!m_running)
         return;
 
     std::vector<uint8_t> buffer; // buffer che conterrà i dati del pacchetto
 
-    for (uint32_t lineIndex : selectedLines)
+    for (uint32_t lineIndex : m_selectedLines)
     {
         if (lineIndex < m_q_registerSource->size() && !(*m_q_registerSource)[lineIndex].empty())
         {
@@ -209,7 +236,11 @@ QueueStatusApp::SendQueueStatus()
     //          << std::endl;
 
     // invio pacchetto
-    m_socket->SendTo(packet, 0, Inet6SocketAddress(m_destinationAddress, 0));
+    if (m_socket->SendTo(packet, 0, Inet6SocketAddress(m_destinationAddress, 0)) >= 0)
+    {
+        s_packetsSent++;
+        s_bytesSent += packet->GetSize();
+    }
 
     ScheduleNextQueueStatus();
 }
@@ -217,5 +248,5 @@ QueueStatusApp::SendQueueStatus()
 void
 QueueStatusApp::ScheduleNextQueueStatus()
 {
-    m_sendEvent = Simulator::Schedule(Seconds(0.01), &QueueStatusApp::SendQueueStatus, this);
+    m_sendEvent = Simulator::Schedule(m_interval, &QueueStatusApp::SendQueueStatus, this);
 }
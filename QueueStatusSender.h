@@ -1,4 +1,5 @@
 #include "action.h"
+#include "dag_builder.h"
 
 #include "ns3/application.h"
 #include "ns3/ipv6-address.h"
@@ -18,7 +19,17 @@ class QueueStatusApp : public Application
                std::string nameSource,
                std::string nameDestination,
                std::shared_ptr<std::vector<std::vector<Action>>> q_registerSource,
+               int32_t indexNodeSource,
                int32_t indexNodeDestination);
+    // intervallo tra due invii dello stato (default 10 ms)
+    void SetInterval(Time interval);
+    // DAG per destinazione condivisi tra i sender, obbligatori prima dell'avvio
+    void SetDags(std::shared_ptr<const DagSet> dags);
+
+    // overhead di controllo: pacchetti di stato e byte di payload inviati da
+    // tutte le istanze (il payload non include gli header IPv6 e PPP)
+    static uint64_t GetTotalPacketsSent();
+    static uint64_t GetTotalBytesSent();
 
   private:
     virtual void StartApplication() override;
@@ -27,8 +38,8 @@ class QueueStatusApp : public Application
 
     void SendQueueStatus();
     void ScheduleNextQueueStatus();
-    std::vector<uint32_t> selectQRegisterLines(int32_t indexNodeDestination,
-                                               std::string nameSource);
+    std::vector<uint32_t> selectQRegisterLines(int32_t indexNodeSource,
+                                               int32_t indexNodeDestination);
     uint32_t GetMinQValueInRow(const std::vector<Action>& row);
     void PrintQRegisterForNode(
         const std::string& nameSource,
@@ -43,5 +54,13 @@ class QueueStatusApp : public Application
     std:: string m_nameSource;
     std:: string m_nameDestination;
     std::shared_ptr<std::vector<std::vector<Action>>> m_q_registerSource;
+    std:: int32_t m_indexNodeSource;
     std:: int32_t m_indexNodeDestination;
+    Time m_interval;
+    std::shared_ptr<const DagSet> m_dags;
+    // righe del Q-register da inviare, fisse perché i DAG non cambiano
+    std::vector<uint32_t> m_selectedLines;
+
+    static uint64_t s_packetsSent;
+    static uint64_t s_bytesSent;
 };
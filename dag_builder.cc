@@ -0,0 +1,255 @@
+#include "dag_builder.h"
+
+#include "ns3/abort.h"
+
+#include <algorithm>
+#include <functional>
+#include <iomanip>
+#include <limits>
+#include <queue>
+#include <unordered_map>
+
+namespace
+{
+
+struct Edge
+{
+    uint32_t to;
+    double cost;
+};
+
+// tolleranza relativa nei confronti tra costi non interi
+constexpr double kEpsilon = 1e-9;
+
+} // namespace
+
+DagSet
+DagSet::FromDags(const std::vector<std::string>& nodeNames, const std::vector<Dag>& dags)
+{
+    NS_ABORT_MSG_IF(dags.size() != nodeNames.size(),
+                    "servono " << nodeNames.size() << " DAG, uno per nodo, non " << dags.size());
+    std::unordered_map<std::string, uint32_t> index;
+    for (uint32_t i = 0; i < nodeNames.size(); ++i)
+    {
+        index[nodeNames[i]] = i;
+    }
+
+    DagSet set;
+    set.m_nodeNames = nodeNames;
+    set.m_offsets.reserve(nodeNames.size() * nodeNames.size() + 1);
+    for (uint32_t dst = 0; dst < dags.size(); ++dst)
+    {
+        const auto& rows = dags[dst].adjacency_list;
+        NS_ABORT_MSG_IF(rows.size() != nodeNames.size(),
+                        "il DAG di " << nodeNames[dst] << " ha " << rows.size() << " righe");
+        for (uint32_t node = 0; node < rows.size(); ++node)
+        {
+            set.m_offsets.push_back(set.m_successors.size());
+            for (const auto& next : rows[node])
+            {
+                if (next == "sink")
+                {
+                    continue;
+                }
+                auto it = index.find(next);
+                NS_ABORT_MSG_IF(it == index.end(),
+                                "nodo sconosciuto " << next << " nel DAG di " << nodeNames[dst]);
+                set.m_successors.push_back(it->second);
+            }
+        }
+    }
+    set.m_offsets.push_back(set.m_successors.size());
+    return set;
+}
+
+size_t
+DagSet::GetNNodes() const
+{
+    return m_nodeNames.size();
+}
+
+const std::string&
+DagSet::GetNodeName(uint32_t index) const
+{
+    return m_nodeNames.at(index);
+}
+
+DagSet::Range
+DagSet::GetSuccessors(uint32_t dst, uint32_t node) const
+{
+    size_t row = static_cast<size_t>(dst) * m_nodeNames.size() + node;
+    return Range{m_successors.data() + m_offsets[row], m_successors.data() + m_offsets[row + 1]};
+}
+
+bool
+DagSet::IsSuccessor(uint32_t dst, uint32_t node, uint32_t next) const
+{
+    Range successors = GetSuccessors(dst, node);
+    return std::find(successors.begin(), successors.end(), next) != successors.end();
+}
+
+std::vector<std::vector<Action>>
+DagSet::BuildQRegister(uint32_t node) const
+{
+    std::vector<std::vector<Action>> qRegister(m_nodeNames.size());
+    for (uint32_t dst = 0; dst < m_nodeNames.size(); ++dst)
+    {
+        auto& row = qRegister[dst];
+        if (dst == node)
+        {
+            row.push_back(Action{"sink", 0, nullptr});
+            continue;
+        }
+        Range successors = GetSuccessors(dst, node);
+        row.reserve(successors.size());
+        for (uint32_t next : successors)
+        {
+            row.push_back(Action{m_nodeNames[next], 0, nullptr});
+        }
+    }
+    return qRegister;
+}
+
+void
+DagSet::WriteSummary(std::ostream& os) const
+{
+    size_t rows = 0;
+    size_t single = 0;
+    size_t maxSuccessors = 0;
+    for (uint32_t dst = 0; dst < m_nodeNames.size(); ++dst)
+    {
+        for (uint32_t node = 0; node < m_nodeNames.size(); ++node)
+        {
+            if (node == dst)
+            {
+                continue;
+            }
+            size_t n = GetSuccessors(dst, node).size();
+            rows++;
+            single += n == 1 ? 1 : 0;
+            maxSuccessors = std::max(maxSuccessors, n);
+        }
+    }
+    os << "[DAG] righe=" << rows << " successori=" << m_successors.size()
+       << " successori_medi=" << std::fixed << std::setprecision(3)
+       << (rows ? static_cast<double>(m_successors.size()) / rows : 0.0) << std::defaultfloat
+       << " successori_max=" << maxSuccessors << " righe_senza_alternative=" << single
+       << std::endl;
+}
+
+DagSet
+BuildDagSet(const Topology& topology, DagMetric metric, double stretch)
+{
+    NS_ABORT_MSG_IF(stretch < 1.0, "lo stretch dei DAG deve essere >= 1");
+    const auto& nodes = topology.nodes;
+    const size_t n = nodes.size();
+    std::unordered_map<std::string, uint32_t> index;
+    for (uint32_t i = 0; i < n; ++i)
+    {
+        index[nodes[i]] = i;
+    }
+
+    double maxCapacity = 0.0;
+    for (const auto& link : topology.links)
+    {
+        maxCapacity = std::max(maxCapacity, link.capacityMbps);
+    }
+    std::vector<std::vector<Edge>> adjacency(n);
+    for (const auto& link : topology.links)
+    {
+        double cost = 1.0;
+        if (metric == DagMetric::DELAY)
+        {
+            // i link a ritardo nullo costerebbero zero e annullerebbero il vincolo
+            cost = std::max(link.delayMs, 1e-6);
+        }
+        else if (metric == DagMetric::CAPACITY)
+        {
+            cost = maxCapacity / link.capacityMbps;
+        }
+        uint32_t a = index.at(link.source);
+        uint32_t b = index.at(link.target);
+        adjacency[a].push_back({b, cost});
+        adjacency[b].push_back({a, cost});
+    }
+    // successori in ordine di indice, come nei DAG scritti a mano
+    for (auto& edges : adjacency)
+    {
+        std::sort(edges.begin(), edges.end(), [](const Edge& x, const Edge& y) {
+            return x.to < y.to;
+        });
+    }
+
+    DagSet set;
+    set.m_nodeNames = nodes;
+    set.m_offsets.reserve(n * n + 1);
+
+    using Entry = std::pair<double, uint32_t>;
+    std::vector<double> distance(n);
+    for (uint32_t dst = 0; dst < n; ++dst)
+    {
+        // Dijkstra dalla destinazione: il grafo non è orientato
+        std::fill(distance.begin(), distance.end(), std::numeric_limits<double>::infinity());
+        std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry>> queue;
+        distance[dst] = 0.0;
+        queue.emplace(0.0, dst);
+        while (!queue.empty())
+        {
+            auto [d, u] = queue.top();
+            queue.pop();
+            if (d > distance[u])
+            {
+                continue;
+            }
+            for (const auto& edge : adjacency[u])
+            {
+                if (d + edge.cost < distance[edge.to])
+                {
+                    distance[edge.to] = d + edge.cost;
+                    queue.emplace(distance[edge.to], edge.to);
+                }
+            }
+        }
+
+        for (uint32_t u = 0; u < n; ++u)
+        {
+            set.m_offsets.push_back(set.m_successors.size());
+            if (u == dst)
+            {
+                continue;
+            }
+            double tolerance = kEpsilon * std::max(1.0, distance[u]);
+            for (const auto& edge : adjacency[u])
+            {
+                // ordine totale (distanza, indice): a pari distanza solo verso indici minori
+                double dv = distance[edge.to];
+                bool closer = dv < distance[u] - tolerance ||
+                              (dv <= distance[u] + tolerance && edge.to < u);
+                if (closer && edge.cost + dv <= stretch * distance[u] + tolerance)
+                {
+                    set.m_successors.push_back(edge.to);
+                }
+            }
+        }
+    }
+    set.m_offsets.push_back(set.m_successors.size());
+    return set;
+}
+
+DagMetric
+ParseDagMetric(const std::string& name)
+{
+    if (name == "hops")
+    {
+        return DagMetric::HOPS;
+    }
+    if (name == "delay")
+    {
+        return DagMetric::DELAY;
+    }
+    if (name == "capacity")
+    {
+        return DagMetric::CAPACITY;
+    }
+    NS_FATAL_ERROR("dagMetric deve essere hops, delay o capacity: " << name);
+}
@@ -0,0 +1,74 @@
+#ifndef DAG_BUILDER_H
+#define DAG_BUILDER_H
+
+#include "action.h"
+#include "dag_database.h"
+#include "topology.h"
+
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <vector>
+
+// costo di un collegamento nel calcolo dei DAG
+enum class DagMetric
+{
+    HOPS,     // 1 per link
+    DELAY,    // ritardo di propagazione
+    CAPACITY, // capacità massima / capacità del link, come il costo OSPF
+};
+
+// DAG per destinazione in forma compatta: per ogni coppia (destinazione,
+// nodo) gli indici dei successori ammessi, in un unico vettore (CSR). Gli
+// indici sono le posizioni in nodeNames; la destinazione non ha successori
+// e consegna al sink.
+class DagSet
+{
+  public:
+    // successori di un nodo verso una destinazione
+    struct Range
+    {
+        const uint32_t* first;
+        const uint32_t* last;
+
+        const uint32_t* begin() const { return first; }
+        const uint32_t* end() const { return last; }
+        size_t size() const { return last - first; }
+    };
+
+    // conversione dei DAG scritti a mano (dag_database.cc), nello stesso ordine di nodeNames
+    static DagSet FromDags(const std::vector<std::string>& nodeNames, const std::vector<Dag>& dags);
+
+    size_t GetNNodes() const;
+    const std::string& GetNodeName(uint32_t index) const;
+
+    Range GetSuccessors(uint32_t dst, uint32_t node) const;
+    bool IsSuccessor(uint32_t dst, uint32_t node, uint32_t next) const;
+
+    // Q-register di node: una riga per destinazione con un'azione (q = 0) per
+    // successore, "sink" per la destinazione stessa
+    std::vector<std::vector<Action>> BuildQRegister(uint32_t node) const;
+
+    // una riga [DAG] con successori medi e massimi e righe con un solo successore
+    void WriteSummary(std::ostream& os) const;
+
+  private:
+    friend DagSet BuildDagSet(const Topology&, DagMetric, double);
+
+    std::vector<std::string> m_nodeNames;
+    std::vector<uint32_t> m_offsets;    // (dst * N + node) -> inizio in m_successors
+    std::vector<uint32_t> m_successors;
+};
+
+// DAG senza cicli calcolati dalla topologia (già normalizzata) con un Dijkstra
+// per destinazione, O(N·E log N). Il nodo u può inoltrare verso il vicino v se
+// v precede u nell'ordine (distanza dalla destinazione, indice), che decresce
+// a ogni salto e quindi esclude i cicli, e se il percorso via v costa al più
+// stretch volte il minimo: stretch = 1 dà i DAG ECMP, valori maggiori
+// aggiungono alternative più lunghe, anche tra nodi alla stessa distanza
+DagSet BuildDagSet(const Topology& topology, DagMetric metric, double stretch);
+
+// "hops", "delay" o "capacity"; termina con errore per altri nomi
+DagMetric ParseDagMetric(const std::string& name);
+
+#endif // DAG_BUILDER_H
@@ -0,0 +1,147 @@
+#include "flow_class_monitor.h"
+
+#include "ns3/ipv6-flow-classifier.h"
+#include "ns3/tcp-l4-protocol.h"
+#include "ns3/udp-l4-protocol.h"
+
+#include <iomanip>
+
+using namespace ns3;
+
+FlowClassMonitor::FlowClassMonitor(std::shared_ptr<const HostDirectory> hosts)
+    : m_hosts(hosts)
+{
+}
+
+void
+FlowClassMonitor::Install(NodeContainer hosts)
+{
+    m_monitor = m_helper.Install(hosts);
+}
+
+void
+FlowClassMonitor::TrackUdpApplication(const Ipv6Address& source,
+                                      Ptr<TimeStampedOnOffApplication> app,
+                                      uint8_t trafficType)
+{
+    m_apps.push_back({source, app, trafficType});
+}
+
+void
+FlowClassMonitor::SetTcpPort(uint16_t port, uint8_t trafficType)
+{
+    m_tcpPorts[port] = trafficType;
+}
+
+void
+FlowClassMonitor::Collect()
+{
+    if (m_collected)
+    {
+        return;
+    }
+    m_collected = true;
+
+    // porta registrata dall'applicazione all'avvio: a fine simulazione il
+    // socket è già chiuso e non ha più un endpoint
+    for (const auto& tracked : m_apps)
+    {
+        uint16_t port = tracked.app->GetLocalPort();
+        if (port != 0)
+        {
+            m_udpSources[{tracked.source, port}] = tracked.trafficType;
+        }
+    }
+    m_monitor->CheckForLostPackets();
+}
+
+uint8_t
+FlowClassMonitor::Classify(const Ipv6FlowClassifier::FiveTuple& t) const
+{
+    if (t.protocol == UdpL4Protocol::PROT_NUMBER)
+    {
+        auto it = m_udpSources.find({t.sourceAddress, t.sourcePort});
+        return it == m_udpSources.end() ? kUnclassified : it->second;
+    }
+    if (t.protocol == TcpL4Protocol::PROT_NUMBER)
+    {
+        for (uint16_t port : {t.destinationPort, t.sourcePort})
+        {
+            auto it = m_tcpPorts.find(port);
+            if (it != m_tcpPorts.end())
+            {
+                return it->second;
+            }
+        }
+    }
+    return kUnclassified;
+}
+
+void
+FlowClassMonitor::WriteFlowCsv(std::ostream& os)
+{
+    Collect();
+    Ptr<Ipv6FlowClassifier> classifier = DynamicCast<Ipv6FlowClassifier>(m_helper.GetClassifier6());
+
+    os << "flow_id,src_node,dst_node,protocol,src_port,dst_port,traffic_type,tx_packets,"
+          "rx_packets,loss_rate,mean_delay_ms,mean_jitter_ms,throughput_mbps\n";
+    os << std::fixed << std::setprecision(6);
+
+    for (const auto& [id, f] : m_monitor->GetFlowStats())
+    {
+        Ipv6FlowClassifier::FiveTuple t = classifier->FindFlow(id);
+        double duration = (f.timeLastRxPacket - f.timeFirstTxPacket).GetSeconds();
+        os << id << "," << m_hosts->GetName(m_hosts->Find(t.sourceAddress)) << ","
+           << m_hosts->GetName(m_hosts->Find(t.destinationAddress)) << ","
+           << static_cast<int>(t.protocol) << "," << t.sourcePort << "," << t.destinationPort
+           << "," << static_cast<int>(Classify(t)) << "," << f.txPackets << "," << f.rxPackets
+           << "," << (f.txPackets ? static_cast<double>(f.lostPackets) / f.txPackets : 0.0)
+           << "," << (f.rxPackets ? f.delaySum.GetSeconds() / f.rxPackets * 1e3 : 0.0) << ","
+           << (f.rxPackets > 1 ? f.jitterSum.GetSeconds() / (f.rxPackets - 1) * 1e3 : 0.0)
+           << "," << (duration > 0 ? f.rxBytes * 8.0 / duration / 1e6 : 0.0) << "\n";
+    }
+}
+
+void
+FlowClassMonitor::WriteClassSummary(std::ostream& os)
+{
+    Collect();
+    Ptr<Ipv6FlowClassifier> classifier = DynamicCast<Ipv6FlowClassifier>(m_helper.GetClassifier6());
+
+    struct ClassTotals
+    {
+        uint64_t flows{0};
+        uint64_t txPackets{0};
+        uint64_t rxPackets{0};
+        uint64_t lostPackets{0};
+        uint64_t rxBytes{0};
+        double delaySum{0.0};
+        double jitterSum{0.0};
+    };
+
+    std::map<uint8_t, ClassTotals> classes;
+    for (const auto& [id, f] : m_monitor->GetFlowStats())
+    {
+        ClassTotals& c = classes[Classify(classifier->FindFlow(id))];
+        c.flows++;
+        c.txPackets += f.txPackets;
+        c.rxPackets += f.rxPackets;
+        c.lostPackets += f.lostPackets;
+        c.rxBytes += f.rxBytes;
+        c.delaySum += f.delaySum.GetSeconds();
+        c.jitterSum += f.jitterSum.GetSeconds();
+    }
+
+    os << std::fixed << std::setprecision(6);
+    for (const auto& [type, c] : classes)
+    {
+        os << "[FLOWMON] traffic_type=" << static_cast<int>(type) << " flows=" << c.flows
+           << " tx=" << c.txPackets << " rx=" << c.rxPackets << " lost=" << c.lostPackets
+           << " loss_rate="
+           << (c.txPackets ? static_cast<double>(c.lostPackets) / c.txPackets : 0.0)
+           << " mean_delay_ms=" << (c.rxPackets ? c.delaySum / c.rxPackets * 1e3 : 0.0)
+           << " mean_jitter_ms="
+           << (c.rxPackets > c.flows ? c.jitterSum / (c.rxPackets - c.flows) * 1e3 : 0.0)
+           << " rx_mbytes=" << c.rxBytes / 1e6 << "\n";
+    }
+}
@@ -0,0 +1,67 @@
+#ifndef FLOW_CLASS_MONITOR_H
+#define FLOW_CLASS_MONITOR_H
+
+#include "latency_metrics.h"
+#include "timestamped-onoff-application.h"
+
+#include "ns3/flow-monitor-helper.h"
+#include "ns3/flow-monitor.h"
+#include "ns3/ipv6-address.h"
+#include "ns3/node-container.h"
+
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <ostream>
+#include <utility>
+#include <vector>
+
+// Statistiche per flusso di FlowMonitor separate per classe di traffico.
+//
+// L'Ipv6FlowClassifier distingue i flussi per 5-tupla; la classe di ogni
+// flusso si ricava senza guardare i pacchetti:
+//  - UDP: dalla porta sorgente di ogni TimeStampedOnOffApplication, registrata
+//    dall'applicazione all'avvio (i generatori normali e delay-sensitive tra
+//    gli stessi host usano porte sorgente diverse)
+//  - TCP: dalla porta del sink (in entrambe le direzioni)
+// I probe sono installati solo sugli host, dove i flussi nascono e terminano.
+class FlowClassMonitor
+{
+  public:
+    static constexpr uint8_t kUnclassified = 0xff;
+
+    FlowClassMonitor(std::shared_ptr<const HostDirectory> hosts);
+
+    void Install(ns3::NodeContainer hosts);
+    void TrackUdpApplication(const ns3::Ipv6Address& source,
+                             ns3::Ptr<ns3::TimeStampedOnOffApplication> app,
+                             uint8_t trafficType);
+    void SetTcpPort(uint16_t port, uint8_t trafficType);
+
+    // una riga per flusso: ritardo e jitter medi, perdita e throughput
+    void WriteFlowCsv(std::ostream& os);
+    // aggregato per classe ([FLOWMON])
+    void WriteClassSummary(std::ostream& os);
+
+  private:
+    struct TrackedApp
+    {
+        ns3::Ipv6Address source;
+        ns3::Ptr<ns3::TimeStampedOnOffApplication> app;
+        uint8_t trafficType;
+    };
+
+    // risolve le porte delle applicazioni e aggiorna le statistiche di FlowMonitor
+    void Collect();
+    uint8_t Classify(const ns3::Ipv6FlowClassifier::FiveTuple& t) const;
+
+    std::shared_ptr<const HostDirectory> m_hosts;
+    ns3::FlowMonitorHelper m_helper;
+    ns3::Ptr<ns3::FlowMonitor> m_monitor;
+    std::vector<TrackedApp> m_apps;
+    std::map<std::pair<ns3::Ipv6Address, uint16_t>, uint8_t> m_udpSources;
+    std::map<uint16_t, uint8_t> m_tcpPorts;
+    bool m_collected{false};
+};
+
+#endif // FLOW_CLASS_MONITOR_H
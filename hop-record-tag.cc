@@ -0,0 +1,93 @@
+#include "hop-record-tag.h"
+
+namespace ns3
+{
+
+NS_OBJECT_ENSURE_REGISTERED(HopRecordTag);
+
+TypeId
+HopRecordTag::GetTypeId()
+{
+    static TypeId tid =
+        TypeId("ns3::HopRecordTag").SetParent<Tag>().AddConstructor<HopRecordTag>();
+    return tid;
+}
+
+TypeId
+HopRecordTag::GetInstanceTypeId() const
+{
+    return GetTypeId();
+}
+
+uint32_t
+HopRecordTag::GetSerializedSize() const
+{
+    return 1 + m_hops.size() * (2 + 2 + 8 + 8);
+}
+
+void
+HopRecordTag::Serialize(TagBuffer i) const
+{
+    i.WriteU8(static_cast<uint8_t>(m_hops.size()));
+    for (const auto& hop : m_hops)
+    {
+        i.WriteU16(hop.node);
+        i.WriteU16(hop.nextHop);
+        i.WriteU64(static_cast<uint64_t>(hop.arrivalNs));
+        i.WriteU64(static_cast<uint64_t>(hop.dequeueNs));
+    }
+}
+
+void
+HopRecordTag::Deserialize(TagBuffer i)
+{
+    m_hops.resize(i.ReadU8());
+    for (auto& hop : m_hops)
+    {
+        hop.node = i.ReadU16();
+        hop.nextHop = i.ReadU16();
+        hop.arrivalNs = static_cast<int64_t>(i.ReadU64());
+        hop.dequeueNs = static_cast<int64_t>(i.ReadU64());
+    }
+}
+
+void
+HopRecordTag::Print(std::ostream& os) const
+{
+    os << "hops=" << m_hops.size();
+    for (const auto& hop : m_hops)
+    {
+        os << " [" << hop.node << "->" << hop.nextHop << " arr=" << hop.arrivalNs
+           << " deq=" << hop.dequeueNs << "]";
+    }
+}
+
+bool
+HopRecordTag::AddHop(uint16_t node, uint16_t nextHop, Time arrival)
+{
+    if (m_hops.size() >= kMaxHops)
+    {
+        return false;
+    }
+    m_hops.push_back({node, nextHop, arrival.GetNanoSeconds(), -1});
+    return true;
+}
+
+bool
+HopRecordTag::SetDequeue(Time dequeue)
+{
+    if (m_hops.empty() || m_hops.back().dequeueNs >= 0)
+    {
+        return false;
+    }
+    m_hops.back().dequeueNs = dequeue.GetNanoSeconds();
+    return true;
+}
+
+const std::vector<HopRecordTag::Hop>&
+HopRecordTag::GetHops() const
+{
+    return m_hops;
+}
+
+} // namespace ns3
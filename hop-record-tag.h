@@ -0,0 +1,52 @@
+#ifndef HOP_RECORD_TAG_H
+#define HOP_RECORD_TAG_H
+
+#include "ns3/nstime.h"
+#include "ns3/tag.h"
+
+#include <cstdint>
+#include <vector>
+
+namespace ns3
+{
+
+// Registro dei salti di un pacchetto instradato da QRoutingProtocol.
+// RouteInput aggiunge un salto con l'istante di arrivo e il next hop scelto;
+// la trace Dequeue della QueueDisc di uscita completa il salto con l'istante
+// in cui il pacchetto lascia la coda. Al sink si ricavano, per ogni salto,
+// il ritardo in coda (uscita - arrivo) e il tempo sul collegamento
+// (arrivo al salto successivo - uscita).
+class HopRecordTag : public Tag
+{
+  public:
+    static constexpr uint16_t kNoNode = 0xffff; // next hop verso l'host di destinazione
+    static constexpr uint32_t kMaxHops = 32;
+
+    struct Hop
+    {
+        uint16_t node;       // indice del router nella lista dei nodi
+        uint16_t nextHop;    // indice del next hop scelto, kNoNode se è l'host
+        int64_t arrivalNs;   // arrivo al router
+        int64_t dequeueNs;   // uscita dalla TxQueue, -1 se non ancora uscito
+    };
+
+    static TypeId GetTypeId();
+    TypeId GetInstanceTypeId() const override;
+    uint32_t GetSerializedSize() const override;
+    void Serialize(TagBuffer i) const override;
+    void Deserialize(TagBuffer i) override;
+    void Print(std::ostream& os) const override;
+
+    // false se il registro è pieno (il salto non viene aggiunto)
+    bool AddHop(uint16_t node, uint16_t nextHop, Time arrival);
+    // completa l'ultimo salto ancora in coda
+    bool SetDequeue(Time dequeue);
+    const std::vector<Hop>& GetHops() const;
+
+  private:
+    std::vector<Hop> m_hops;
+};
+
+} // namespace ns3
+
+#endif // HOP_RECORD_TAG_H
@@ -0,0 +1,159 @@
+#include "hop_delay_stats.h"
+
+#include "hop-record-tag.h"
+
+#include "ns3/callback.h"
+#include "ns3/packet.h"
+#include "ns3/pointer.h"
+#include "ns3/queue.h"
+#include "ns3/simulator.h"
+
+#include <algorithm>
+#include <iomanip>
+
+using namespace ns3;
+
+namespace
+{
+
+// il pacchetto nella coda del dispositivo è lo stesso che verrà trasmesso:
+// il tag si aggiorna sul posto
+void
+HopDequeue(Ptr<const Packet> txPacket)
+{
+    Ptr<Packet> packet = ConstCast<Packet>(txPacket);
+    HopRecordTag hops;
+    if (packet->RemovePacketTag(hops))
+    {
+        hops.SetDequeue(Simulator::Now());
+        packet->AddPacketTag(hops);
+    }
+}
+
+} // namespace
+
+void
+TraceHopDequeue(Ptr<Node> node)
+{
+    for (uint32_t i = 0; i < node->GetNDevices(); ++i)
+    {
+        // solo i dispositivi con TxQueue (point-to-point), non il loopback
+        PointerValue txQueue;
+        if (!node->GetDevice(i)->GetAttributeFailSafe("TxQueue", txQueue))
+        {
+            continue;
+        }
+        Ptr<Queue<Packet>> queue = txQueue.Get<Queue<Packet>>();
+        if (queue)
+        {
+            queue->TraceConnectWithoutContext("Dequeue", MakeCallback(&HopDequeue));
+        }
+    }
+}
+
+HopDelayStats::HopDelayStats(const std::vector<std::string>& nodeNames, uint8_t trafficType)
+    : m_nodeNames(nodeNames),
+      m_trafficType(trafficType)
+{
+}
+
+void
+HopDelayStats::OnPacket(const LatencySample& sample)
+{
+    if (!sample.hops || sample.trafficType != m_trafficType)
+    {
+        return;
+    }
+    const auto& hops = sample.hops->GetHops();
+    if (hops.empty())
+    {
+        return;
+    }
+
+    int64_t sendNs = sample.sendTime.GetNanoSeconds();
+    int64_t receiveNs = sample.receiveTime.GetNanoSeconds();
+
+    int64_t access = hops.front().arrivalNs - sendNs;
+    m_access.Record(access);
+    m_accessTotalNs += access;
+
+    for (size_t i = 0; i < hops.size(); ++i)
+    {
+        const auto& hop = hops[i];
+        int64_t nextArrival = i + 1 < hops.size() ? hops[i + 1].arrivalNs : receiveNs;
+        // senza la trace sulla coda di uscita il salto conta tutto come collegamento
+        int64_t left = hop.dequeueNs >= 0 ? hop.dequeueNs : hop.arrivalNs;
+
+        LinkStats& link = m_links[{hop.node, hop.nextHop}];
+        if (hop.dequeueNs >= 0)
+        {
+            link.queue.Record(left - hop.arrivalNs);
+        }
+        link.link.Record(nextArrival - left);
+        link.totalNs += nextArrival - hop.arrivalNs;
+    }
+
+    m_endToEndTotalNs += receiveNs - sendNs;
+    m_packets++;
+}
+
+std::string
+HopDelayStats::LinkName(const std::pair<uint16_t, uint16_t>& key) const
+{
+    auto name = [this](uint16_t index) {
+        if (index == HopRecordTag::kNoNode)
+        {
+            return std::string("host");
+        }
+        return index < m_nodeNames.size() ? m_nodeNames[index] : std::to_string(index);
+    };
+    return name(key.first) + "->" + name(key.second);
+}
+
+void
+HopDelayStats::WriteCsv(std::ostream& os) const
+{
+    os << "link,packets,mean_queue_ms,p99_queue_ms,max_queue_ms,mean_link_ms,p99_link_ms,"
+          "max_link_ms,share_of_e2e\n";
+    os << std::fixed << std::setprecision(6);
+
+    auto row = [&os, this](const std::string& name,
+                           const LatencyHistogram* queue,
+                           const LatencyHistogram& link,
+                           double totalNs) {
+        os << name << "," << link.GetCount() << ","
+           << (queue ? queue->GetMean() * 1e-6 : 0.0) << ","
+           << (queue ? queue->GetValueAtPercentile(99) * 1e-6 : 0.0) << ","
+           << (queue ? queue->GetMax() * 1e-6 : 0.0) << "," << link.GetMean() * 1e-6 << ","
+           << link.GetValueAtPercentile(99) * 1e-6 << "," << link.GetMax() * 1e-6 << ","
+           << (m_endToEndTotalNs > 0 ? totalNs / m_endToEndTotalNs : 0.0) << "\n";
+    };
+
+    row("access", nullptr, m_access, m_accessTotalNs);
+    for (const auto& [key, stats] : m_links)
+    {
+        row(LinkName(key), &stats.queue, stats.link, stats.totalNs);
+    }
+}
+
+void
+HopDelayStats::WriteSummary(std::ostream& os, size_t topLinks) const
+{
+    std::vector<std::pair<double, std::pair<uint16_t, uint16_t>>> ranked;
+    for (const auto& [key, stats] : m_links)
+    {
+        ranked.emplace_back(stats.totalNs, key);
+    }
+    std::sort(ranked.rbegin(), ranked.rend());
+
+    os << std::fixed << std::setprecision(4);
+    os << "[HOPSTATS] pacchetti=" << m_packets << " collegamenti=" << m_links.size() << "\n";
+    for (size_t i = 0; i < ranked.size() && i < topLinks; ++i)
+    {
+        const LinkStats& stats = m_links.at(ranked[i].second);
+        os << "[HOPSTATS] " << LinkName(ranked[i].second)
+           << " quota=" << (m_endToEndTotalNs > 0 ? ranked[i].first / m_endToEndTotalNs : 0.0)
+           << " coda_p99_ms=" << stats.queue.GetValueAtPercentile(99) * 1e-6
+           << " coda_max_ms=" << stats.queue.GetMax() * 1e-6 << "\n";
+    }
+}
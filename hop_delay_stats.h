@@ -0,0 +1,58 @@
+#ifndef HOP_DELAY_STATS_H
+#define HOP_DELAY_STATS_H
+
+#include "latency_histogram.h"
+#include "latency_metrics.h"
+
+#include "ns3/node.h"
+#include "ns3/ptr.h"
+
+#include <cstdint>
+#include <map>
+#include <ostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+// collega la trace Dequeue della TxQueue dei dispositivi del nodo, che completa
+// l'ultimo salto dell'HopRecordTag con l'inizio della trasmissione
+void TraceHopDequeue(ns3::Ptr<ns3::Node> node);
+
+// Scomposizione per collegamento della latenza dei pacchetti con HopRecordTag:
+// per ogni collegamento (router, next hop) l'attesa in coda (QueueDisc e coda
+// del dispositivo) e il tempo dall'inizio della trasmissione all'arrivo al nodo
+// successivo (serializzazione e propagazione), più il tratto di accesso
+// host -> primo router.
+class HopDelayStats : public LatencyMetricsBackend
+{
+  public:
+    // nodeNames: nomi dei router nell'ordine degli indici usati nel tag
+    HopDelayStats(const std::vector<std::string>& nodeNames, uint8_t trafficType);
+
+    void OnPacket(const LatencySample& sample) override;
+
+    // una riga per collegamento con percentili e quota della latenza end-to-end
+    void WriteCsv(std::ostream& os) const;
+    // i collegamenti che contribuiscono di più alla latenza ([HOPSTATS])
+    void WriteSummary(std::ostream& os, size_t topLinks = 5) const;
+
+  private:
+    struct LinkStats
+    {
+        LatencyHistogram queue;
+        LatencyHistogram link;
+        double totalNs{0.0}; // somma di coda e collegamento
+    };
+
+    std::string LinkName(const std::pair<uint16_t, uint16_t>& key) const;
+
+    std::vector<std::string> m_nodeNames;
+    uint8_t m_trafficType;
+    std::map<std::pair<uint16_t, uint16_t>, LinkStats> m_links;
+    LatencyHistogram m_access;
+    double m_accessTotalNs{0.0};
+    double m_endToEndTotalNs{0.0};
+    uint64_t m_packets{0};
+};
+
+#endif // HOP_DELAY_STATS_H
@@ -0,0 +1,57 @@
+#include "hot_path_profiler.h"
+
+#ifdef QSE_ENABLE_PROFILING
+
+#include <iomanip>
+
+namespace
+{
+
+const char* const kPointNames[] = {"QRoutingProtocol::RouteInput",
+                                   "QueueStatusReceiver::HandleRead",
+                                   "QueueStatusApp::SendQueueStatus",
+                                   "TimeStampedOnOffApplication::SendPacket",
+                                   "LatencySinkApplication::HandleRead",
+                                   "TcpFlowSink::HandleRead"};
+
+static_assert(sizeof(kPointNames) / sizeof(kPointNames[0]) ==
+                  static_cast<size_t>(ProfilePoint::COUNT),
+              "un nome per ogni ProfilePoint");
+
+// riferimento per la conversione tick -> ns, preso all'avvio del programma
+const uint64_t g_startTicks = HotPathProfiler::Now();
+const std::chrono::steady_clock::time_point g_startClock = std::chrono::steady_clock::now();
+
+} // namespace
+
+HotPathProfiler::Counter HotPathProfiler::s_counters[static_cast<size_t>(ProfilePoint::COUNT)];
+
+void
+HotPathProfiler::WriteSummary(std::ostream& os)
+{
+    double wallNs = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() -
+                                                             g_startClock)
+                        .count();
+    uint64_t elapsedTicks = Now() - g_startTicks;
+    double nsPerTick = elapsedTicks > 0 ? wallNs / elapsedTicks : 1.0;
+
+    os << "[PROFILE] " << std::left << std::setw(42) << "punto" << std::right << std::setw(12)
+       << "chiamate" << std::setw(12) << "totale_ms" << std::setw(10) << "medio_ns"
+       << std::setw(12) << "max_ns" << std::setw(8) << "quota" << "\n";
+    os << std::fixed;
+    for (size_t i = 0; i < static_cast<size_t>(ProfilePoint::COUNT); ++i)
+    {
+        const Counter& c = s_counters[i];
+        double meanNs = c.sampled ? c.ticks * nsPerTick / c.sampled : 0.0;
+        double totalNs = meanNs * c.calls; // stimato se si misura un campione
+        os << "[PROFILE] " << std::left << std::setw(42) << kPointNames[i] << std::right
+           << std::setw(12) << c.calls << std::setw(12) << std::setprecision(1) << totalNs * 1e-6
+           << std::setw(10) << std::setprecision(0) << meanNs << std::setw(12)
+           << c.maxTicks * nsPerTick << std::setw(8) << std::setprecision(3)
+           << (wallNs > 0 ? totalNs / wallNs : 0.0) << "\n";
+    }
+    os << "[PROFILE] tempo reale=" << std::setprecision(3) << wallNs * 1e-9
+       << " s, campionamento 1/" << QSE_PROFILING_SAMPLE << std::endl;
+}
+
+#endif // QSE_ENABLE_PROFILING
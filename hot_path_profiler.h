@@ -0,0 +1,114 @@
+#ifndef HOT_PATH_PROFILER_H
+#define HOT_PATH_PROFILER_H
+
+// Contatori di profilazione per le callback più frequenti del simulatore:
+// numero di chiamate e tempo reale speso in ciascuna, con una tabella
+// riassuntiva a fine esecuzione (QSE_PROFILE_REPORT).
+//
+// Si attiva solo a compilazione con -DQSE_ENABLE_PROFILING, ad esempio
+//   ./ns3 configure --cxx-flags="-DQSE_ENABLE_PROFILING"
+// altrimenti le macro si espandono a nulla e non hanno alcun costo.
+// Su x86 il tempo si misura con il TSC, convertito in ns confrontandolo con
+// steady_clock su tutta l'esecuzione; altrove si usa steady_clock. Con
+// -DQSE_PROFILING_SAMPLE=N si misura una chiamata ogni N (le chiamate sono
+// contate tutte) e il tempo totale è stimato dalla media dei campioni.
+
+#ifdef QSE_ENABLE_PROFILING
+
+#include <chrono>
+#include <cstdint>
+#include <ostream>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+#ifndef QSE_PROFILING_SAMPLE
+#define QSE_PROFILING_SAMPLE 1
+#endif
+
+enum class ProfilePoint : uint8_t
+{
+    ROUTE_INPUT,
+    QUEUE_STATUS_RECEIVE,
+    QUEUE_STATUS_SEND,
+    ONOFF_SEND,
+    LATENCY_SINK_READ,
+    TCP_SINK_READ,
+    COUNT
+};
+
+class HotPathProfiler
+{
+  public:
+    struct Counter
+    {
+        uint64_t calls{0};
+        uint64_t sampled{0};
+        uint64_t ticks{0};
+        uint64_t maxTicks{0};
+    };
+
+    static uint64_t Now()
+    {
+#if defined(__x86_64__) || defined(__i386__)
+        return __rdtsc();
+#else
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+                   std::chrono::steady_clock::now().time_since_epoch())
+            .count();
+#endif
+    }
+
+    static Counter& Get(ProfilePoint point)
+    {
+        return s_counters[static_cast<size_t>(point)];
+    }
+
+    // una riga per punto con chiamate, tempo stimato, media, massimo e quota
+    // del tempo reale dall'avvio
+    static void WriteSummary(std::ostream& os);
+
+  private:
+    static Counter s_counters[static_cast<size_t>(ProfilePoint::COUNT)];
+};
+
+class ProfileScope
+{
+  public:
+    explicit ProfileScope(ProfilePoint point)
+        : m_counter(HotPathProfiler::Get(point)),
+          m_start(++m_counter.calls % QSE_PROFILING_SAMPLE == 0 ? HotPathProfiler::Now() : 0)
+    {
+    }
+
+    ~ProfileScope()
+    {
+        if (m_start != 0)
+        {
+            uint64_t elapsed = HotPathProfiler::Now() - m_start;
+            m_counter.sampled++;
+            m_counter.ticks += elapsed;
+            m_counter.maxTicks = elapsed > m_counter.maxTicks ? elapsed : m_counter.maxTicks;
+        }
+    }
+
+    ProfileScope(const ProfileScope&) = delete;
+    ProfileScope& operator=(const ProfileScope&) = delete;
+
+  private:
+    HotPathProfiler::Counter& m_counter;
+    uint64_t m_start;
+};
+
+#define QSE_PROFILE_SCOPE(point) ProfileScope qseProfileScope(ProfilePoint::point)
+#define QSE_PROFILE_REPORT(os) HotPathProfiler::WriteSummary(os)
+
+#else
+
+#define QSE_PROFILE_SCOPE(point) ((void)0)
+#define QSE_PROFILE_REPORT(os) ((void)0)
+
+#endif // QSE_ENABLE_PROFILING
+
+#endif // HOT_PATH_PROFILER_H
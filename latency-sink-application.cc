@@ -0,0 +1,174 @@
+#include "latency-sink-application.h"
+
+#include "hot_path_profiler.h"
+#include "traffic-type-header.h"
+
+#include "ns3/boolean.h"
+#include "ns3/inet6-socket-address.h"
+#include "ns3/ipv6.h"
+#include "ns3/log.h"
+#include "ns3/node.h"
+#include "ns3/packet.h"
+#include "ns3/seq-ts-size-header.h"
+#include "ns3/simulator.h"
+#include "ns3/socket.h"
+#include "ns3/timestamp-tag.h"
+#include "ns3/udp-socket-factory.h"
+#include "ns3/uinteger.h"
+
+namespace ns3
+{
+
+NS_LOG_COMPONENT_DEFINE("LatencySinkApplication");
+
+NS_OBJECT_ENSURE_REGISTERED(LatencySinkApplication);
+
+TypeId
+LatencySinkApplication::GetTypeId()
+{
+    static TypeId tid =
+        TypeId("ns3::LatencySinkApplication")
+            .SetParent<Application>()
+            .SetGroupName("Applications")
+            .AddConstructor<LatencySinkApplication>()
+            .AddAttribute("Port",
+                          "Port on which the sink listens",
+                          UintegerValue(9999),
+                          MakeUintegerAccessor(&LatencySinkApplication::m_port),
+                          MakeUintegerChecker<uint16_t>())
+            .AddAttribute("ReadHopRecords",
+                          "Pass the HopRecordTag of each packet to the backends",
+                          BooleanValue(false),
+                          MakeBooleanAccessor(&LatencySinkApplication::m_readHopRecords),
+                          MakeBooleanChecker())
+            .AddAttribute("ReadPathIds",
+                          "Pass the PathIdTag of each packet to the backends",
+                          BooleanValue(false),
+                          MakeBooleanAccessor(&LatencySinkApplication::m_readPathIds),
+                          MakeBooleanChecker());
+    return tid;
+}
+
+LatencySinkApplication::LatencySinkApplication()
+    : m_socket(nullptr)
+{
+}
+
+LatencySinkApplication::~LatencySinkApplication()
+{
+}
+
+void
+LatencySinkApplication::SetHostDirectory(std::shared_ptr<const HostDirectory> hosts)
+{
+    m_hosts = hosts;
+}
+
+void
+LatencySinkApplication::AddBackend(std::shared_ptr<LatencyMetricsBackend> backend)
+{
+    m_backends.push_back(backend);
+}
+
+void
+LatencySinkApplication::DoDispose()
+{
+    m_socket = nullptr;
+    m_backends.clear();
+    Application::DoDispose();
+}
+
+void
+LatencySinkApplication::StartApplication()
+{
+    NS_ABORT_MSG_IF(!m_hosts, "LatencySinkApplication senza HostDirectory");
+
+    // identità dell'host: il primo indirizzo dell'host presente nella directory
+    Ptr<Ipv6> ipv6 = GetNode()->GetObject<Ipv6>();
+    for (uint32_t i = 0; i < ipv6->GetNInterfaces() && m_ownId == HostDirectory::kUnknown; ++i)
+    {
+        for (uint32_t j = 0; j < ipv6->GetNAddresses(i); ++j)
+        {
+            m_ownId = m_hosts->Find(ipv6->GetAddress(i, j).GetAddress());
+            if (m_ownId != HostDirectory::kUnknown)
+            {
+                break;
+            }
+        }
+    }
+    if (m_ownId == HostDirectory::kUnknown)
+    {
+        std::cout << "[SINK] attenzione: nodo " << GetNode()->GetId()
+                  << " non presente nella HostDirectory" << std::endl;
+    }
+
+    if (!m_socket)
+    {
+        m_socket = Socket::CreateSocket(GetNode(), UdpSocketFactory::GetTypeId());
+        m_socket->Bind(Inet6SocketAddress(Ipv6Address::GetAny(), m_port));
+    }
+    m_socket->SetRecvCallback(MakeCallback(&LatencySinkApplication::HandleRead, this));
+}
+
+void
+LatencySinkApplication::StopApplication()
+{
+    if (m_socket)
+    {
+        m_socket->Close();
+        m_socket->SetRecvCallback(MakeNullCallback<void, Ptr<Socket>>());
+    }
+}
+
+void
+LatencySinkApplication::HandleRead(Ptr<Socket> socket)
+{
+    QSE_PROFILE_SCOPE(LATENCY_SINK_READ);
+    Time receiveTime = Simulator::Now();
+    Address from;
+    Ptr<Packet> packet;
+    while ((packet = socket->RecvFrom(from)))
+    {
+        TimestampTag tag;
+        if (!packet->PeekPacketTag(tag))
+        {
+            continue;
+        }
+
+        LatencySample sample;
+        sample.srcHost = m_hosts->Find(Inet6SocketAddress::ConvertFrom(from).GetIpv6());
+        sample.dstHost = m_ownId;
+        sample.sendTime = tag.GetTimestamp();
+        sample.receiveTime = receiveTime;
+        sample.hasSeq = false;
+        sample.seq = 0;
+
+        HopRecordTag hops;
+        sample.hops = m_readHopRecords && packet->PeekPacketTag(hops) ? &hops : nullptr;
+        PathIdTag path;
+        sample.path = m_readPathIds && packet->PeekPacketTag(path) ? &path : nullptr;
+
+        // il pacchetto ricevuto appartiene al sink: gli header si rimuovono senza copie
+        TrafficTypeHeader tHeader;
+        packet->RemoveHeader(tHeader);
+        sample.trafficType = static_cast<uint8_t>(tHeader.GetType());
+
+        SeqTsSizeHeader seqHeader;
+        if (packet->GetSize() >= seqHeader.GetSerializedSize())
+        {
+            packet->PeekHeader(seqHeader);
+            if (seqHeader.GetSize() == packet->GetSize())
+            {
+                sample.hasSeq = true;
+                sample.seq = seqHeader.GetSeq();
+            }
+        }
+
+        for (const auto& backend : m_backends)
+        {
+            backend->OnPacket(sample);
+        }
+    }
+}
+
+} // namespace ns3
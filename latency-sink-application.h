@@ -0,0 +1,54 @@
+#ifndef LATENCY_SINK_APPLICATION_H
+#define LATENCY_SINK_APPLICATION_H
+
+#include "latency_metrics.h"
+
+#include "ns3/application.h"
+#include "ns3/ptr.h"
+
+#include <memory>
+#include <vector>
+
+namespace ns3
+{
+
+class Socket;
+
+// Sink UDP degli host per il traffico generato da TimeStampedOnOffApplication.
+// L'identità dell'host (id nella HostDirectory) è risolta una volta all'avvio;
+// per ogni pacchetto si legge il TimestampTag, il TrafficTypeHeader e, se
+// presente, il SeqTsSizeHeader (e, con ReadHopRecords e ReadPathIds,
+// l'HopRecordTag e il PathIdTag), e il campione passa a tutti i backend.
+// Ad ogni callback il socket viene svuotato completamente.
+class LatencySinkApplication : public Application
+{
+  public:
+    static TypeId GetTypeId();
+
+    LatencySinkApplication();
+    ~LatencySinkApplication() override;
+
+    void SetHostDirectory(std::shared_ptr<const HostDirectory> hosts);
+    void AddBackend(std::shared_ptr<LatencyMetricsBackend> backend);
+
+  protected:
+    void DoDispose() override;
+
+  private:
+    void StartApplication() override;
+    void StopApplication() override;
+
+    void HandleRead(Ptr<Socket> socket);
+
+    Ptr<Socket> m_socket;
+    uint16_t m_port{9999};
+    bool m_readHopRecords{false};
+    bool m_readPathIds{false};
+    std::shared_ptr<const HostDirectory> m_hosts;
+    std::vector<std::shared_ptr<LatencyMetricsBackend>> m_backends;
+    uint16_t m_ownId{HostDirectory::kUnknown};
+};
+
+} // namespace ns3
+
+#endif // LATENCY_SINK_APPLICATION_H
@@ -0,0 +1,125 @@
+#include "latency_histogram.h"
+
+#include <algorithm>
+#include <cmath>
+
+size_t
+LatencyHistogram::BucketIndex(uint64_t value)
+{
+    if (value < kSubBuckets)
+    {
+        return static_cast<size_t>(value);
+    }
+    // ottava del valore: posizione del bit più significativo oltre i bit del sub-bucket
+    uint32_t msb = 63 - __builtin_clzll(value);
+    uint32_t octave = msb - kSubBucketBits;
+    uint64_t sub = (value >> octave) - kSubBuckets;
+    return static_cast<size_t>(kSubBuckets + octave * kSubBuckets + sub);
+}
+
+uint64_t
+LatencyHistogram::BucketUpperBound(size_t index)
+{
+    if (index < kSubBuckets)
+    {
+        return index;
+    }
+    uint64_t octave = (index - kSubBuckets) / kSubBuckets;
+    uint64_t sub = (index - kSubBuckets) % kSubBuckets + kSubBuckets;
+    return ((sub + 1) << octave) - 1;
+}
+
+void
+LatencyHistogram::Record(int64_t valueNs)
+{
+    valueNs = std::max<int64_t>(valueNs, 0);
+    size_t index = BucketIndex(static_cast<uint64_t>(valueNs));
+    if (index >= m_counts.size())
+    {
+        m_counts.resize(index + 1, 0);
+    }
+    m_counts[index]++;
+
+    m_min = m_count == 0 ? valueNs : std::min(m_min, valueNs);
+    m_max = m_count == 0 ? valueNs : std::max(m_max, valueNs);
+    m_sum += static_cast<double>(valueNs);
+    m_count++;
+}
+
+void
+LatencyHistogram::Add(const LatencyHistogram& other)
+{
+    if (other.m_count == 0)
+    {
+        return;
+    }
+    if (other.m_counts.size() > m_counts.size())
+    {
+        m_counts.resize(other.m_counts.size(), 0);
+    }
+    for (size_t i = 0; i < other.m_counts.size(); ++i)
+    {
+        m_counts[i] += other.m_counts[i];
+    }
+    m_min = m_count == 0 ? other.m_min : std::min(m_min, other.m_min);
+    m_max = m_count == 0 ? other.m_max : std::max(m_max, other.m_max);
+    m_sum += other.m_sum;
+    m_count += other.m_count;
+}
+
+void
+LatencyHistogram::Reset()
+{
+    // i contatori restano allocati: l'intervallo successivo userà bucket simili
+    std::fill(m_counts.begin(), m_counts.end(), 0);
+    m_count = 0;
+    m_min = 0;
+    m_max = 0;
+    m_sum = 0.0;
+}
+
+uint64_t
+LatencyHistogram::GetCount() const
+{
+    return m_count;
+}
+
+int64_t
+LatencyHistogram::GetMin() const
+{
+    return m_min;
+}
+
+int64_t
+LatencyHistogram::GetMax() const
+{
+    return m_max;
+}
+
+double
+LatencyHistogram::GetMean() const
+{
+    return m_count ? m_sum / m_count : 0.0;
+}
+
+int64_t
+LatencyHistogram::GetValueAtPercentile(double percentile) const
+{
+    if (m_count == 0)
+    {
+        return 0;
+    }
+    double fraction = std::clamp(percentile, 0.0, 100.0) / 100.0;
+    uint64_t rank = std::max<uint64_t>(1, static_cast<uint64_t>(std::ceil(fraction * m_count)));
+
+    uint64_t cumulative = 0;
+    for (size_t i = 0; i < m_counts.size(); ++i)
+    {
+        cumulative += m_counts[i];
+        if (cumulative >= rank)
+        {
+            return std::min(static_cast<int64_t>(BucketUpperBound(i)), m_max);
+        }
+    }
+    return m_max;
+}
@@ -0,0 +1,43 @@
+#ifndef LATENCY_HISTOGRAM_H
+#define LATENCY_HISTOGRAM_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Istogramma di latenze a bucket logaritmici (stile HDR), in nanosecondi.
+//
+// I valori sotto 128 ns hanno un bucket ciascuno; sopra, ogni potenza di due
+// è divisa in 128 bucket lineari, quindi l'errore relativo dei percentili è
+// al più 1/128 (< 0.8%) su tutto l'intervallo. Il vettore dei contatori cresce
+// solo fino al bucket più alto usato: per latenze di qualche secondo sono
+// circa 3000 contatori, indipendentemente dal numero di campioni.
+class LatencyHistogram
+{
+  public:
+    void Record(int64_t valueNs);
+    void Add(const LatencyHistogram& other);
+    void Reset();
+
+    uint64_t GetCount() const;
+    int64_t GetMin() const;
+    int64_t GetMax() const;
+    double GetMean() const;
+    // valore più alto equivalente al percentile (0-100), 0 se vuoto
+    int64_t GetValueAtPercentile(double percentile) const;
+
+  private:
+    static constexpr uint32_t kSubBucketBits = 7;
+    static constexpr uint64_t kSubBuckets = uint64_t(1) << kSubBucketBits;
+
+    static size_t BucketIndex(uint64_t value);
+    static uint64_t BucketUpperBound(size_t index);
+
+    std::vector<uint64_t> m_counts;
+    uint64_t m_count{0};
+    int64_t m_min{0};
+    int64_t m_max{0};
+    double m_sum{0.0};
+};
+
+#endif // LATENCY_HISTOGRAM_H
@@ -0,0 +1,359 @@
+#include "latency_log.h"
+
+#include <algorithm>
+#include <cinttypes>
+#include <cstring>
+#include <iostream>
+#include <limits>
+
+namespace
+{
+
+struct FileHeader
+{
+    char magic[8];
+    uint32_t version;
+    uint32_t recordSize;
+};
+
+struct FileTrailer
+{
+    uint64_t nodesOffset;
+    uint64_t recordCount;
+    char magic[8];
+};
+
+const char kHeaderMagic[8] = {'Q', 'L', 'A', 'T', 'L', 'O', 'G', '1'};
+const char kTrailerMagic[8] = {'Q', 'L', 'A', 'T', 'E', 'N', 'D', '1'};
+const uint32_t kVersion = 1;
+
+bool
+WriteString(std::FILE* file, const std::string& s)
+{
+    uint16_t length = static_cast<uint16_t>(s.size());
+    return std::fwrite(&length, sizeof(length), 1, file) == 1 &&
+           std::fwrite(s.data(), 1, length, file) == length;
+}
+
+bool
+ReadString(std::FILE* file, std::string& s)
+{
+    uint16_t length = 0;
+    if (std::fread(&length, sizeof(length), 1, file) != 1)
+    {
+        return false;
+    }
+    s.resize(length);
+    return std::fread(&s[0], 1, length, file) == length;
+}
+
+// secondi con 9 decimali a partire dai nanosecondi, senza passare dai double
+void
+PrintSeconds(std::FILE* out, int64_t ns)
+{
+    if (ns < 0)
+    {
+        std::fputc('-', out);
+        ns = -ns;
+    }
+    std::fprintf(out, "%" PRId64 ".%09" PRId64, ns / 1000000000, ns % 1000000000);
+}
+
+} // namespace
+
+LatencyLogWriter::LatencyLogWriter(size_t blockRecords, size_t maxPendingBlocks)
+    : m_blockRecords(blockRecords),
+      m_maxPendingBlocks(maxPendingBlocks)
+{
+}
+
+LatencyLogWriter::~LatencyLogWriter()
+{
+    Close();
+}
+
+bool
+LatencyLogWriter::Open(const std::string& path)
+{
+    Close();
+    m_file = std::fopen(path.c_str(), "wb");
+    if (!m_file)
+    {
+        return false;
+    }
+
+    FileHeader header{};
+    std::memcpy(header.magic, kHeaderMagic, sizeof(header.magic));
+    header.version = kVersion;
+    header.recordSize = sizeof(LatencyRecord);
+    std::fwrite(&header, sizeof(header), 1, m_file);
+
+    m_records = 0;
+    m_stopping = false;
+    m_writeFailed = false;
+    m_current.reserve(m_blockRecords);
+    m_writer = std::thread(&LatencyLogWriter::WriterLoop, this);
+    return true;
+}
+
+bool
+LatencyLogWriter::IsOpen() const
+{
+    return m_file != nullptr;
+}
+
+uint16_t
+LatencyLogWriter::RegisterNode(const std::string& name, const std::string& address)
+{
+    auto it = m_nodeIds.find(name);
+    if (it != m_nodeIds.end())
+    {
+        if (m_nodes[it->second].second.empty())
+        {
+            m_nodes[it->second].second = address;
+        }
+        return it->second;
+    }
+
+    uint16_t id = static_cast<uint16_t>(m_nodes.size());
+    if (m_nodes.size() > std::numeric_limits<uint16_t>::max())
+    {
+        std::cerr << "[LATLOG] troppi nodi, " << name << " non è registrato" << std::endl;
+        return std::numeric_limits<uint16_t>::max();
+    }
+    m_nodes.emplace_back(name, address);
+    m_nodeIds.emplace(name, id);
+    return id;
+}
+
+uint16_t
+LatencyLogWriter::NodeId(const std::string& name)
+{
+    auto it = m_nodeIds.find(name);
+    return it != m_nodeIds.end() ? it->second : RegisterNode(name, "");
+}
+
+void
+LatencyLogWriter::SubmitCurrent()
+{
+    std::vector<LatencyRecord> next;
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        // il disco è indietro: si aspetta che il thread liberi un blocco
+        m_cv.wait(lock, [this] { return m_pending.size() < m_maxPendingBlocks; });
+        m_records += m_current.size();
+        m_pending.push_back(std::move(m_current));
+        if (!m_free.empty())
+        {
+            next = std::move(m_free.back());
+            m_free.pop_back();
+        }
+    }
+    m_cv.notify_all();
+
+    m_current = std::move(next);
+    m_current.clear();
+    m_current.reserve(m_blockRecords);
+}
+
+void
+LatencyLogWriter::WriterLoop()
+{
+    while (true)
+    {
+        std::vector<LatencyRecord> block;
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_cv.wait(lock, [this] { return !m_pending.empty() || m_stopping; });
+            if (m_pending.empty())
+            {
+                return;
+            }
+            block = std::move(m_pending.front());
+            m_pending.pop_front();
+        }
+
+        if (std::fwrite(block.data(), sizeof(LatencyRecord), block.size(), m_file) !=
+            block.size())
+        {
+            m_writeFailed = true;
+        }
+        block.clear();
+
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_free.push_back(std::move(block));
+        }
+        m_cv.notify_all();
+    }
+}
+
+void
+LatencyLogWriter::Close()
+{
+    if (!m_file)
+    {
+        return;
+    }
+
+    if (!m_current.empty())
+    {
+        SubmitCurrent();
+    }
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stopping = true;
+    }
+    m_cv.notify_all();
+    m_writer.join();
+
+    FileTrailer trailer{};
+    trailer.nodesOffset = static_cast<uint64_t>(std::ftell(m_file));
+    trailer.recordCount = m_records;
+    std::memcpy(trailer.magic, kTrailerMagic, sizeof(trailer.magic));
+
+    uint32_t nodeCount = static_cast<uint32_t>(m_nodes.size());
+    bool ok = !m_writeFailed && std::fwrite(&nodeCount, sizeof(nodeCount), 1, m_file) == 1;
+    for (const auto& [name, address] : m_nodes)
+    {
+        ok = ok && WriteString(m_file, name) && WriteString(m_file, address);
+    }
+    ok = ok && std::fwrite(&trailer, sizeof(trailer), 1, m_file) == 1;
+    ok = (std::fclose(m_file) == 0) && ok;
+    m_file = nullptr;
+
+    if (!ok)
+    {
+        std::cerr << "[LATLOG] errore di scrittura: il log delle latenze è incompleto"
+                  << std::endl;
+    }
+
+    m_pending.clear();
+    m_free.clear();
+    m_current.clear();
+}
+
+uint64_t
+LatencyLogWriter::GetRecordCount() const
+{
+    return m_records + m_current.size();
+}
+
+bool
+ConvertLatencyLogToCsv(const std::string& logPath,
+                       const std::string& normalCsvPath,
+                       const std::string& sensitiveCsvPath,
+                       std::string& error)
+{
+    std::FILE* in = std::fopen(logPath.c_str(), "rb");
+    if (!in)
+    {
+        error = "impossibile aprire " + logPath;
+        return false;
+    }
+
+    FileHeader header{};
+    FileTrailer trailer{};
+    bool valid = std::fread(&header, sizeof(header), 1, in) == 1 &&
+                 std::memcmp(header.magic, kHeaderMagic, sizeof(header.magic)) == 0 &&
+                 header.version == kVersion && header.recordSize == sizeof(LatencyRecord) &&
+                 std::fseek(in, -static_cast<long>(sizeof(trailer)), SEEK_END) == 0 &&
+                 std::fread(&trailer, sizeof(trailer), 1, in) == 1 &&
+                 std::memcmp(trailer.magic, kTrailerMagic, sizeof(trailer.magic)) == 0;
+    if (!valid)
+    {
+        std::fclose(in);
+        error = logPath + " non è un log di latenze completo";
+        return false;
+    }
+
+    // tabella dei nodi
+    std::vector<std::pair<std::string, std::string>> nodes;
+    uint32_t nodeCount = 0;
+    valid = std::fseek(in, static_cast<long>(trailer.nodesOffset), SEEK_SET) == 0 &&
+            std::fread(&nodeCount, sizeof(nodeCount), 1, in) == 1;
+    for (uint32_t i = 0; valid && i < nodeCount; ++i)
+    {
+        std::string name;
+        std::string address;
+        valid = ReadString(in, name) && ReadString(in, address);
+        nodes.emplace_back(name, address);
+    }
+    if (!valid)
+    {
+        std::fclose(in);
+        error = "tabella dei nodi non valida in " + logPath;
+        return false;
+    }
+
+    std::FILE* out[2] = {std::fopen(normalCsvPath.c_str(), "w"),
+                         std::fopen(sensitiveCsvPath.c_str(), "w")};
+    if (!out[0] || !out[1])
+    {
+        for (std::FILE* f : out)
+        {
+            if (f)
+            {
+                std::fclose(f);
+            }
+        }
+        std::fclose(in);
+        error = "impossibile creare i file CSV";
+        return false;
+    }
+    for (std::FILE* f : out)
+    {
+        std::fputs("src_node,src_ip,dst_node,dst_ip,send_time,receive_time,latency\n", f);
+    }
+
+    static const std::pair<std::string, std::string> unknown{"Unknown", ""};
+    auto node = [&nodes](uint16_t id) -> const std::pair<std::string, std::string>& {
+        return id < nodes.size() ? nodes[id] : unknown;
+    };
+
+    std::fseek(in, sizeof(FileHeader), SEEK_SET);
+    std::vector<LatencyRecord> block(1 << 16);
+    uint64_t remaining = trailer.recordCount;
+    while (remaining > 0)
+    {
+        size_t n = static_cast<size_t>(std::min<uint64_t>(remaining, block.size()));
+        if (std::fread(block.data(), sizeof(LatencyRecord), n, in) != n)
+        {
+            error = "record troncati in " + logPath;
+            valid = false;
+            break;
+        }
+        remaining -= n;
+
+        for (size_t i = 0; i < n; ++i)
+        {
+            const LatencyRecord& r = block[i];
+            std::FILE* f = out[r.trafficType == 0 ? 0 : 1];
+            const auto& src = node(r.srcNode);
+            const auto& dst = node(r.dstNode);
+            std::fprintf(f,
+                         "%s,%s,%s,%s,",
+                         src.first.c_str(),
+                         src.second.c_str(),
+                         dst.first.c_str(),
+                         dst.second.c_str());
+            PrintSeconds(f, r.sendTimeNs);
+            std::fputc(',', f);
+            PrintSeconds(f, r.receiveTimeNs);
+            std::fputc(',', f);
+            PrintSeconds(f, r.receiveTimeNs - r.sendTimeNs);
+            std::fputc('\n', f);
+        }
+    }
+
+    std::fclose(in);
+    for (std::FILE* f : out)
+    {
+        valid = (std::fclose(f) == 0) && valid;
+    }
+    if (!valid && error.empty())
+    {
+        error = "errore di scrittura dei file CSV";
+    }
+    return valid;
+}
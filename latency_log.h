@@ -0,0 +1,101 @@
+#ifndef LATENCY_LOG_H
+#define LATENCY_LOG_H
+
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+// Record binario di dimensione fissa per un pacchetto ricevuto da un sink.
+// I nodi sono identificati da un indice nella tabella dei nomi del file.
+struct LatencyRecord
+{
+    uint16_t srcNode;
+    uint16_t dstNode;
+    uint8_t trafficType;
+    uint8_t reserved[3];
+    uint32_t seq;
+    int64_t sendTimeNs;
+    int64_t receiveTimeNs;
+};
+
+static_assert(sizeof(LatencyRecord) == 32, "LatencyRecord deve restare di 32 byte");
+
+// Scrittore del log binario delle latenze.
+//
+// I record vengono accumulati in blocchi grandi; un blocco pieno passa a un
+// thread in background che lo scrive su disco, mentre la simulazione continua
+// a riempire il successivo. Se il disco resta indietro di più di
+// maxPendingBlocks blocchi la simulazione aspetta, così la memoria resta limitata.
+//
+// Layout del file (endianness della macchina che l'ha scritto):
+//   FileHeader | record... | tabella dei nodi | FileTrailer
+// La tabella dei nodi è scritta alla chiusura: per ogni nodo lunghezza (u16) e
+// caratteri del nome, poi lunghezza e caratteri dell'indirizzo.
+class LatencyLogWriter
+{
+  public:
+    explicit LatencyLogWriter(size_t blockRecords = 1 << 16, size_t maxPendingBlocks = 8);
+    ~LatencyLogWriter();
+
+    LatencyLogWriter(const LatencyLogWriter&) = delete;
+    LatencyLogWriter& operator=(const LatencyLogWriter&) = delete;
+
+    bool Open(const std::string& path);
+    bool IsOpen() const;
+
+    // registra un nodo con il suo indirizzo e ne restituisce l'indice; un nome
+    // già registrato mantiene il primo indirizzo non vuoto
+    uint16_t RegisterNode(const std::string& name, const std::string& address);
+    // indice di un nodo, registrato senza indirizzo se non è ancora noto
+    uint16_t NodeId(const std::string& name);
+
+    void Append(const LatencyRecord& record)
+    {
+        m_current.push_back(record);
+        if (m_current.size() >= m_blockRecords)
+        {
+            SubmitCurrent();
+        }
+    }
+
+    // scrive i blocchi rimasti e la tabella dei nodi, poi chiude il file
+    void Close();
+
+    uint64_t GetRecordCount() const;
+
+  private:
+    void SubmitCurrent();
+    void WriterLoop();
+
+    size_t m_blockRecords;
+    size_t m_maxPendingBlocks;
+    std::FILE* m_file{nullptr};
+    std::vector<LatencyRecord> m_current;
+    uint64_t m_records{0};
+
+    std::vector<std::pair<std::string, std::string>> m_nodes; // (nome, indirizzo)
+    std::unordered_map<std::string, uint16_t> m_nodeIds;
+
+    std::thread m_writer;
+    std::mutex m_mutex;
+    std::condition_variable m_cv;
+    std::deque<std::vector<LatencyRecord>> m_pending; // blocchi da scrivere
+    std::vector<std::vector<LatencyRecord>> m_free;   // blocchi già scritti, da riusare
+    bool m_stopping{false};
+    bool m_writeFailed{false};
+};
+
+// esporta un log binario nei due CSV per classe di traffico, con le colonne
+// src_node,src_ip,dst_node,dst_ip,send_time,receive_time,latency (secondi)
+bool ConvertLatencyLogToCsv(const std::string& logPath,
+                            const std::string& normalCsvPath,
+                            const std::string& sensitiveCsvPath,
+                            std::string& error);
+
+#endif // LATENCY_LOG_H
@@ -0,0 +1,108 @@
+#include "latency_metrics.h"
+
+#include "ns3/abort.h"
+
+#include <sstream>
+
+uint16_t
+HostDirectory::Add(const ns3::Ipv6Address& address, const std::string& name)
+{
+    auto it = m_ids.find(address);
+    if (it != m_ids.end())
+    {
+        return it->second;
+    }
+    NS_ABORT_MSG_IF(m_names.size() >= kUnknown, "Troppi host per HostDirectory");
+    uint16_t id = static_cast<uint16_t>(m_names.size());
+    NS_ABORT_MSG_IF(!m_idsByName.emplace(name, id).second,
+                    "HostDirectory: secondo indirizzo per l'host " << name);
+    m_ids.emplace(address, id);
+    m_names.push_back(name);
+    m_addresses.push_back(address);
+    return id;
+}
+
+uint16_t
+HostDirectory::Find(const ns3::Ipv6Address& address) const
+{
+    auto it = m_ids.find(address);
+    return it == m_ids.end() ? kUnknown : it->second;
+}
+
+const std::string&
+HostDirectory::GetName(uint16_t id) const
+{
+    static const std::string unknown = "Unknown";
+    return id < m_names.size() ? m_names[id] : unknown;
+}
+
+const ns3::Ipv6Address&
+HostDirectory::GetAddress(uint16_t id) const
+{
+    static const ns3::Ipv6Address any = ns3::Ipv6Address::GetAny();
+    return id < m_addresses.size() ? m_addresses[id] : any;
+}
+
+size_t
+HostDirectory::GetN() const
+{
+    return m_names.size();
+}
+
+FlowStatsBackend::FlowStatsBackend(ReceiverFlowStats& stats, const HostDirectory& hosts)
+    : m_stats(stats)
+{
+    std::vector<std::string> names;
+    for (uint16_t id = 0; id < hosts.GetN(); ++id)
+    {
+        names.push_back(hosts.GetName(id));
+    }
+    m_stats.SetHostNames(std::move(names));
+}
+
+void
+FlowStatsBackend::OnPacket(const LatencySample& sample)
+{
+    // senza numero di sequenza perdita e riordino non sono calcolabili
+    if (!sample.hasSeq)
+    {
+        return;
+    }
+    m_stats.OnPacket(sample.srcHost,
+                     sample.dstHost,
+                     sample.trafficType,
+                     sample.seq,
+                     sample.sendTime,
+                     sample.receiveTime);
+}
+
+LatencyLogBackend::LatencyLogBackend(LatencyLogWriter& writer, const HostDirectory& hosts)
+    : m_writer(writer)
+{
+    for (uint16_t id = 0; id < hosts.GetN(); ++id)
+    {
+        std::ostringstream address;
+        address << hosts.GetAddress(id);
+        m_logIds.push_back(m_writer.RegisterNode(hosts.GetName(id), address.str()));
+    }
+    m_unknownId = m_writer.NodeId(hosts.GetName(HostDirectory::kUnknown));
+}
+
+uint16_t
+LatencyLogBackend::LogId(uint16_t host) const
+{
+    return host < m_logIds.size() ? m_logIds[host] : m_unknownId;
+}
+
+void
+LatencyLogBackend::OnPacket(const LatencySample& sample)
+{
+    LatencyRecord record{};
+    record.srcNode = LogId(sample.srcHost);
+    record.dstNode = LogId(sample.dstHost);
+    record.trafficType = sample.trafficType;
+    record.seq = sample.seq;
+    record.sendTimeNs = sample.sendTime.GetNanoSeconds();
+    record.receiveTimeNs = sample.receiveTime.GetNanoSeconds();
+    m_writer.Append(record);
+}
@@ -0,0 +1,92 @@
+#ifndef LATENCY_METRICS_H
+#define LATENCY_METRICS_H
+
+#include "hop-record-tag.h"
+#include "latency_log.h"
+#include "path-id-tag.h"
+#include "receiver_flow_stats.h"
+
+#include "ns3/ipv6-address.h"
+#include "ns3/nstime.h"
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// Elenco degli host con id densi (0..N-1), costruito una volta prima della
+// simulazione: il sink risolve l'indirizzo sorgente con una tabella hash e
+// passa ai backend solo gli id. Contiene solo l'indirizzo di ciascun host,
+// uno per nome: le interfacce dei router non sono host e il log binario
+// riporterebbe i loro indirizzi al posto di quelli degli host.
+class HostDirectory
+{
+  public:
+    static constexpr uint16_t kUnknown = 0xffff;
+
+    uint16_t Add(const ns3::Ipv6Address& address, const std::string& name);
+    // kUnknown se l'indirizzo non appartiene a un host
+    uint16_t Find(const ns3::Ipv6Address& address) const;
+    // "Unknown" per kUnknown
+    const std::string& GetName(uint16_t id) const;
+    const ns3::Ipv6Address& GetAddress(uint16_t id) const;
+    size_t GetN() const;
+
+  private:
+    std::unordered_map<ns3::Ipv6Address, uint16_t, ns3::Ipv6AddressHash> m_ids;
+    std::unordered_map<std::string, uint16_t> m_idsByName;
+    std::vector<std::string> m_names;
+    std::vector<ns3::Ipv6Address> m_addresses;
+};
+
+// un pacchetto ricevuto da un sink di latenza
+struct LatencySample
+{
+    uint16_t srcHost;
+    uint16_t dstHost;
+    uint8_t trafficType;
+    bool hasSeq; // false se il pacchetto non ha un SeqTsSizeHeader valido
+    uint32_t seq;
+    ns3::Time sendTime;
+    ns3::Time receiveTime;
+    const ns3::HopRecordTag* hops; // nullptr se assente o non richiesto dal sink
+    const ns3::PathIdTag* path;    // idem
+};
+
+// destinazione delle misure di un LatencySinkApplication
+class LatencyMetricsBackend
+{
+  public:
+    virtual ~LatencyMetricsBackend() = default;
+    virtual void OnPacket(const LatencySample& sample) = 0;
+};
+
+// perdita, riordino, jitter e istogrammi di latenza per flusso
+class FlowStatsBackend : public LatencyMetricsBackend
+{
+  public:
+    // passa a stats i nomi degli host: i flussi restano indicizzati per id
+    FlowStatsBackend(ReceiverFlowStats& stats, const HostDirectory& hosts);
+    void OnPacket(const LatencySample& sample) override;
+
+  private:
+    ReceiverFlowStats& m_stats;
+};
+
+// log binario per pacchetto
+class LatencyLogBackend : public LatencyMetricsBackend
+{
+  public:
+    // registra subito tutti gli host, con il loro indirizzo, nella tabella dei nodi del log
+    LatencyLogBackend(LatencyLogWriter& writer, const HostDirectory& hosts);
+    void OnPacket(const LatencySample& sample) override;
+
+  private:
+    uint16_t LogId(uint16_t host) const;
+
+    LatencyLogWriter& m_writer;
+    std::vector<uint16_t> m_logIds; // id host -> id nel log
+    uint16_t m_unknownId;
+};
+
+#endif // LATENCY_METRICS_H
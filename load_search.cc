@@ -0,0 +1,192 @@
+#include "load_search.h"
+
+#include "process_runner.h"
+#include "run_summary.h"
+
+#include <cstdio>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <set>
+#include <sstream>
+
+namespace
+{
+
+struct Probe
+{
+    double loadFactor{0.0};
+    bool completed{false}; // il figlio è terminato e ha scritto il riepilogo
+    bool pass{false};
+    RunSummary summary;
+};
+
+bool
+MeetsTarget(const RunSummary& summary, const SimulationParameters& params)
+{
+    if (summary.Get("aborted") != 0.0)
+    {
+        return false;
+    }
+    std::string prefix = "class" + std::to_string(params.targetClass) + "_";
+    if (summary.Get(prefix + "received") == 0.0)
+    {
+        return false;
+    }
+    if (params.targetLoss >= 0 && summary.Get(prefix + "loss") > params.targetLoss)
+    {
+        return false;
+    }
+    return params.targetLatencyMs <= 0 ||
+           summary.Get(prefix + "target_pct_ms") <= params.targetLatencyMs;
+}
+
+class LoadSearch
+{
+  public:
+    LoadSearch(const SimulationParameters& params, int argc, char* argv[])
+        : m_params(params)
+    {
+        std::set<std::string> drop{"searchScale"};
+        drop.insert(ChildInputOptions().begin(), ChildInputOptions().end());
+        m_baseArgs.push_back(CurrentExecutable());
+        for (const auto& arg : ForwardedArguments(argc, argv, drop))
+        {
+            m_baseArgs.push_back(arg);
+        }
+        for (const auto& arg : ChildInputArguments(params))
+        {
+            m_baseArgs.push_back(arg);
+        }
+    }
+
+    Probe Run(double loadFactor)
+    {
+        std::ostringstream dir;
+        dir << "load_search/probe_" << std::setw(2) << std::setfill('0') << m_probes.size();
+        std::string workDir = AbsolutePath(dir.str());
+        std::string summaryPath = workDir + "/summary.txt";
+
+        double stop = m_params.trafficStart + m_params.searchDuration;
+        // lascia il tempo ai pacchetti in coda di arrivare prima della fine
+        double drain = 2.0;
+        double earlyStop = m_params.earlyStopFactor > 0 ? m_params.earlyStopFactor : 2.0;
+
+        std::vector<std::string> args = m_baseArgs;
+        args.push_back("--searchScale=false");
+        args.push_back("--loadFactor=" + FormatDouble(loadFactor));
+        args.push_back("--summaryFile=" + summaryPath);
+        args.push_back("--trafficStop=" + FormatDouble(stop));
+        args.push_back("--stopTime=" + FormatDouble(stop + drain));
+        args.push_back("--earlyStopFactor=" + FormatDouble(earlyStop));
+        // le prove servono solo per il riepilogo
+        args.push_back("--latencyLog=");
+        args.push_back("--histogramInterval=0");
+        args.push_back("--queueChangeLog=false");
+
+        std::cout << "[LOADSEARCH] prova " << m_probes.size() << ": loadFactor=" << loadFactor
+                  << std::flush;
+
+        Probe probe;
+        probe.loadFactor = loadFactor;
+        std::remove(summaryPath.c_str());
+        int status = RunChild(args, workDir, "run.log");
+        probe.completed = (status == 0) && probe.summary.Read(summaryPath);
+        probe.pass = probe.completed && MeetsTarget(probe.summary, m_params);
+
+        std::string prefix = "class" + std::to_string(m_params.targetClass) + "_";
+        std::cout << (probe.pass ? " -> ok" : " -> fuori obiettivo");
+        if (probe.completed)
+        {
+            std::cout << " (loss=" << probe.summary.Get(prefix + "loss")
+                      << " p" << m_params.targetPercentile << "="
+                      << probe.summary.Get(prefix + "target_pct_ms") << " ms"
+                      << (probe.summary.Get("aborted") != 0.0 ? ", interrotta" : "") << ")";
+        }
+        else
+        {
+            std::cout << " (simulazione fallita, vedi " << workDir << "/run.log)";
+        }
+        std::cout << std::endl;
+
+        m_probes.push_back(probe);
+        return probe;
+    }
+
+    void WriteCsv(const std::string& path) const
+    {
+        std::ofstream csv(path);
+        std::string prefix = "class" + std::to_string(m_params.targetClass) + "_";
+        csv << "probe,load_factor,normal_scale,sensitive_scale,completed,pass,aborted,"
+               "loss,target_pct_ms,p50_ms,p99_ms\n";
+        for (size_t i = 0; i < m_probes.size(); ++i)
+        {
+            const Probe& p = m_probes[i];
+            csv << i << "," << p.loadFactor << "," << m_params.normalScale * p.loadFactor << ","
+                << m_params.sensitiveScale * p.loadFactor << "," << p.completed << "," << p.pass
+                << "," << p.summary.Get("aborted") << "," << p.summary.Get(prefix + "loss")
+                << "," << p.summary.Get(prefix + "target_pct_ms") << ","
+                << p.summary.Get(prefix + "p50_ms") << "," << p.summary.Get(prefix + "p99_ms")
+                << "\n";
+        }
+    }
+
+  private:
+    const SimulationParameters& m_params;
+    std::vector<std::string> m_baseArgs;
+    std::vector<Probe> m_probes;
+};
+
+} // namespace
+
+int
+RunLoadSearch(const SimulationParameters& params, int argc, char* argv[])
+{
+    LoadSearch search(params, argc, argv);
+
+    double low = params.searchLow;
+    double high = params.searchHigh;
+
+    Probe lowProbe = search.Run(low);
+    if (!lowProbe.pass)
+    {
+        search.WriteCsv("load_search.csv");
+        std::cout << "[LOADSEARCH] obiettivo non rispettato nemmeno con loadFactor=" << low
+                  << std::endl;
+        return 1;
+    }
+
+    Probe highProbe = search.Run(high);
+    if (highProbe.pass)
+    {
+        search.WriteCsv("load_search.csv");
+        std::cout << "[LOADSEARCH] obiettivo rispettato anche con loadFactor=" << high
+                  << ": la saturazione è oltre searchHigh" << std::endl;
+        return 0;
+    }
+
+    // invariante: low rispetta l'obiettivo, high no
+    for (uint32_t i = 0; i < params.searchIterations; ++i)
+    {
+        if ((high - low) <= params.searchTolerance * high)
+        {
+            break;
+        }
+        double mid = (low + high) / 2.0;
+        if (search.Run(mid).pass)
+        {
+            low = mid;
+        }
+        else
+        {
+            high = mid;
+        }
+    }
+
+    search.WriteCsv("load_search.csv");
+    std::cout << "[LOADSEARCH] loadFactor massimo=" << low
+              << " normalScale=" << params.normalScale * low
+              << " sensitiveScale=" << params.sensitiveScale * low
+              << " (primo valore fuori obiettivo: " << high << ")" << std::endl;
+    return 0;
+}
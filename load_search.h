@@ -0,0 +1,16 @@
+#ifndef LOAD_SEARCH_H
+#define LOAD_SEARCH_H
+
+#include "simulation_parameters.h"
+
+// Ricerca del punto di saturazione: bisezione su loadFactor tra searchLow e
+// searchHigh. Ogni prova è una simulazione figlia (stesso eseguibile, stessi
+// argomenti) con finestra di traffico ridotta a searchDuration e terminazione
+// anticipata, che scrive il proprio riepilogo; il driver legge il riepilogo e
+// decide se l'obiettivo di servizio è rispettato.
+//
+// Le prove finiscono in load_search/probe_<i>/ e l'esito in load_search.csv.
+// Restituisce il codice di uscita del processo.
+int RunLoadSearch(const SimulationParameters& params, int argc, char* argv[]);
+
+#endif // LOAD_SEARCH_H
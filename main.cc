@@ -11,10 +11,38 @@
 #include "QueueStatusSender.h"
 #include "action.h"
 #include "csv_logger.h"
+#include "dag_builder.h"
 #include "dag_database.h"
+#include "flow_class_monitor.h"
 #include "flow_demand_reader.h"
+#include "hop_delay_stats.h"
+#include "hot_path_profiler.h"
+#include "latency-sink-application.h"
+#include "latency_log.h"
+#include "latency_metrics.h"
+#include "load_search.h"
+#include "packet_capture.h"
+#include "path_stats.h"
+#include "process_runner.h"
+#include "progress_reporter.h"
+#include "packet_size_distribution.h"
+#include "qregister_checkpoint.h"
 #include "qrouting-helper.h"
+#include "queue_monitor.h"
+#include "receiver_flow_stats.h"
+#include "replication_runner.h"
+#include "router_table.h"
+#include "run_summary.h"
+#include "scenario_runner.h"
+#include "simulation_parameters.h"
+#include "sndlib_demand_loader.h"
+#include "sweep_runner.h"
+#include "tcp-flow-application.h"
+#include "tcp_flow_stats.h"
 #include "timestamped-onoff-application.h"
+#include "topology.h"
+#include "topology_generator.h"
+#include "topology_partition.h"
 
 #include "ns3/applications-module.h"
 #include "ns3/callback.h"
@@ -45,48 +73,46 @@
 #include "ns3/traffic-control-layer.h"
 #include "traffic-type-header.h"
 
+#ifdef NS3_MPI
+#include "ns3/mpi-interface.h"
+#endif
+
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
 #include <fstream>
 #include <iomanip> // per std::setprecision
 #include <iostream>
+#include <memory>
+#include <set>
 #include <string>
 #include <vector>
 
 std::ofstream csvFile;
-std::ofstream queueLengthCsv;
-std::ofstream csvLatencyNormalTraffic("latency_normal_traffic.csv");
-std::ofstream csvLatencyDelaySensitive("latency_delay_sensitive.csv");
-bool headerWritten = false;
 
 using namespace ns3;
 
 NS_LOG_COMPONENT_DEFINE("NeighborsQueueStatusInRealScenario");
 
-// struct per i Collegamenti tra nodi (da XML) con capacità scalata
-struct Link
-{
-    std::string source;
-    std::string target;
-    double capacityMbps;
-};
-
 void
-installReceiverExchangeStateAppOnAllNodes(
-    std::map<std::string, Ptr<Node>>& nodeMap,
-    std::map<std::string, std::shared_ptr<std::vector<std::vector<Action>>>>& nameToQRegister)
+installReceiverExchangeStateAppOnAllNodes(const RouterTable& routers, Time stopTime)
 {
-    for (const auto& [name, node] : nodeMap)
+    for (const auto& [name, node] : routers.GetLocal())
     {
-        auto q_register = nameToQRegister[name];
+        auto q_register = routers.GetQRegister(name);
         Ptr<QueueStatusReceiver> receiverApp = CreateObject<QueueStatusReceiver>();
         receiverApp->SetQRegister(q_register);
         node->AddApplication(receiverApp);
-        receiverApp->SetStartTime(Seconds(1.0));
-        receiverApp->SetStopTime(Seconds(140.0));
+        // in ascolto da subito, prima di qualsiasi sender
+        receiverApp->SetStartTime(Seconds(0.0));
+        receiverApp->SetStopTime(stopTime);
     }
 }
 
+// ogni verso è installato solo se il suo router è simulato da questo rank
 void
 installBidirectionalQueueStatusSenders(
+    const RouterTable& routers,
     Ipv6Address addrA,
     Ipv6Address addrB,
     Ptr<Node> nodeA,
@@ -96,41 +122,42 @@ installBidirectionalQueueStatusSenders(
     std::shared_ptr<std::vector<std::vector<Action>>> q_registerA,
     std::shared_ptr<std::vector<std::vector<Action>>> q_registerB,
     std::int32_t indexA,
-    std::int32_t indexB)
+    std::int32_t indexB,
+    Time interval,
+    Time startTime,
+    Time stopTime,
+    std::shared_ptr<const DagSet> dags)
 {
-    Ptr<QueueStatusApp> firstWaySender = CreateObject<QueueStatusApp>();
-    firstWaySender->Setup(addrA, addrB, nameA, nameB, q_registerA, indexB);
-    nodeA->AddApplication(firstWaySender);
-    firstWaySender->SetStartTime(Seconds(2.0));
-    firstWaySender->SetStopTime(Seconds(140.0));
-
-    Ptr<QueueStatusApp> secondWaySender = CreateObject<QueueStatusApp>();
-    secondWaySender->Setup(addrB, addrA, nameB, nameA, q_registerB, indexA);
-    nodeB->AddApplication(secondWaySender);
-    secondWaySender->SetStartTime(Seconds(2.0));
-    secondWaySender->SetStopTime(Seconds(140.0));
-}
+    if (routers.IsLocal(nameA))
+    {
+        Ptr<QueueStatusApp> firstWaySender = CreateObject<QueueStatusApp>();
+        firstWaySender->Setup(addrA, addrB, nameA, nameB, q_registerA, indexA, indexB);
+        firstWaySender->SetInterval(interval);
+        firstWaySender->SetDags(dags);
+        nodeA->AddApplication(firstWaySender);
+        firstWaySender->SetStartTime(startTime);
+        firstWaySender->SetStopTime(stopTime);
+    }
 
-int
-returnIndexOfNode(std::vector<std::string> nodeIds, std::string nodeName)
-{
-    int index = 0;
-    for (const auto& name : nodeIds)
+    if (routers.IsLocal(nameB))
     {
-        if (name == nodeName)
-        {
-            return index;
-        }
-        index++;
+        Ptr<QueueStatusApp> secondWaySender = CreateObject<QueueStatusApp>();
+        secondWaySender->Setup(addrB, addrA, nameB, nameA, q_registerB, indexB, indexA);
+        secondWaySender->SetInterval(interval);
+        secondWaySender->SetDags(dags);
+        nodeB->AddApplication(secondWaySender);
+        secondWaySender->SetStartTime(startTime);
+        secondWaySender->SetStopTime(stopTime);
     }
-    return -1; // nodo non trovato
 }
 
 void
 installOnOffApplicationV6(std::vector<FlowDemand>& demands,
                           std::map<std::string, Ptr<Node>>& hostMap,
                           std::map<std::string, Ipv6Address>& hostNameToIpv6,
-                          double scale)
+                          double scale,
+                          Time startTime,
+                          Time stopTime)
 {
     for (const auto& flow : demands)
     {
@@ -150,88 +177,46 @@ installOnOffApplicationV6(std::vector<FlowDemand>& demands,
         onoff.SetAttribute("OffTime", StringValue("ns3::ConstantRandomVariable[Constant=0]"));
 
         ApplicationContainer app = onoff.Install(srcNode);
-        app.Start(Seconds(2.0));
-        app.Stop(Seconds(140.0)); 
+        app.Start(startTime);
+        app.Stop(stopTime);
     }
 }
 
 void
-createQRegisterForAllNodes(
-    std::map<std::string, Ptr<Node>>& nodeMap,
-    std::map<std::string, std::shared_ptr<std::vector<std::vector<Action>>>>& nameToQRegister)
+createQRegisterForAllNodes(RouterTable& routers, const DagSet& dags)
 {
-    std::vector<Dag> dags = LoadDags();
-
-    int index = 0;
-    for (const auto& [name, node] : nodeMap)
+    for (uint32_t index = 0; index < routers.GetN(); ++index)
     {
-        // matrice q_register per ogni singolo nodo
-        auto q_register = std::make_shared<std::vector<std::vector<Action>>>();
-
-        // per ogni DAG, prende la riga corrispondente
-        for (const auto& dag : dags)
+        // i router simulati da altri rank non hanno un q_register qui
+        const std::string& name = routers.GetName(index);
+        if (routers.IsLocal(name))
         {
-            if (index < dag.adjacency_list.size())
-            {
-                std::vector<Action> actions;
-                for (const auto& s : dag.adjacency_list[index])
-                {
-                    Action action;
-                    action.idNodeDestination = s;
-                    action.q_value = 0; // valore iniziale di q
-                    actions.push_back(action);
-                }
-                q_register->push_back(std::move(actions));
-            }
-            else
-            {
-                std::cout << "Index out of bounds for DAG adjacency list (node " << name
-                          << ", index=" << index << ")\n";
-            }
+            // righe del DAG di ogni destinazione, con q iniziale a 0
+            routers.SetQRegister(name, std::make_shared<QRegister>(dags.BuildQRegister(index)));
         }
-
-        // salva nella nuova mappa: nome nodo → q_register
-        nameToQRegister[name] = q_register;
-        index++;
     }
-
 }
 
 void
-printQRegisters(
-    const std::map<std::string, std::shared_ptr<std::vector<std::vector<Action>>>>& nameToQRegister,
-    const std::map<std::string, Ptr<Node>>& nodeMap)
+printQRegisters(const RouterTable& routers)
 {
-    for (const auto& [name, q_register_ptr] : nameToQRegister)
+    for (const auto& [name, q_register_ptr] : routers.GetQRegisters())
     {
         std::cout << "Nodo: " << name << "\n";
 
         const auto& q_register = *q_register_ptr;
-        Ptr<Node> node = nodeMap.at(name);
-
         for (size_t d = 0; d < q_register.size(); ++d)
         {
             std::cout << "  DAG " << d << ": ";
             for (const auto& action : q_register[d])
             {
+                // indirizzo locale del collegamento verso il vicino
                 std::ostringstream outDevStr;
-
-                if (action.outDevice)
+                const RouterTable::Adjacency* adjacency =
+                    routers.GetAdjacency(name, action.idNodeDestination);
+                if (action.outDevice && adjacency)
                 {
-                    // Provo a ottenere l'indirizzo IPv6 associato al device
-                    Ptr<Ipv6> ipv6 = node->GetObject<Ipv6>();
-                    for (uint32_t i = 0; i < ipv6->GetNInterfaces(); ++i)
-                    {
-                        for (uint32_t j = 0; j < ipv6->GetNAddresses(i); ++j)
-                        {
-                            if (ipv6->GetNetDevice(i) == action.outDevice)
-                            {
-                                Ipv6InterfaceAddress addr = ipv6->GetAddress(i, j);
-                                outDevStr << addr.GetAddress();
-                                break;
-                            }
-                        }
-                    }
+                    outDevStr << adjacency->localAddress;
                 }
                 else
                 {
@@ -247,60 +232,61 @@ printQRegisters(
     }
 }
 
+// rotte statiche del traffico normale (--normalRouting=static): su ogni router
+// locale, verso la /64 di ogni host, il prossimo salto di un cammino minimo
 void
-assignOutDevices(
-    const std::map<std::string, Ptr<Node>>& nodeMap,
-    std::map<std::string, std::shared_ptr<std::vector<std::vector<Action>>>>& nameToQRegister)
+installShortestPathRoutes(const RouterTable& routers,
+                          const Topology& topology,
+                          const std::map<std::string, Ipv6Address>& hostAddressMap)
 {
-    // Step 1: cstruzione mappa <{nome_nodo_sorgente, nome_nodo_destinazione}, NetDevice>
-    std::map<std::pair<std::string, std::string>, Ptr<NetDevice>> nodeToDestDevice;
-
-    for (const auto& [nodeName, node] : nodeMap)
+    auto nextHops = ShortestPathNextHops(topology);
+    Ipv6StaticRoutingHelper staticRoutingHelper;
+    uint32_t routes = 0;
+    for (const auto& [name, node] : routers.GetLocal())
     {
-        for (uint32_t i = 0; i < node->GetNDevices(); ++i)
+        uint32_t index = routers.GetIndex(name);
+        Ptr<Ipv6> ipv6 = node->GetObject<Ipv6>();
+        Ptr<Ipv6StaticRouting> staticRouting = staticRoutingHelper.GetStaticRouting(ipv6);
+        for (uint32_t dst = 0; dst < routers.GetN(); ++dst)
         {
-            Ptr<PointToPointNetDevice> p2pDev =
-                DynamicCast<PointToPointNetDevice>(node->GetDevice(i));
-            if (!p2pDev)
-                continue;
-
-            Ptr<Channel> channel = p2pDev->GetChannel();
-            if (!channel)
-                continue;
-
-            for (uint32_t j = 0; j < channel->GetNDevices(); ++j)
+            if (dst == index)
             {
-                Ptr<NetDevice> peerDev = channel->GetDevice(j);
-                Ptr<Node> peerNode = peerDev->GetNode();
-
-                if (peerNode->GetId() != node->GetId())
-                {
-                    // Trova il nome del peerNode
-                    for (const auto& [peerName, peerNodePtr] : nodeMap)
-                    {
-                        if (peerNodePtr == peerNode)
-                        {
-                            nodeToDestDevice[{nodeName, peerName}] = p2pDev;
-                            break;
-                        }
-                    }
-                }
+                continue;
             }
+            const RouterTable::Adjacency* adjacency =
+                routers.GetAdjacency(name, routers.GetName(nextHops[dst][index]));
+            NS_ABORT_MSG_IF(!adjacency,
+                            "nessun collegamento da " << name << " verso il prossimo salto");
+            Ipv6Address host = hostAddressMap.at(routers.GetName(dst));
+            staticRouting->AddNetworkRouteTo(host.CombinePrefix(Ipv6Prefix(64)),
+                                             Ipv6Prefix(64),
+                                             adjacency->peerAddress,
+                                             ipv6->GetInterfaceForDevice(adjacency->device));
+            routes++;
         }
     }
+    std::cout << "[ROUTING] " << routes << " rotte statiche sui cammini minimi" << std::endl;
+}
 
-    // Step 2: assegnazione outDevice usando la mappa
-    for (auto& [nodeName, q_register_ptr] : nameToQRegister)
+// dispositivo di uscita di ogni azione, dal registro dei collegamenti
+void
+assignOutDevices(const RouterTable& routers)
+{
+    for (const auto& [nodeName, q_register_ptr] : routers.GetQRegisters())
     {
-        auto& q_register = *q_register_ptr;
-        for (auto& dagRow : q_register)
+        for (auto& dagRow : *q_register_ptr)
         {
             for (auto& action : dagRow)
             {
-                auto it = nodeToDestDevice.find({nodeName, action.idNodeDestination});
-                if (it != nodeToDestDevice.end())
+                if (action.idNodeDestination == "sink")
+                {
+                    continue; // consegna locale, nessun dispositivo
+                }
+                const RouterTable::Adjacency* adjacency =
+                    routers.GetAdjacency(nodeName, action.idNodeDestination);
+                if (adjacency)
                 {
-                    action.outDevice = it->second;
+                    action.outDevice = adjacency->device;
                 }
                 else
                 {
@@ -315,99 +301,31 @@ assignOutDevices(
 void
 installUdpSinkOnAllHosts(std::map<std::string, Ptr<Node>>& nodeMap,
                          uint16_t port,
-                         std::map<Ipv6Address, std::string>& ipv6ToHostName)
+                         std::shared_ptr<const HostDirectory> hosts,
+                         const std::vector<std::shared_ptr<LatencyMetricsBackend>>& backends,
+                         bool readHopRecords,
+                         bool readPathIds)
 {
     for (auto& [name, node] : nodeMap)
     {
-        // Creazione socket UDP
-        Ptr<Socket> recvSocket = Socket::CreateSocket(node, UdpSocketFactory::GetTypeId());
-        Inet6SocketAddress local = Inet6SocketAddress(Ipv6Address::GetAny(), port);
-        recvSocket->Bind(local);
-
-        // Ptr<Packet> packet = recvSocket->RecvFrom(from); // riceve il primo pacchetto
-        Time sendTime;
-        Time receiveTime;
-        Time latency;
-
-        // Impostiamo la callback che stampa quando arriva un pacchetto
-        recvSocket->SetRecvCallback(
-            Callback<void, Ptr<Socket>>([&ipv6ToHostName](Ptr<Socket> socket) {
-                Address from;
-
-                Ptr<Packet> packet = socket->RecvFrom(from);
-                Inet6SocketAddress addr = Inet6SocketAddress::ConvertFrom(from);
-
-                TimestampTag tag;
-                if (packet->PeekPacketTag(tag))
-                {
-                    Time sendTime = tag.GetTimestamp();
-                    Time receiveTime = Simulator::Now();
-                    Time latency = receiveTime - sendTime;
-
-                    std::string srcNode = "Unknown";
-                    std::string dstNode = "unknown";
-
-                    if (!headerWritten)
-                    {
-                        csvLatencyDelaySensitive << std::fixed << std::setprecision(9);
-                        csvLatencyDelaySensitive
-                            << "src_node,src_ip,dst_node,dst_ip,send_time,receive_time,latency\n";
-
-                        csvLatencyNormalTraffic << std::fixed << std::setprecision(9);
-                        csvLatencyNormalTraffic
-                            << "src_node,src_ip,dst_node,dst_ip,send_time,receive_time,latency\n";
-
-                        headerWritten = true;
-                    }
-
-                    Ipv6Address srcIp = addr.GetIpv6();
-                    Ipv6Address dstIp =
-                        socket->GetNode()->GetObject<Ipv6>()->GetAddress(1, 1).GetAddress();
-
-                    auto itSrc = ipv6ToHostName.find(srcIp);
-                    if (itSrc != ipv6ToHostName.end())
-                    {
-                        srcNode = itSrc->second;
-                    }
-                    
-                    auto itDst = ipv6ToHostName.find(dstIp);
-                    if (itDst != ipv6ToHostName.end())
-                    {
-                        dstNode = itDst->second;
-                    }
-
-
-                    
-                    TrafficTypeHeader tHeader;
-                    packet->PeekHeader(tHeader);
-
-                    if (tHeader.GetType() == TrafficTypeHeader::DELAY_SENSITIVE)
-                    {
-                        csvLatencyDelaySensitive << srcNode << "," << srcIp << "," << dstNode
-                                                 << "," << dstIp << ","
-                                                << sendTime.GetSeconds() << ","
-                                                << receiveTime.GetSeconds() << ","
-                                                << latency.GetSeconds() << "\n";
-                    }
-                    else
-                    {
-                        csvLatencyNormalTraffic << srcNode << "," << srcIp << "," << dstNode
-                                                << "," << dstIp << ","
-                                                << sendTime.GetSeconds() << ","
-                                                << receiveTime.GetSeconds() << ","
-                                                << latency.GetSeconds() << "\n";
-                    }
-                    
-                    /*csvLatency << srcNode << "," << srcIp << "," << dstNode << "," << dstIp << ","
-                               << sendTime.GetSeconds() << "," << receiveTime.GetSeconds() << ","
-                               << latency.GetSeconds() << "\n";*/
-                }
-            }));
+        Ptr<LatencySinkApplication> sink = CreateObject<LatencySinkApplication>();
+        sink->SetAttribute("Port", UintegerValue(port));
+        sink->SetAttribute("ReadHopRecords", BooleanValue(readHopRecords));
+        sink->SetAttribute("ReadPathIds", BooleanValue(readPathIds));
+        sink->SetHostDirectory(hosts);
+        for (const auto& backend : backends)
+        {
+            sink->AddBackend(backend);
+        }
+        node->AddApplication(sink);
+        sink->SetStartTime(Seconds(0.0));
     }
 }
 
 void
-installUdpSinkOnAllRouters(std::map<std::string, Ptr<Node>>& nodeMap, uint16_t port)
+installUdpSinkOnAllRouters(std::map<std::string, Ptr<Node>>& nodeMap,
+                           uint16_t port,
+                           Time stopTime)
 {
     for (auto& [name, node] : nodeMap)
     {
@@ -416,8 +334,8 @@ installUdpSinkOnAllRouters(std::map<std::string, Ptr<Node>>& nodeMap, uint16_t p
         PacketSinkHelper sinkHelper("ns3::UdpSocketFactory", local);
 
         ApplicationContainer sinkApp = sinkHelper.Install(node);
-        sinkApp.Start(Seconds(1.0));
-        sinkApp.Stop(Seconds(140.0));
+        sinkApp.Start(Seconds(0.0));
+        sinkApp.Stop(stopTime);
     }
 }
 
@@ -428,13 +346,11 @@ installOnOffApplicationForLatencyAnalysis(std::vector<FlowDemand>& demands,
                                           double scale,
                                           double startTime,
                                           double stopTime,
-                                          uint32_t trafficType)
+                                          uint32_t trafficType,
+                                          const std::string& packetSize,
+                                          FlowClassMonitor* flowMonitor)
 {
-    /*Ptr<UniformRandomVariable> pktSizeRand = CreateObject<UniformRandomVariable>();
-    pktSizeRand->SetAttribute("Min", DoubleValue(512));
-    pktSizeRand->SetAttribute("Max", DoubleValue(1400));
-
-    Ptr<UniformRandomVariable> rateRand = CreateObject<UniformRandomVariable>();
+    /*Ptr<UniformRandomVariable> rateRand = CreateObject<UniformRandomVariable>();
     rateRand->SetAttribute("Min", DoubleValue(0.8));
     rateRand->SetAttribute("Max", DoubleValue(1.2));
 
@@ -442,11 +358,14 @@ installOnOffApplicationForLatencyAnalysis(std::vector<FlowDemand>& demands,
     jitter->SetAttribute("Min", DoubleValue(0.0));
     jitter->SetAttribute("Max", DoubleValue(1.0));*/
 
-    const uint32_t fixedPacketSize = 1000; // byte
-
     for (const auto& flow : demands)
     {
-        Ptr<Node> srcNode = nodeMap.at(flow.src);
+        auto src = nodeMap.find(flow.src);
+        if (src == nodeMap.end())
+        {
+            continue; // sorgente simulata da un altro rank
+        }
+        Ptr<Node> srcNode = src->second;
         Ipv6Address dstAddr = nodeNameToIpv6.at(flow.dst);
 
         double scaledRate = flow.rateMbps * scale;
@@ -456,9 +375,11 @@ installOnOffApplicationForLatencyAnalysis(std::vector<FlowDemand>& demands,
 
         Ptr<TimeStampedOnOffApplication> app = CreateObject<TimeStampedOnOffApplication>();
         app->SetAttribute("Remote", AddressValue(Inet6SocketAddress(dstAddr, 9999)));
-        app->SetAttribute("PacketSize", UintegerValue(fixedPacketSize));
+        app->SetAttribute("PacketSizeDistribution",
+                          PointerValue(CreatePacketSizeDistribution(packetSize)));
         app->SetAttribute("DataRate", StringValue(rateStr.str()));
         app->SetAttribute("TrafficType", UintegerValue(trafficType)); // 0 = normal, 1 = latency analysis
+        app->SetAttribute("EnableSeqTsSizeHeader", BooleanValue(true)); // per perdita/riordino
 
         // Imposto OnTime/OffTime casuali → burst
         double totalOnTime = stopTime - startTime;
@@ -468,6 +389,10 @@ installOnOffApplicationForLatencyAnalysis(std::vector<FlowDemand>& demands,
         app->SetAttribute("OffTime", StringValue("ns3::ConstantRandomVariable[Constant=0]"));
 
         srcNode->AddApplication(app);
+        if (flowMonitor)
+        {
+            flowMonitor->TrackUdpApplication(nodeNameToIpv6.at(flow.src), app, trafficType);
+        }
 
         //double offset = jitter->GetValue();
         app->SetStartTime(Seconds(startTime /*+ offset*/));
@@ -476,148 +401,466 @@ installOnOffApplicationForLatencyAnalysis(std::vector<FlowDemand>& demands,
 }
 
 void
-RecordQueueLengths(std::map<std::string, Ptr<Node>>& nodeMap,
-                   NetDeviceContainer& allDevices,
-                   QueueDiscContainer& qdiscs,
-                   double interval)
+installTcpWorkload(std::vector<FlowDemand>& demands,
+                   std::map<std::string, Ptr<Node>>& hostMap,
+                   std::map<std::string, Ipv6Address>& hostNameToIpv6,
+                   const SimulationParameters& params,
+                   double startTime,
+                   double stopTime,
+                   std::shared_ptr<TcpFlowStats> tcpStats)
 {
-    double currentTime = Simulator::Now().GetSeconds();
+    bool requestResponse = (params.tcpMode == "reqresp");
 
-    for (uint32_t i = 0; i < allDevices.GetN(); ++i)
+    // un sink TCP per host
+    for (const auto& [name, host] : hostMap)
     {
-        Ptr<NetDevice> dev = allDevices.Get(i);
-        Ptr<QueueDisc> qdisc = qdiscs.Get(i);
-        Ptr<Node> node = dev->GetNode();
-
-        // trova il nome del nodo
-        std::string nodeName;
-        for (const auto& [name, n] : nodeMap)
+        Ptr<TcpFlowSink> sink = CreateObject<TcpFlowSink>();
+        sink->SetAttribute("Port", UintegerValue(params.tcpPort));
+        if (requestResponse)
         {
-            if (n == node)
-            {
-                nodeName = name;
-                break;
-            }
+            sink->SetAttribute("RequestSize", UintegerValue(params.tcpRequestSize));
+            sink->SetAttribute("ResponseSize", UintegerValue(params.tcpResponseSize));
         }
+        sink->SetStats(tcpStats);
+        host->AddApplication(sink);
+        sink->SetStartTime(Seconds(0.0));
+        sink->SetStopTime(Seconds(stopTime + 1.0));
+    }
 
-        uint32_t queueLength = 0;
+    std::ostringstream thinkTimeStr;
+    thinkTimeStr << "ns3::ConstantRandomVariable[Constant=" << params.tcpThinkTime << "]";
 
-        if (qdisc)
+    // un flusso TCP per ogni coppia della matrice; nel bulk i byte da trasferire
+    // sono quelli che la domanda scalata genererebbe nella finestra di traffico
+    for (const auto& flow : demands)
+    {
+        auto src = hostMap.find(flow.src);
+        if (src == hostMap.end())
         {
-            // Come in QueueStatusReceiver → legge la dimensione totale del QueueDisc
-            queueLength = qdisc->GetNPackets();
+            continue; // sorgente simulata da un altro rank
         }
-        else
+        Ptr<Node> srcNode = src->second;
+        Ipv6Address dstAddr = hostNameToIpv6.at(flow.dst);
+
+        double bytes = flow.rateMbps * params.tcpScale * 1e6 / 8.0 * (stopTime - startTime);
+        uint64_t bulkBytes = std::max<uint64_t>(static_cast<uint64_t>(bytes), 1);
+
+        uint32_t flowId = tcpStats->RegisterFlow(flow.src,
+                                                 flow.dst,
+                                                 requestResponse ? TcpFlowStats::REQUEST_RESPONSE
+                                                                 : TcpFlowStats::BULK,
+                                                 requestResponse ? 0 : bulkBytes);
+
+        Ptr<TcpFlowApplication> app = CreateObject<TcpFlowApplication>();
+        app->SetAttribute("Remote", AddressValue(Inet6SocketAddress(dstAddr, params.tcpPort)));
+        app->SetAttribute("Mode", UintegerValue(requestResponse ? 1 : 0));
+        app->SetAttribute("BulkBytes", UintegerValue(bulkBytes));
+        app->SetAttribute("RequestSize", UintegerValue(params.tcpRequestSize));
+        app->SetAttribute("ResponseSize", UintegerValue(params.tcpResponseSize));
+        app->SetAttribute("ThinkTime", StringValue(thinkTimeStr.str()));
+        app->SetAttribute("TrafficType", UintegerValue(1)); // instradato da QRoutingProtocol
+        app->SetFlow(tcpStats, flowId);
+
+        srcNode->AddApplication(app);
+        app->SetStartTime(Seconds(startTime));
+        app->SetStopTime(Seconds(stopTime));
+    }
+}
+
+void
+validateDemands(const std::vector<std::vector<FlowDemand>>& allDemands,
+                const std::map<std::string, Ptr<Node>>& hostMap,
+                const SimulationParameters& params)
+{
+    NS_ABORT_MSG_IF(params.normalMatrix >= allDemands.size() ||
+                        params.sensitiveMatrix >= allDemands.size(),
+                    "Indice di matrice fuori intervallo: disponibili " << allDemands.size());
+
+    // le matrici caricate da file devono usare i nomi dei nodi della topologia
+    for (const auto& matrix : allDemands)
+    {
+        for (const auto& flow : matrix)
         {
-            /*
-            // Fallback: nel caso non ci sia un QueueDisc (es. TC disabilitato)
-            Ptr<QueueBase> queue = DynamicCast<QueueBase>(dev->GetObject<QueueBase>());
-            if (queue)
-                queueLength = queue->GetNPackets();*/
+            NS_ABORT_MSG_IF(hostMap.find(flow.src) == hostMap.end() ||
+                                hostMap.find(flow.dst) == hostMap.end(),
+                            "Domanda tra nodi sconosciuti: " << flow.src << " -> " << flow.dst);
         }
+    }
+}
+
+// true se la classe obiettivo supera di factor volte la perdita o il
+// percentile di latenza richiesti
+bool
+exceedsTarget(const ReceiverFlowStats& flowStats,
+              const SimulationParameters& params,
+              double factor)
+{
+    uint8_t type = params.targetClass;
+    if (params.targetLoss >= 0 && flowStats.GetClassLossRate(type) > params.targetLoss * factor)
+    {
+        return true;
+    }
+    double latencyMs = flowStats.GetClassLatencyPercentile(type, params.targetPercentile) * 1e3;
+    return params.targetLatencyMs > 0 && latencyMs > params.targetLatencyMs * factor;
+}
+
+void
+checkEarlyStop(const ReceiverFlowStats* flowStats,
+               const SimulationParameters* params,
+               bool* aborted)
+{
+    // servono abbastanza campioni perché percentile e perdita siano significativi
+    const uint64_t minSamples = 100;
+    if (flowStats->GetClassReceived(params->targetClass) >= minSamples &&
+        exceedsTarget(*flowStats, *params, params->earlyStopFactor))
+    {
+        std::cout << "[EARLYSTOP] obiettivo superato di oltre " << params->earlyStopFactor
+                  << " volte a t=" << Simulator::Now().GetSeconds() << " s" << std::endl;
+        *aborted = true;
+        Simulator::Stop();
+        return;
+    }
+    if (Simulator::Now().GetSeconds() + 1.0 <= params->trafficStop)
+    {
+        Simulator::Schedule(Seconds(1.0), &checkEarlyStop, flowStats, params, aborted);
+    }
+}
+
+void
+writeIntervalPercentiles(ReceiverFlowStats* flowStats, std::ofstream* csv, double interval)
+{
+    flowStats->WritePercentiles(*csv, Simulator::Now().GetSeconds(), true);
+    Simulator::Schedule(Seconds(interval), &writeIntervalPercentiles, flowStats, csv, interval);
+}
 
-        queueLengthCsv << currentTime << "," << nodeName << "," << i << "," << queueLength
-                       << "\n";
+// partenza a caldo: i Q-register dei router locali ripartono dai q salvati
+void
+loadQCheckpoints(const RouterTable& routers,
+                 const std::vector<std::string>& nodeNames,
+                 const std::vector<std::string>& paths)
+{
+    std::set<std::string> restored;
+    for (const auto& path : paths)
+    {
+        std::string error;
+        NS_ABORT_MSG_IF(
+            !LoadQRegisterCheckpoint(path, nodeNames, routers.GetQRegisters(), restored, error),
+            error);
+    }
+    std::cout << "[CHECKPOINT] Q-register caricati per " << restored.size() << "/"
+              << routers.GetQRegisters().size() << " router locali" << std::endl;
+}
+
+void
+saveQCheckpoint(std::shared_ptr<const RouterTable> routers,
+                std::vector<std::string> nodeNames,
+                std::string path)
+{
+    std::string error;
+    if (WriteQRegisterCheckpoint(path,
+                                 nodeNames,
+                                 routers->GetQRegisters(),
+                                 Simulator::Now().GetNanoSeconds(),
+                                 error))
+    {
+        std::cout << "[CHECKPOINT] Q-register salvati in " << path << " a t="
+                  << Simulator::Now().GetSeconds() << " s" << std::endl;
+    }
+    else
+    {
+        std::cerr << "Errore: " << error << std::endl;
+    }
+}
+
+void
+writeRunSummary(const std::string& path,
+                RunSummary summary,
+                const ReceiverFlowStats& flowStats,
+                const SimulationParameters& params,
+                bool aborted)
+{
+    summary.Set("sim_time", Simulator::Now().GetSeconds());
+    summary.Set("aborted", aborted ? 1.0 : 0.0);
+    summary.Set("load_factor", params.loadFactor);
+    summary.Set("rng_run", RngSeedManager::GetRun());
+    for (uint8_t type : {uint8_t(0), uint8_t(1)})
+    {
+        std::string prefix = "class" + std::to_string(type) + "_";
+        summary.Set(prefix + "received", flowStats.GetClassReceived(type));
+        summary.Set(prefix + "loss", flowStats.GetClassLossRate(type));
+        summary.Set(prefix + "p50_ms", flowStats.GetClassLatencyPercentile(type, 50) * 1e3);
+        summary.Set(prefix + "p90_ms", flowStats.GetClassLatencyPercentile(type, 90) * 1e3);
+        summary.Set(prefix + "p99_ms", flowStats.GetClassLatencyPercentile(type, 99) * 1e3);
+        summary.Set(prefix + "p999_ms", flowStats.GetClassLatencyPercentile(type, 99.9) * 1e3);
+        summary.Set(prefix + "target_pct_ms",
+                    flowStats.GetClassLatencyPercentile(type, params.targetPercentile) * 1e3);
+    }
+    // overhead dello scambio di stato tra router vicini
+    double simTime = Simulator::Now().GetSeconds();
+    summary.Set("control_packets", QueueStatusApp::GetTotalPacketsSent());
+    summary.Set("control_bytes", QueueStatusApp::GetTotalBytesSent());
+    summary.Set("control_kbps",
+                simTime > 0 ? QueueStatusApp::GetTotalBytesSent() * 8e-3 / simTime : 0.0);
+    if (!summary.Write(path))
+    {
+        std::cerr << "Errore: impossibile scrivere " << path << std::endl;
     }
-    Simulator::Schedule(Seconds(interval),
-                        &RecordQueueLengths,
-                        nodeMap,
-                        allDevices,
-                        qdiscs,
-                        interval);
 }
 
 int
-main()
+main(int argc, char* argv[])
 {
     Time::SetResolution(Time::NS);
 
-    // Creazione della topologia Abilene Networl
+    SimulationParameters params;
+    CommandLine cmd(__FILE__);
+    RegisterCommandLine(cmd, params);
+    cmd.Parse(argc, argv);
+
+    // scenari da file: tutti convalidati prima di simulare. Con un solo
+    // scenario l'esecuzione prosegue qui con gli argomenti del file seguiti da
+    // quelli della riga di comando, che i driver inoltrano ai figli
+    std::vector<std::string> scenarioArgs;
+    std::vector<char*> scenarioArgv;
+    if (!params.scenario.empty())
+    {
+        std::vector<Scenario> scenarios = LoadScenarios(SplitList(params.scenario));
+        std::vector<SimulationParameters> scenarioParams =
+            ValidateScenarios(scenarios, argc, argv);
+        if (scenarios.size() > 1)
+        {
+            return RunScenarioBatch(scenarios, scenarioParams, params, argc, argv);
+        }
+        scenarioArgs = ScenarioArguments(scenarios.front(), argc, argv);
+        for (auto& arg : scenarioArgs)
+        {
+            scenarioArgv.push_back(arg.data());
+        }
+        scenarioArgv.push_back(nullptr);
+        argc = static_cast<int>(scenarioArgs.size());
+        argv = scenarioArgv.data();
+
+        params = SimulationParameters();
+        CommandLine scenarioCmd(__FILE__);
+        RegisterCommandLine(scenarioCmd, params);
+        scenarioCmd.Parse(argc, argv);
+    }
+    ValidateParameters(params);
+
+    if (!params.convertLatencyLog.empty())
+    {
+        std::string error;
+        if (!ConvertLatencyLogToCsv(params.convertLatencyLog,
+                                    "latency_normal_traffic.csv",
+                                    "latency_delay_sensitive.csv",
+                                    error))
+        {
+            std::cerr << "Errore: " << error << std::endl;
+            return 1;
+        }
+        return 0;
+    }
+
+    if (params.searchScale)
+    {
+        return RunLoadSearch(params, argc, argv);
+    }
+
+    if (params.sweep)
+    {
+        return RunSweep(params, argc, argv);
+    }
+
+    if (params.replications > 0)
+    {
+        return RunReplications(params, argc, argv);
+    }
+
+    // esecuzione distribuita (--mpi): ogni rank simula una partizione dei router
+    uint32_t nRanks = 1;
+    uint32_t localRank = 0;
+    if (params.mpi)
+    {
+#ifdef NS3_MPI
+        GlobalValue::Bind("SimulatorImplementationType",
+                          StringValue("ns3::DistributedSimulatorImpl"));
+        MpiInterface::Enable(&argc, &argv);
+        nRanks = MpiInterface::GetSize();
+        localRank = MpiInterface::GetSystemId();
+#else
+        NS_FATAL_ERROR("--mpi richiede ns-3 configurato con --enable-mpi");
+#endif
+    }
+    if (nRanks > 1)
+    {
+        // i rank girano sulla stessa macchina: ognuno scrive i propri file in
+        // rank_<k>/, dopo aver risolto i percorsi di ingresso relativi
+        if (!params.demandFiles.empty())
+        {
+            params.demandFiles = AbsolutePathList(SplitList(params.demandFiles));
+        }
+        if (!params.topologyFile.empty())
+        {
+            params.topologyFile = AbsolutePath(params.topologyFile);
+        }
+        if (!params.qWarmStart.empty())
+        {
+            params.qWarmStart = AbsolutePathList(SplitList(params.qWarmStart));
+        }
+        std::string rankDir = "rank_" + std::to_string(localRank);
+        std::filesystem::create_directories(rankDir);
+        std::filesystem::current_path(rankDir);
+    }
+
+    // cattura PCAP selettiva al posto di EnablePcap su tutti i dispositivi
+    std::unique_ptr<PacketCapture> capture;
+    if (params.capture)
+    {
+        CaptureOptions options;
+        if (params.captureLinks != "all")
+        {
+            for (const auto& name : SplitList(params.captureLinks))
+            {
+                options.links.insert(name);
+            }
+        }
+        options.snaplen = params.captureSnaplen;
+        options.sampleEvery = params.captureSampling;
+        options.windowStart = params.captureStart;
+        options.windowStop = params.captureStop;
+        options.ringSize = params.captureRing;
+        capture = std::make_unique<PacketCapture>(options);
+    }
+
+    // Creazione della topologia: Abilene o generata (--topology)
+    auto setupStart = std::chrono::steady_clock::now();
+    // durata di ogni fase del set-up, nel riepilogo come setup_<fase>_s
+    std::vector<std::pair<std::string, double>> setupPhases;
+    auto phaseStart = setupStart;
+    auto endSetupPhase = [&](const std::string& phase) {
+        auto now = std::chrono::steady_clock::now();
+        setupPhases.emplace_back(phase, std::chrono::duration<double>(now - phaseStart).count());
+        phaseStart = now;
+    };
+    Topology topology = BuildTopology(params);
+    int32_t diameter = TopologyDiameter(topology);
+    WriteTopologySummary(topology, diameter, std::cout);
+
+    // RIPng considera irraggiungibili le destinazioni a 16 salti o più: oltre
+    // quel diametro il traffico normale usa rotte statiche sui cammini minimi
+    const int32_t ripngMaxHops = 15;
+    std::string normalRouting = params.normalRouting;
+    if (normalRouting == "auto")
+    {
+        normalRouting = diameter <= ripngMaxHops ? "ripng" : "static";
+    }
+    NS_ABORT_MSG_IF(normalRouting == "ripng" && diameter > ripngMaxHops,
+                    "normalRouting=ripng con diametro " << diameter << " > " << ripngMaxHops
+                                                        << " salti: usare static o auto");
+    std::cout << "[ROUTING] traffico normale: " << normalRouting << std::endl;
 
-    // Mappa degli ID nodo
-    std::map<std::string, Ptr<Node>> routerMap;
     NodeContainer allRouters;
 
     std::map<std::string, Ptr<Node>> hostMap;
     NodeContainer allHosts;
 
-    // memorizzo gli Ipv6 dei nodi per la simulazione del traffico
-    std::map<std::string, Ipv6Address> nodeNameToIpv6;
-    std::map<Ipv6Address, std::string> ipv6ToHostName;
-
-    // Lisa dei nomi dei nodi (dal file XML su abilene Network)
-    std::vector<std::string> nodeIds = {"ATLAM5",
-                                        "ATLAng",
-                                        "CHINng",
-                                        "DNVRng",
-                                        "HSTNng",
-                                        "IPLSng",
-                                        "KSCYng",
-                                        "LOSAng",
-                                        "NYCMng",
-                                        "SNVAng",
-                                        "STTLng",
-                                        "WASHng"};
+    // indirizzo -> nome del router, per le interfacce tra router e per gli host:
+    // un'unica tabella, condivisa in sola lettura da tutti i QRoutingProtocol
+    auto ipv6ToHostName = std::make_shared<std::map<Ipv6Address, std::string>>();
+
+    // nomi dei nodi in ordine alfabetico: l'indice è quello dei DAG e dei Q-register
+    const std::vector<std::string>& nodeIds = topology.nodes;
+    const std::vector<Link>& links = topology.links;
+
+    // DAG per destinazione (--dags): scritti a mano per Abilene o calcolati dalla topologia
+    bool staticDags =
+        params.dags == "static" || (params.dags == "auto" && params.topology == "abilene");
+    auto dags = std::make_shared<const DagSet>(
+        staticDags
+            ? DagSet::FromDags(nodeIds, LoadDags())
+            : BuildDagSet(topology, ParseDagMetric(params.dagMetric), params.dagStretch));
+    dags->WriteSummary(std::cout);
+
+    // partizione dei router tra i rank (un solo rank senza --mpi)
+    std::vector<std::pair<std::string, std::string>> edges;
+    for (const auto& link : links)
+    {
+        edges.emplace_back(link.source, link.target);
+    }
+    auto partition = std::make_shared<TopologyPartition>(nodeIds, edges, nRanks, localRank);
+    if (nRanks > 1)
+    {
+        partition->WriteSummary(std::cout);
+
+        // il simulatore distribuito richiede un lookahead positivo sui collegamenti
+        // tra rank: i ritardi sotto 1 us (vicini a 0 con geometric e waxman)
+        // sono portati a 1 us
+        const double minCutDelayMs = 1e-3;
+        uint32_t clamped = 0;
+        for (auto& link : topology.links)
+        {
+            if (partition->GetRank(link.source) != partition->GetRank(link.target) &&
+                link.delayMs < minCutDelayMs)
+            {
+                link.delayMs = minCutDelayMs;
+                clamped++;
+            }
+        }
+        if (clamped > 0)
+        {
+            std::cout << "[MPI] ritardo portato a " << minCutDelayMs * 1e3
+                      << " us su " << clamped << " collegamenti tagliati" << std::endl;
+        }
+    }
+    endSetupPhase("topology");
 
+    // router e Q-register condivisi con QRoutingHelper
+    auto routers = std::make_shared<RouterTable>(partition);
     for (const auto& id : nodeIds)
     {
-        Ptr<Node> node = CreateObject<Node>();
-        routerMap[id] = node;
-        allRouters.Add(node);
+        allRouters.Add(routers->Add(id));
     }
+    const std::map<std::string, Ptr<Node>>& routerMap = routers->GetAll();
+    std::map<std::string, Ptr<Node>> localRouterMap = routers->GetLocal();
 
-    std::map<std::string, std::shared_ptr<std::vector<std::vector<Action>>>> nameToQRegister;
-
-    QRoutingHelper qRoutingHelper(&routerMap, &nameToQRegister, nodeIds, ipv6ToHostName, &hostMap);
+    QRoutingHelper qRoutingHelper(routers, ipv6ToHostName);
 
     RipNgHelper ripngRouting;
+    Ipv6StaticRoutingHelper staticRouting;
     Ipv6ListRoutingHelper listRH;
     listRH.Add(qRoutingHelper, 100);
-    listRH.Add(ripngRouting, 10);
+    if (normalRouting == "ripng")
+    {
+        listRH.Add(ripngRouting, 10);
+    }
+    else
+    {
+        listRH.Add(staticRouting, 10);
+    }
 
     InternetStackHelper internet;
     internet.SetRoutingHelper(listRH);
     internet.Install(allRouters);
 
-    std::vector<Link> links;
-
-    // link originali    
-    // Aggiungi tutti i link con valori scalati
-    links.push_back({"ATLAng", "ATLAM5", 9.92}); // 99.2Mbps
-    links.push_back({"HSTNng", "ATLAng", 9.92});
-    links.push_back({"IPLSng", "ATLAng", 9.48});
-    links.push_back({"WASHng", "ATLAng", 9.92});
-    links.push_back({"IPLSng", "CHINng", 9.92});
-    links.push_back({"NYCMng", "CHINng", 9.92});
-    links.push_back({"KSCYng", "DNVRng", 9.92});
-    links.push_back({"SNVAng", "DNVRng", 9.92});
-    links.push_back({"STTLng", "DNVRng", 9.92});
-    links.push_back({"KSCYng", "HSTNng", 9.92});
-    links.push_back({"LOSAng", "HSTNng", 9.92});
-    links.push_back({"KSCYng", "IPLSng", 9.92});
-    links.push_back({"SNVAng", "LOSAng", 9.92});
-    links.push_back({"WASHng", "NYCMng", 9.92});
-    links.push_back({"STTLng", "SNVAng", 9.92});
-
     // contenitore di tutti i netDevice della rete
     NetDeviceContainer allDevices;
 
     uint32_t subnetCount = 0;
 
-    std::map<std::pair<std::string, std::string>, Ipv6InterfaceContainer> linkToIfaces;
-
     for (const auto& link : links)
     {
         PointToPointHelper p2p;
         std::ostringstream rate;
         rate << link.capacityMbps << "Mbps";
         p2p.SetDeviceAttribute("DataRate", StringValue(rate.str()));
-        p2p.SetChannelAttribute("Delay", StringValue("1ms"));
+        p2p.SetChannelAttribute("Delay", TimeValue(Seconds(link.delayMs / 1000.0)));
 
-        auto devices = p2p.Install(routerMap[link.source], routerMap[link.target]);
+        Ptr<Node> node1 = routers->Get(link.source);
+        Ptr<Node> node2 = routers->Get(link.target);
+        auto devices = p2p.Install(node1, node2);
 
-        std::cout << "installazione collegamentr tra " << routerMap[link.source]->GetId() << " e "
-                  << routerMap[link.target]->GetId() << std::endl;
+        std::cout << "installazione collegamentr tra " << node1->GetId() << " e "
+                  << node2->GetId() << std::endl;
 
         allDevices.Add(devices);
 
@@ -631,28 +874,18 @@ main()
         prefix << "fd00:" << std::hex << subnetCount << "::"; // prefisso ULA, non riservato
         ipv6.SetBase(Ipv6Address(prefix.str().c_str()), Ipv6Prefix(64));
         Ipv6InterfaceContainer ifaces = ipv6.Assign(devices);
-        linkToIfaces[{link.source, link.target}] = ifaces;
 
         // Attivo il forwarding IPv6
         ifaces.SetForwarding(0, true);
         ifaces.SetForwarding(1, true);
 
-        // devo salvare gli indirizzi Ipv6 per la generazione del traffico
-        Ptr<Node> node1 = routerMap[link.source];
-        Ptr<Node> node2 = routerMap[link.target];
-
+        // dispositivi e indirizzi nel registro: outDevice e sender li cercano lì
         Ipv6Address addr1 = ifaces.GetAddress(0, 1);
         Ipv6Address addr2 = ifaces.GetAddress(1, 1);
+        routers->AddLink(link.source, link.target, devices.Get(0), devices.Get(1), addr1, addr2);
 
-        ipv6ToHostName[addr1] = link.source;
-        ipv6ToHostName[addr2] = link.target;
-
-        // Salva solo se non è già presente
-        if (nodeNameToIpv6.find(link.source) == nodeNameToIpv6.end())
-            nodeNameToIpv6[link.source] = addr1;
-
-        if (nodeNameToIpv6.find(link.target) == nodeNameToIpv6.end())
-            nodeNameToIpv6[link.target] = addr2;
+        (*ipv6ToHostName)[addr1] = link.source;
+        (*ipv6ToHostName)[addr2] = link.target;
 
         std::cout << "Subnet " << subnetCount << ": " << prefix.str() << std::endl;
         for (uint32_t i = 0; i < devices.GetN(); ++i)
@@ -665,9 +898,12 @@ main()
         // adattamento dell'meccanismo di notifica dello stato della coda
         // sull'abilene network
 
-        // Abilita PCAP per entrambi i dispositivi del link
-        p2p.EnablePcap(link.source + "-" + link.target, devices.Get(0), true);
-        p2p.EnablePcap(link.source + "-" + link.target, devices.Get(1), true);
+        // cattura PCAP selettiva per entrambi i dispositivi del link
+        if (capture)
+        {
+            capture->Add(link.source + "-" + link.target, devices.Get(0));
+            capture->Add(link.source + "-" + link.target, devices.Get(1));
+        }
 
         std::cout << "[SENDER INSTALLATO] " << link.source << " → " << link.target
                   << "\n\tSrc: " << ifaces.GetAddress(0, 1)
@@ -678,6 +914,7 @@ main()
                   << "\n\tDst: " << ifaces.GetAddress(0, 1) << std::endl;
         subnetCount++;
     }
+    endSetupPhase("links");
 
     std::map<std::string, Ipv6Address> hostAddressMap;
 
@@ -686,12 +923,21 @@ main()
     hostStack.SetIpv4StackInstall(false);
     NetDeviceContainer allHostsDevs;
 
+    // host simulati da questo rank (tutti senza --mpi)
+    std::map<std::string, Ptr<Node>> localHostMap;
+    NodeContainer localHosts;
+
     for (const auto& [routerName, routerNode] : routerMap)
     {
-        // Creo gli host
-        Ptr<Node> host = CreateObject<Node>();
+        // Creo gli host, sullo stesso rank del proprio router
+        Ptr<Node> host = CreateObject<Node>(partition->GetRank(routerName));
         hostMap[routerName] = host;
         hostStack.Install(host);
+        if (partition->IsLocal(routerName))
+        {
+            localHostMap[routerName] = host;
+            localHosts.Add(host);
+        }
 
         NodeContainer hostRouter;
         hostRouter.Add(host);
@@ -725,7 +971,7 @@ main()
 
         Ipv6Address hostAddr = ifaces.GetAddress(0, 1);   // global address
         Ipv6Address routerAddr = ifaces.GetAddress(1, 1); // global address
-        ipv6ToHostName[hostAddr] = routerName;
+        (*ipv6ToHostName)[hostAddr] = routerName;
         hostAddressMap[routerName] = hostAddr;
 
         ifaces.SetForwarding(1, true);
@@ -734,44 +980,123 @@ main()
         std::cout << "Host " << routerName << " indirizzo: " << hostAddr
                   << ", router indirizzo: " << routerAddr << std::endl;
 
-        p2p.EnablePcap(routerName + "[HOST]", dev.Get(0), true);
-        p2p.EnablePcap(routerName + "[HOST]", dev.Get(1), true);
+        if (capture)
+        {
+            capture->Add(routerName + "[HOST]", dev.Get(0));
+            capture->Add(routerName + "[HOST]", dev.Get(1));
+        }
 
         subnetCount++;
     }
+    if (normalRouting == "static")
+    {
+        installShortestPathRoutes(*routers, topology, hostAddressMap);
+    }
+    endSetupPhase("hosts");
 
-    installUdpSinkOnAllHosts(hostMap, 9999, ipv6ToHostName);
+    // sink di latenza sugli host: id densi per gli host (solo i loro indirizzi,
+    // non le interfacce dei router) e backend delle misure
+    auto hostDirectory = std::make_shared<HostDirectory>();
+    for (const auto& [name, address] : hostAddressMap)
+    {
+        hostDirectory->Add(address, name);
+    }
 
-    createQRegisterForAllNodes(routerMap, nameToQRegister);
-    assignOutDevices(routerMap, nameToQRegister);
-    printQRegisters(nameToQRegister, routerMap);
+    ReceiverFlowStats flowStats;
+    std::vector<std::shared_ptr<LatencyMetricsBackend>> latencyBackends;
+    latencyBackends.push_back(std::make_shared<FlowStatsBackend>(flowStats, *hostDirectory));
 
-    for (const auto& link : links)
+    // latenze per pacchetto in formato binario, opzionale (--latencyLog):
+    // --convertLatencyLog per i CSV
+    LatencyLogWriter latencyLog;
+    if (!params.latencyLog.empty())
     {
-        auto key = std::make_pair(link.source, link.target);
-        auto it = linkToIfaces.find(key);
-        if (it == linkToIfaces.end())
+        if (latencyLog.Open(params.latencyLog))
+        {
+            latencyBackends.push_back(
+                std::make_shared<LatencyLogBackend>(latencyLog, *hostDirectory));
+        }
+        else
         {
-            std::cerr << "Errore: ifaces non trovati per " << link.source << " → " << link.target
-                      << std::endl;
-            continue;
+            std::cerr << "Errore: impossibile aprire " << params.latencyLog << std::endl;
         }
+    }
+
+    if (capture && params.captureRing > 0)
+    {
+        latencyBackends.push_back(
+            std::make_shared<CaptureTriggerBackend>(*capture,
+                                                    params.captureTriggerClass,
+                                                    Seconds(params.captureTriggerMs / 1e3)));
+    }
+
+    // scomposizione per salto della latenza delay-sensitive (--hopRecords)
+    std::shared_ptr<HopDelayStats> hopStats;
+    if (params.hopRecords)
+    {
+        hopStats = std::make_shared<HopDelayStats>(nodeIds, TrafficTypeHeader::DELAY_SENSITIVE);
+        latencyBackends.push_back(hopStats);
+    }
 
-        const auto& ifaces = it->second;
+    // percorsi seguiti dal traffico delay-sensitive (--pathTracing)
+    std::shared_ptr<PathStats> pathStats;
+    if (params.pathTracing)
+    {
+        pathStats = std::make_shared<PathStats>(nodeIds,
+                                                dags,
+                                                *hostDirectory,
+                                                TrafficTypeHeader::DELAY_SENSITIVE);
+        latencyBackends.push_back(pathStats);
+    }
+
+    installUdpSinkOnAllHosts(localHostMap,
+                             9999,
+                             hostDirectory,
+                             latencyBackends,
+                             params.hopRecords,
+                             params.pathTracing);
+
+    createQRegisterForAllNodes(*routers, *dags);
+    assignOutDevices(*routers);
+    if (!params.qWarmStart.empty())
+    {
+        loadQCheckpoints(*routers, nodeIds, SplitList(params.qWarmStart));
+    }
+    if (params.qCheckpointTime > 0)
+    {
+        Simulator::Schedule(Seconds(params.qCheckpointTime),
+                            &saveQCheckpoint,
+                            routers,
+                            nodeIds,
+                            params.qCheckpointFile);
+    }
+    if (params.printQRegisters)
+    {
+        printQRegisters(*routers);
+    }
+    endSetupPhase("routing");
 
-        installBidirectionalQueueStatusSenders(ifaces.GetAddress(0, 1),
-                                               ifaces.GetAddress(1, 1),
-                                               routerMap[link.source],
-                                               routerMap[link.target],
+    for (const auto& link : links)
+    {
+        const RouterTable::Adjacency* adjacency = routers->GetAdjacency(link.source, link.target);
+        installBidirectionalQueueStatusSenders(*routers,
+                                               adjacency->localAddress,
+                                               adjacency->peerAddress,
+                                               routers->Get(link.source),
+                                               routers->Get(link.target),
                                                link.source,
                                                link.target,
-                                               nameToQRegister[link.source],
-                                               nameToQRegister[link.target],
-                                               returnIndexOfNode(nodeIds, link.source),
-                                               returnIndexOfNode(nodeIds, link.target));
+                                               routers->GetQRegister(link.source),
+                                               routers->GetQRegister(link.target),
+                                               routers->GetIndex(link.source),
+                                               routers->GetIndex(link.target),
+                                               Seconds(params.exchangeInterval),
+                                               Seconds(params.exchangeStart),
+                                               Seconds(params.stopTime),
+                                               dags);
     }
 
-    for (const auto& [name, node] : routerMap)
+    for (const auto& [name, node] : localRouterMap)
     {
         Ptr<Ipv6> ipv6 = node->GetObject<Ipv6>();
         Ptr<Ipv6RoutingProtocol> proto = ipv6->GetRoutingProtocol();
@@ -785,69 +1110,285 @@ main()
                 Ptr<QRoutingProtocol> qproto = DynamicCast<QRoutingProtocol>(subProto);
                 if (qproto)
                 {
-                    qproto->SetAddressToNameMap(ipv6ToHostName);
-                    qproto->SetQRegister(nameToQRegister[name]);
-                    qproto->SetHostMap(hostMap);
+                    qproto->SetQRegister(routers->GetQRegister(name));
+                    qproto->SetHopRecording(params.hopRecords);
+                    qproto->SetPathTracing(params.pathTracing);
                 }
             }
         }
     }
 
     // installo i receiver per ottenere e far salvare le info sulle code
-    installReceiverExchangeStateAppOnAllNodes(routerMap, nameToQRegister);
+    installReceiverExchangeStateAppOnAllNodes(*routers, Seconds(params.stopTime));
 
     // set della disciplina delle code
     TrafficControlHelper tch;
     tch.Uninstall(allDevices);
     // tch.Uninstall(allHostsDevs);
     uint16_t handle =
-        tch.SetRootQueueDisc("ns3::PfifoFastQueueDisc", "MaxSize", StringValue("500000p"));
-    tch.AddInternalQueues(handle, 3, "ns3::DropTailQueue", "MaxSize", StringValue("500000p"));
+        tch.SetRootQueueDisc(params.queueDisc, "MaxSize", StringValue(params.queueMaxSize));
+    if (params.queueDisc == "ns3::PfifoFastQueueDisc")
+    {
+        tch.AddInternalQueues(handle,
+                              3,
+                              "ns3::DropTailQueue",
+                              "MaxSize",
+                              StringValue(params.queueMaxSize));
+    }
     QueueDiscContainer qdiscs = tch.Install(allDevices);
 
-    queueLengthCsv.open("queue_lengths.csv", std::ios::out);
-    if (!queueLengthCsv.is_open())
+    if (params.hopRecords)
     {
-        std::cerr << "Errore: impossibile aprire queue_lengths.csv\n";
+        for (const auto& [name, router] : localRouterMap)
+        {
+            TraceHopDequeue(router);
+        }
     }
-    else
+
+    // occupazione delle code guidata dalle trace delle QueueDisc
+    QueueMonitor queueMonitor;
+    for (uint32_t i = 0; i < allDevices.GetN(); ++i)
     {
-        // Intestazione: Time, NodeName, DeviceIndex, QueueLength
-        queueLengthCsv << "Time,NodeName,DeviceIndex,QueueLength\n";
+        const std::string& name = routers->GetName(allDevices.Get(i)->GetNode());
+        if (partition->IsLocal(name))
+        {
+            queueMonitor.Add(qdiscs.Get(i), name, i);
+        }
+    }
+    std::ofstream queueLengthCsv;
+    if (params.queueChangeLog)
+    {
+        queueLengthCsv.open("queue_lengths.csv", std::ios::out);
+        if (!queueLengthCsv.is_open())
+        {
+            std::cerr << "Errore: impossibile aprire queue_lengths.csv\n";
+        }
+        else
+        {
+            queueMonitor.SetChangeLog(&queueLengthCsv);
+        }
     }
-
-    Simulator::Schedule(Seconds(0.0), &RecordQueueLengths, routerMap, allDevices, qdiscs, 0.5);
 
     // installo le app onoff per generare traffico
-    auto allDemands = LoadAllMatrices();
-    installUdpSinkOnAllRouters(routerMap, 9999);
+    // matrici da file, quelle compilate di Abilene o casuali per le topologie generate
+    std::vector<std::vector<FlowDemand>> allDemands;
+    if (!params.demandFiles.empty())
+    {
+        allDemands =
+            LoadSndlibDemandMatrices(SplitList(params.demandFiles), params.demandUnitScale);
+    }
+    else if (params.topology == "abilene")
+    {
+        allDemands = LoadAllMatrices();
+    }
+    else
+    {
+        allDemands = GenerateDemandMatrices(topology, params);
+    }
+    validateDemands(allDemands, hostMap, params);
+    installUdpSinkOnAllRouters(localRouterMap, 9999, Seconds(params.stopTime));
 
     /*installOnOffApplicationV6(allDemands[0],
                               hostMap,
                               hostAddressMap,
-                              0.248); // uso solo la prima demand*/
+                              0.248,
+                              Seconds(params.trafficStart),
+                              Seconds(params.trafficStop)); // uso solo la prima demand*/
 
-    installOnOffApplicationForLatencyAnalysis(allDemands[1],
-                                              hostMap,
+    // statistiche FlowMonitor per classe di traffico (--flowMonitor)
+    std::unique_ptr<FlowClassMonitor> flowMonitor;
+    if (params.flowMonitor)
+    {
+        flowMonitor = std::make_unique<FlowClassMonitor>(hostDirectory);
+        flowMonitor->Install(localHosts);
+        flowMonitor->SetTcpPort(params.tcpPort, TrafficTypeHeader::DELAY_SENSITIVE);
+    }
+
+    installOnOffApplicationForLatencyAnalysis(allDemands[params.normalMatrix],
+                                              localHostMap,
                                               hostAddressMap,
-                                              0.248, // scala i valori di traffico
-                                              20.0,   // start time
-                                              80.0,   // stop time
-                                              0      // tipo di traffico: normale
-    );
-
-    installOnOffApplicationForLatencyAnalysis(allDemands[0],
-                                              hostMap,
+                                              params.normalScale * params.loadFactor,
+                                              params.trafficStart,
+                                              params.trafficStop,
+                                              0, // tipo di traffico: normale
+                                              params.packetSize,
+                                              flowMonitor.get());
+
+    installOnOffApplicationForLatencyAnalysis(allDemands[params.sensitiveMatrix],
+                                              localHostMap,
                                               hostAddressMap,
-                                              0.023, // scala i valori di traffico
-                                              20.0,  // start time
-                                              80.0,  // stop time
-                                              1     // tipo di traffico: delay sensitiva
-                                            );
+                                              params.sensitiveScale * params.loadFactor,
+                                              params.trafficStart,
+                                              params.trafficStop,
+                                              1, // tipo di traffico: delay sensitiva
+                                              params.packetSize,
+                                              flowMonitor.get());
+
+    // carico TCP delay-sensitive, instradato da QRoutingProtocol
+    auto tcpStats = std::make_shared<TcpFlowStats>();
+    if (params.tcpMode != "none")
+    {
+        installTcpWorkload(allDemands[params.sensitiveMatrix],
+                           localHostMap,
+                           hostAddressMap,
+                           params,
+                           params.trafficStart,
+                           params.trafficStop,
+                           tcpStats);
+    }
+
+    // percentili di latenza per intervallo, dall'inizio del traffico
+    std::ofstream intervalPercentilesCsv;
+    if (params.histogramInterval > 0)
+    {
+        intervalPercentilesCsv.open("latency_percentiles_interval.csv");
+        ReceiverFlowStats::WritePercentileHeader(intervalPercentilesCsv);
+        Simulator::Schedule(Seconds(params.trafficStart + params.histogramInterval),
+                            &writeIntervalPercentiles,
+                            &flowStats,
+                            &intervalPercentilesCsv,
+                            params.histogramInterval);
+    }
+
+    // terminazione anticipata quando l'obiettivo di servizio è già superato
+    bool aborted = false;
+    if (params.earlyStopFactor > 0)
+    {
+        Simulator::Schedule(Seconds(params.trafficStart + 1.0),
+                            &checkEarlyStop,
+                            &flowStats,
+                            &params,
+                            &aborted);
+    }
+
+    // avanzamento periodico in JSON, limitato in tempo reale
+    std::unique_ptr<ProgressReporter> progress;
+    if (params.progressInterval > 0)
+    {
+        progress = std::make_unique<ProgressReporter>(
+            std::cout,
+            queueMonitor,
+            flowStats,
+            std::vector<uint8_t>{TrafficTypeHeader::NORMAL, TrafficTypeHeader::DELAY_SENSITIVE});
+        progress->Start(Seconds(params.progressInterval), params.progressWallInterval);
+    }
 
-    Simulator::Stop(Seconds(140.0));
+    // costo della topologia: dimensione dei Q-register locali e tempo di set-up
+    RunSummary scaling;
+    uint64_t qRegisterActions = 0;
+    for (const auto& [name, qRegister] : routers->GetQRegisters())
+    {
+        for (const auto& row : *qRegister)
+        {
+            qRegisterActions += row.size();
+        }
+    }
+    endSetupPhase("apps");
+    double setupSeconds =
+        std::chrono::duration<double>(std::chrono::steady_clock::now() - setupStart).count();
+    std::cout << "[TOPOLOGY] azioni_qregister=" << qRegisterActions
+              << " setup_s=" << setupSeconds;
+    for (const auto& [phase, seconds] : setupPhases)
+    {
+        std::cout << " " << phase << "_s=" << seconds;
+        scaling.Set("setup_" + phase + "_s", seconds);
+    }
+    std::cout << std::endl;
+    scaling.Set("topology_nodes", nodeIds.size());
+    scaling.Set("topology_links", links.size());
+    scaling.Set("qregister_actions", qRegisterActions);
+    scaling.Set("setup_wall_s", setupSeconds);
+
+    // benchmark di avvio (--setupOnly): nessun evento viene eseguito
+    if (params.setupOnly)
+    {
+        if (!params.summaryFile.empty() && !scaling.Write(params.summaryFile))
+        {
+            std::cerr << "Errore: impossibile scrivere " << params.summaryFile << std::endl;
+        }
+        Simulator::Destroy();
+        return 0;
+    }
+
+    auto runStart = std::chrono::steady_clock::now();
+    Simulator::Stop(Seconds(params.stopTime));
     Simulator::Run();
+    scaling.Set("run_wall_s",
+                std::chrono::duration<double>(std::chrono::steady_clock::now() - runStart)
+                    .count());
+
+    if (progress)
+    {
+        progress->Finish();
+    }
+
+    latencyLog.Close();
+    queueMonitor.Finish();
+    std::ofstream queueStatsCsv("queue_stats.csv");
+    queueMonitor.WriteSummary(queueStatsCsv);
+
+    // perdita, riordino e jitter per flusso e per classe di traffico
+    std::ofstream flowStatsCsv("flow_rx_stats.csv");
+    flowStats.WriteFlowCsv(flowStatsCsv);
+    flowStats.WriteClassSummary(std::cout);
+    std::cout << "[CONTROL] packets=" << QueueStatusApp::GetTotalPacketsSent()
+              << " bytes=" << QueueStatusApp::GetTotalBytesSent() << std::endl;
+
+    std::ofstream percentilesCsv("latency_percentiles.csv");
+    ReceiverFlowStats::WritePercentileHeader(percentilesCsv);
+    flowStats.WritePercentiles(percentilesCsv, Simulator::Now().GetSeconds(), false);
+
+    if (!tcpStats->GetFlows().empty())
+    {
+        std::ofstream tcpStatsCsv("tcp_flow_stats.csv");
+        tcpStats->WriteFlowCsv(tcpStatsCsv);
+        tcpStats->WriteSummary(std::cout);
+    }
+
+    if (hopStats)
+    {
+        std::ofstream hopStatsCsv("hop_delay_stats.csv");
+        hopStats->WriteCsv(hopStatsCsv);
+        hopStats->WriteSummary(std::cout);
+    }
+
+    if (pathStats)
+    {
+        std::ofstream pathCsv("path_stats.csv");
+        pathStats->WritePathCsv(pathCsv);
+        std::ofstream pairCsv("path_changes.csv");
+        pathStats->WritePairCsv(pairCsv);
+        pathStats->WriteSummary(std::cout);
+    }
+
+    if (capture)
+    {
+        std::cout << "[CAPTURE] pacchetti scritti=" << capture->GetWrittenPackets()
+                  << " trigger=" << capture->GetTriggerCount() << std::endl;
+    }
+
+    if (flowMonitor)
+    {
+        std::ofstream flowMonitorCsv("flow_monitor_stats.csv");
+        flowMonitor->WriteFlowCsv(flowMonitorCsv);
+        flowMonitor->WriteClassSummary(std::cout);
+    }
+
+    if (!params.summaryFile.empty())
+    {
+        writeRunSummary(params.summaryFile, scaling, flowStats, params, aborted);
+    }
+
+    // tabella dei contatori di profilazione (solo con -DQSE_ENABLE_PROFILING)
+    QSE_PROFILE_REPORT(std::cout);
+
     Simulator::Destroy();
+#ifdef NS3_MPI
+    if (params.mpi)
+    {
+        MpiInterface::Disable();
+    }
+#endif
 
     return 0;
 }
\ No newline at end of file
@@ -0,0 +1,174 @@
+#include "packet_capture.h"
+
+#include "ns3/callback.h"
+#include "ns3/node.h"
+#include "ns3/simulator.h"
+#include "ns3/trace-helper.h"
+
+#include <algorithm>
+#include <sstream>
+
+using namespace ns3;
+
+PacketCapture::PacketCapture(const CaptureOptions& options)
+    : m_options(options)
+{
+    m_options.sampleEvery = std::max<uint32_t>(m_options.sampleEvery, 1);
+}
+
+bool
+PacketCapture::IsSelected(const std::string& linkName) const
+{
+    if (m_options.links.empty() || m_options.links.count(linkName))
+    {
+        return true;
+    }
+    size_t dash = linkName.find('-');
+    return dash != std::string::npos &&
+           m_options.links.count(linkName.substr(dash + 1) + "-" + linkName.substr(0, dash));
+}
+
+void
+PacketCapture::Add(const std::string& linkName, Ptr<NetDevice> device)
+{
+    if (!IsSelected(linkName))
+    {
+        return;
+    }
+
+    std::ostringstream filename;
+    filename << linkName << "-" << device->GetNode()->GetId() << "-" << device->GetIfIndex()
+             << ".pcap";
+
+    DeviceCapture d;
+    d.filename = filename.str();
+    size_t index = m_devices.size();
+    m_devices.push_back(d);
+
+    device->TraceConnectWithoutContext("PromiscSniffer",
+                                       MakeCallback(&PacketCapture::Sniff, this).Bind(index));
+}
+
+void
+PacketCapture::Sniff(size_t index, Ptr<const Packet> packet)
+{
+    Time now = Simulator::Now();
+    double t = now.GetSeconds();
+    if (t < m_options.windowStart || (m_options.windowStop > 0 && t >= m_options.windowStop))
+    {
+        return;
+    }
+
+    DeviceCapture& d = m_devices[index];
+    if (d.seen++ % m_options.sampleEvery != 0)
+    {
+        return;
+    }
+
+    if (m_options.ringSize == 0 || d.postTrigger > 0)
+    {
+        if (d.postTrigger > 0)
+        {
+            d.postTrigger--;
+        }
+        Write(d, now, packet);
+        return;
+    }
+
+    // nel ring si tiene solo la parte che verrebbe scritta, così la memoria
+    // non dipende dalla dimensione dei pacchetti
+    uint32_t kept = std::min(packet->GetSize(), m_options.snaplen);
+    RingEntry entry{now, packet->GetSize(), std::vector<uint8_t>(kept)};
+    packet->CopyData(entry.data.data(), kept);
+    d.ring.push_back(std::move(entry));
+    if (d.ring.size() > m_options.ringSize)
+    {
+        d.ring.pop_front();
+    }
+}
+
+void
+PacketCapture::Open(DeviceCapture& d)
+{
+    if (!d.file)
+    {
+        PcapHelper helper;
+        d.file =
+            helper.CreateFile(d.filename, std::ios::out, PcapHelper::DLT_PPP, m_options.snaplen);
+    }
+}
+
+void
+PacketCapture::Write(DeviceCapture& d, Time time, Ptr<const Packet> packet)
+{
+    Open(d);
+    d.file->Write(time, packet);
+    m_written++;
+}
+
+void
+PacketCapture::Write(DeviceCapture& d, const RingEntry& entry)
+{
+    Open(d);
+    // con la dimensione originale come lunghezza il file ne registra
+    // min(originale, snaplen) byte, cioè esattamente quelli conservati
+    d.file->Write(entry.time, entry.data.data(), entry.originalSize);
+    m_written++;
+}
+
+void
+PacketCapture::Trigger()
+{
+    // un dispositivo ancora nella finestra post-trigger la completa senza
+    // riaprirla: i campioni oltre soglia successivi non la allungano
+    bool armed = false;
+    for (auto& d : m_devices)
+    {
+        if (d.postTrigger > 0)
+        {
+            continue;
+        }
+        for (const auto& entry : d.ring)
+        {
+            Write(d, entry);
+        }
+        d.ring.clear();
+        d.postTrigger = m_options.ringSize;
+        armed = true;
+    }
+    if (armed)
+    {
+        m_triggers++;
+    }
+}
+
+uint64_t
+PacketCapture::GetTriggerCount() const
+{
+    return m_triggers;
+}
+
+uint64_t
+PacketCapture::GetWrittenPackets() const
+{
+    return m_written;
+}
+
+CaptureTriggerBackend::CaptureTriggerBackend(PacketCapture& capture,
+                                             uint8_t trafficType,
+                                             Time threshold)
+    : m_capture(capture),
+      m_trafficType(trafficType),
+      m_threshold(threshold)
+{
+}
+
+void
+CaptureTriggerBackend::OnPacket(const LatencySample& sample)
+{
+    if (sample.trafficType == m_trafficType &&
+        sample.receiveTime - sample.sendTime > m_threshold)
+    {
+        m_capture.Trigger();
+    }
+}
@@ -0,0 +1,96 @@
+#ifndef PACKET_CAPTURE_H
+#define PACKET_CAPTURE_H
+
+#include "latency_metrics.h"
+
+#include "ns3/net-device.h"
+#include "ns3/nstime.h"
+#include "ns3/packet.h"
+#include "ns3/pcap-file-wrapper.h"
+#include "ns3/ptr.h"
+
+#include <cstdint>
+#include <deque>
+#include <set>
+#include <string>
+#include <utility>
+#include <vector>
+
+struct CaptureOptions
+{
+    std::set<std::string> links; // nomi dei link da catturare, vuoto = tutti
+    uint32_t snaplen{96};        // byte registrati per pacchetto
+    uint32_t sampleEvery{1};     // 1 pacchetto ogni N per dispositivo
+    double windowStart{0.0};     // secondi
+    double windowStop{0.0};      // secondi, 0 = fino alla fine
+    // se > 0 i pacchetti restano in un ring buffer di questa dimensione per
+    // dispositivo e finiscono su disco solo attorno a un Trigger(): il
+    // contenuto del ring e i ringSize pacchetti successivi
+    uint32_t ringSize{0};
+};
+
+// Cattura selettiva in formato PCAP (PPP) dalla trace PromiscSniffer dei
+// PointToPointNetDevice, con troncamento, campionamento, finestra temporale
+// e ring buffer. I file sono creati solo quando c'è qualcosa da scrivere.
+class PacketCapture
+{
+  public:
+    explicit PacketCapture(const CaptureOptions& options);
+
+    // un link "A-B" è selezionato anche come "B-A"
+    bool IsSelected(const std::string& linkName) const;
+    // cattura il dispositivo se il link è selezionato (file <link>-<nodo>-<dev>.pcap)
+    void Add(const std::string& linkName, ns3::Ptr<ns3::NetDevice> device);
+
+    // scarica i ring buffer e apre la finestra post-trigger; ignorato dai
+    // dispositivi la cui finestra precedente non è ancora finita
+    void Trigger();
+
+    uint64_t GetTriggerCount() const;
+    uint64_t GetWrittenPackets() const;
+
+  private:
+    // pacchetto nel ring: solo i byte che verranno scritti, ma con la
+    // dimensione originale per l'orig_len del record PCAP
+    struct RingEntry
+    {
+        ns3::Time time;
+        uint32_t originalSize;
+        std::vector<uint8_t> data;
+    };
+
+    struct DeviceCapture
+    {
+        std::string filename;
+        ns3::Ptr<ns3::PcapFileWrapper> file;
+        uint64_t seen{0};
+        uint32_t postTrigger{0}; // pacchetti ancora da scrivere dopo un trigger
+        std::deque<RingEntry> ring;
+    };
+
+    void Sniff(size_t index, ns3::Ptr<const ns3::Packet> packet);
+    void Open(DeviceCapture& d);
+    void Write(DeviceCapture& d, ns3::Time time, ns3::Ptr<const ns3::Packet> packet);
+    void Write(DeviceCapture& d, const RingEntry& entry);
+
+    CaptureOptions m_options;
+    std::vector<DeviceCapture> m_devices;
+    uint64_t m_triggers{0};
+    uint64_t m_written{0};
+};
+
+// trigger della cattura quando la latenza di un pacchetto della classe
+// indicata supera la soglia
+class CaptureTriggerBackend : public LatencyMetricsBackend
+{
+  public:
+    CaptureTriggerBackend(PacketCapture& capture, uint8_t trafficType, ns3::Time threshold);
+    void OnPacket(const LatencySample& sample) override;
+
+  private:
+    PacketCapture& m_capture;
+    uint8_t m_trafficType;
+    ns3::Time m_threshold;
+};
+
+#endif // PACKET_CAPTURE_H
@@ -0,0 +1,179 @@
+#include "packet_size_distribution.h"
+
+#include "simulation_parameters.h"
+
+#include "ns3/abort.h"
+#include "ns3/double.h"
+#include "ns3/seq-ts-size-header.h"
+
+#include <algorithm>
+#include <exception>
+#include <iostream>
+#include <map>
+#include <utility>
+#include <vector>
+
+using namespace ns3;
+
+namespace
+{
+
+// oltre questa dimensione il pacchetto (+1 byte di TrafficTypeHeader, UDP e
+// IPv6) supera la MTU di 1500 byte dei collegamenti e viene frammentato
+const uint32_t kMaxUnfragmentedSize = 1500 - 40 - 8 - 1;
+
+const char* kImix = "64:7,576:4,1400:1";
+
+// il payload deve contenere il SeqTsSizeHeader abilitato sulle app OnOff
+uint32_t
+MinSize()
+{
+    return SeqTsSizeHeader().GetSerializedSize();
+}
+
+uint32_t
+ParseSize(const std::string& text, const std::string& spec)
+{
+    size_t used = 0;
+    unsigned long value = 0;
+    try
+    {
+        value = std::stoul(text, &used);
+    }
+    catch (const std::exception&)
+    {
+        used = 0;
+    }
+    NS_ABORT_MSG_IF(used == 0 || used != text.size() || value > 65000,
+                    "Dimensione di pacchetto non valida '" << text << "' in '" << spec << "'");
+    NS_ABORT_MSG_IF(value < MinSize(),
+                    "Dimensione di pacchetto '" << text << "' in '" << spec
+                                                << "' minore del SeqTsSizeHeader ("
+                                                << MinSize() << " byte)");
+    return static_cast<uint32_t>(value);
+}
+
+// estremi di "uniform:MIN:MAX"
+std::pair<uint32_t, uint32_t>
+ParseUniform(const std::string& spec)
+{
+    size_t colon = spec.find(':', 8);
+    NS_ABORT_MSG_IF(colon == std::string::npos, "Atteso uniform:MIN:MAX, trovato " << spec);
+    uint32_t minSize = ParseSize(spec.substr(8, colon - 8), spec);
+    uint32_t maxSize = ParseSize(spec.substr(colon + 1), spec);
+    NS_ABORT_MSG_IF(minSize > maxSize, "uniform:MIN:MAX richiede MIN <= MAX");
+    return {minSize, maxSize};
+}
+
+// coppie (dimensione, peso) della forma discreta, in ordine di dimensione
+// crescente (la CDF di EmpiricalRandomVariable deve essere monotona) e con
+// i pesi delle dimensioni ripetute sommati
+std::vector<std::pair<uint32_t, double>>
+ParseWeightedSizes(const std::string& spec)
+{
+    std::map<uint32_t, double> sizes;
+    for (const auto& item : SplitList(spec))
+    {
+        size_t colon = item.find(':');
+        NS_ABORT_MSG_IF(colon == std::string::npos,
+                        "Atteso DIMENSIONE:PESO, trovato '" << item << "'");
+        double weight = 0;
+        try
+        {
+            weight = std::stod(item.substr(colon + 1));
+        }
+        catch (const std::exception&)
+        {
+            weight = -1;
+        }
+        NS_ABORT_MSG_IF(weight <= 0, "Peso non valido in '" << item << "'");
+        sizes[ParseSize(item.substr(0, colon), spec)] += weight;
+    }
+    NS_ABORT_MSG_IF(sizes.empty(), "Distribuzione di dimensioni vuota");
+    return {sizes.begin(), sizes.end()};
+}
+
+void
+WarnIfFragmented(uint32_t maxSize, const std::string& spec)
+{
+    if (maxSize > kMaxUnfragmentedSize)
+    {
+        std::cout << "[PKTSIZE] attenzione: con '" << spec << "' i pacchetti oltre "
+                  << kMaxUnfragmentedSize << " byte verranno frammentati" << std::endl;
+    }
+}
+
+} // namespace
+
+Ptr<RandomVariableStream>
+CreatePacketSizeDistribution(const std::string& spec)
+{
+    if (spec == "imix")
+    {
+        return CreatePacketSizeDistribution(kImix);
+    }
+
+    if (spec.rfind("uniform:", 0) == 0)
+    {
+        auto [minSize, maxSize] = ParseUniform(spec);
+        WarnIfFragmented(maxSize, spec);
+
+        // l'applicazione arrotonda all'intero più vicino e Max è escluso:
+        // allargando di mezzo byte per parte anche gli estremi hanno la stessa probabilità
+        Ptr<UniformRandomVariable> rv = CreateObject<UniformRandomVariable>();
+        rv->SetAttribute("Min", DoubleValue(minSize - 0.5));
+        rv->SetAttribute("Max", DoubleValue(maxSize + 0.5));
+        return rv;
+    }
+
+    if (spec.find(':') == std::string::npos)
+    {
+        uint32_t size = ParseSize(spec, spec);
+        WarnIfFragmented(size, spec);
+        Ptr<ConstantRandomVariable> rv = CreateObject<ConstantRandomVariable>();
+        rv->SetAttribute("Constant", DoubleValue(size));
+        return rv;
+    }
+
+    auto sizes = ParseWeightedSizes(spec);
+    double totalWeight = 0;
+    uint32_t maxSize = 0;
+    for (const auto& [size, weight] : sizes)
+    {
+        totalWeight += weight;
+        maxSize = std::max(maxSize, size);
+    }
+    WarnIfFragmented(maxSize, spec);
+
+    // CDF a gradini: senza interpolazione restituisce solo le dimensioni date
+    Ptr<EmpiricalRandomVariable> rv = CreateObject<EmpiricalRandomVariable>();
+    rv->SetInterpolate(false);
+    double cumulative = 0;
+    for (size_t i = 0; i < sizes.size(); ++i)
+    {
+        cumulative += sizes[i].second;
+        rv->CDF(sizes[i].first, i + 1 == sizes.size() ? 1.0 : cumulative / totalWeight);
+    }
+    return rv;
+}
+
+void
+ValidatePacketSizeSpec(const std::string& spec)
+{
+    if (spec == "imix")
+    {
+        return;
+    }
+    if (spec.rfind("uniform:", 0) == 0)
+    {
+        ParseUniform(spec);
+    }
+    else if (spec.find(':') == std::string::npos)
+    {
+        ParseSize(spec, spec);
+    }
+    else
+    {
+        ParseWeightedSizes(spec);
+    }
+}
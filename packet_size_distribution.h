@@ -0,0 +1,22 @@
+#ifndef PACKET_SIZE_DISTRIBUTION_H
+#define PACKET_SIZE_DISTRIBUTION_H
+
+#include "ns3/ptr.h"
+#include "ns3/random-variable-stream.h"
+
+#include <string>
+
+// Distribuzione delle dimensioni dei pacchetti UDP (payload applicativo, in
+// byte) a partire da una descrizione testuale:
+//   "1000"               dimensione fissa
+//   "imix"               IMIX semplice 7:4:1 di 64, 576 e 1400 byte
+//   "uniform:512:1400"   uniforme sugli interi tra i due estremi
+//   "64:7,576:4,1400:1"  dimensioni discrete con pesi relativi
+// Ogni dimensione deve contenere almeno il SeqTsSizeHeader che le applicazioni
+// OnOff aggiungono ai pacchetti. Termina con errore se la descrizione non è valida.
+ns3::Ptr<ns3::RandomVariableStream> CreatePacketSizeDistribution(const std::string& spec);
+
+// solo il controllo della descrizione, per ValidateParameters
+void ValidatePacketSizeSpec(const std::string& spec);
+
+#endif // PACKET_SIZE_DISTRIBUTION_H
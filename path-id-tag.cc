@@ -0,0 +1,133 @@
+#include "path-id-tag.h"
+
+#include "ns3/abort.h"
+
+#include <algorithm>
+#include <limits>
+
+namespace ns3
+{
+
+namespace
+{
+
+constexpr uint64_t kFnvOffset = 14695981039346656037ULL;
+constexpr uint64_t kFnvPrime = 1099511628211ULL;
+
+uint64_t
+FnvMix(uint64_t hash, uint64_t value, int bytes)
+{
+    for (int b = 0; b < bytes; ++b)
+    {
+        hash ^= (value >> (8 * b)) & 0xff;
+        hash *= kFnvPrime;
+    }
+    return hash;
+}
+
+} // namespace
+
+NS_OBJECT_ENSURE_REGISTERED(PathIdTag);
+
+TypeId
+PathIdTag::GetTypeId()
+{
+    static TypeId tid = TypeId("ns3::PathIdTag").SetParent<Tag>().AddConstructor<PathIdTag>();
+    return tid;
+}
+
+TypeId
+PathIdTag::GetInstanceTypeId() const
+{
+    return GetTypeId();
+}
+
+uint32_t
+PathIdTag::GetSerializedSize() const
+{
+    return 8 + 1 + 1;
+}
+
+void
+PathIdTag::Serialize(TagBuffer i) const
+{
+    i.WriteU64(m_id);
+    i.WriteU8(m_hops);
+    i.WriteU8(m_hashed ? 1 : 0);
+}
+
+void
+PathIdTag::Deserialize(TagBuffer i)
+{
+    m_id = i.ReadU64();
+    m_hops = i.ReadU8();
+    m_hashed = i.ReadU8() != 0;
+}
+
+void
+PathIdTag::Print(std::ostream& os) const
+{
+    os << "path=" << m_id << " hops=" << static_cast<int>(m_hops)
+       << (m_hashed ? " hashed" : "");
+}
+
+void
+PathIdTag::AddHop(uint16_t node, uint16_t radix)
+{
+    NS_ABORT_MSG_IF(node + 1 >= radix, "PathIdTag: indice di nodo fuori dalla base");
+    uint64_t digit = node + 1;
+
+    if (!m_hashed && m_id > (std::numeric_limits<uint64_t>::max() - digit) / radix)
+    {
+        // l'id esatto traboccherebbe: da qui in poi è un hash
+        m_id = FnvMix(kFnvOffset, m_id, 8);
+        m_hashed = true;
+    }
+
+    if (m_hashed)
+    {
+        m_id = FnvMix(m_id, digit, 2);
+    }
+    else
+    {
+        m_id = m_id * radix + digit;
+    }
+    m_hops = static_cast<uint8_t>(std::min<int>(m_hops + 1, std::numeric_limits<uint8_t>::max()));
+}
+
+uint64_t
+PathIdTag::GetId() const
+{
+    return m_id;
+}
+
+uint8_t
+PathIdTag::GetHopCount() const
+{
+    return m_hops;
+}
+
+bool
+PathIdTag::IsHashed() const
+{
+    return m_hashed;
+}
+
+std::vector<uint16_t>
+PathIdTag::Decode(uint64_t id, uint16_t radix)
+{
+    std::vector<uint16_t> nodes;
+    while (id != 0)
+    {
+        if (id % radix == 0)
+        {
+            return {}; // non è un id prodotto da AddHop
+        }
+        nodes.push_back(static_cast<uint16_t>(id % radix - 1));
+        id /= radix;
+    }
+    std::reverse(nodes.begin(), nodes.end());
+    return nodes;
+}
+
+} // namespace ns3
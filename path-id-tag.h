@@ -0,0 +1,47 @@
+#ifndef PATH_ID_TAG_H
+#define PATH_ID_TAG_H
+
+#include "ns3/tag.h"
+
+#include <cstdint>
+#include <vector>
+
+namespace ns3
+{
+
+// Identificativo compatto del percorso seguito da un pacchetto instradato da
+// QRoutingProtocol. Ogni router aggiunge il proprio indice come cifra in base
+// (numero di nodi + 1), riservando lo 0 così che percorsi di lunghezza diversa
+// non collidano: finché l'id sta in 64 bit il percorso si ricostruisce
+// esattamente al sink. Se un nuovo salto farebbe traboccare l'id, si passa a un
+// hash FNV-1a dell'id corrente e dei salti successivi (IsHashed), che
+// distingue ancora i percorsi ma non permette di decodificarli.
+class PathIdTag : public Tag
+{
+  public:
+    static TypeId GetTypeId();
+    TypeId GetInstanceTypeId() const override;
+    uint32_t GetSerializedSize() const override;
+    void Serialize(TagBuffer i) const override;
+    void Deserialize(TagBuffer i) override;
+    void Print(std::ostream& os) const override;
+
+    // node < radix - 1, radix uguale in tutti i router
+    void AddHop(uint16_t node, uint16_t radix);
+
+    uint64_t GetId() const;
+    uint8_t GetHopCount() const;
+    bool IsHashed() const;
+
+    // indici dei router nell'ordine di attraversamento; vuoto se l'id è un hash
+    static std::vector<uint16_t> Decode(uint64_t id, uint16_t radix);
+
+  private:
+    uint64_t m_id{0};
+    uint8_t m_hops{0};
+    bool m_hashed{false};
+};
+
+} // namespace ns3
+
+#endif // PATH_ID_TAG_H
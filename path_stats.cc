@@ -0,0 +1,176 @@
+#include "path_stats.h"
+
+#include "path-id-tag.h"
+
+#include <algorithm>
+#include <iomanip>
+#include <sstream>
+
+using namespace ns3;
+
+PathStats::PathStats(const std::vector<std::string>& nodeNames,
+                     std::shared_ptr<const DagSet> dags,
+                     const HostDirectory& hosts,
+                     uint8_t trafficType)
+    : m_nodeNames(nodeNames),
+      m_dags(dags),
+      m_hosts(hosts),
+      m_trafficType(trafficType)
+{
+}
+
+void
+PathStats::OnPacket(const LatencySample& sample)
+{
+    if (!sample.path || sample.trafficType != m_trafficType)
+    {
+        return;
+    }
+
+    PathKey key{sample.path->GetId(), sample.path->IsHashed()};
+    PairState& state = m_pairs[{sample.srcHost, sample.dstHost}];
+
+    PathEntry& entry = state.paths[key];
+    entry.packets++;
+    entry.latencySumNs += (sample.receiveTime - sample.sendTime).GetNanoSeconds();
+    entry.hops = sample.path->GetHopCount();
+
+    if (state.hasLast && key != state.last)
+    {
+        state.changes++;
+        if (state.hasPrevious && key == state.previous)
+        {
+            state.flaps++;
+        }
+        state.previous = state.last;
+        state.hasPrevious = true;
+    }
+    state.last = key;
+    state.hasLast = true;
+    state.packets++;
+}
+
+std::string
+PathStats::PathName(const PathKey& key) const
+{
+    std::ostringstream name;
+    if (key.second)
+    {
+        name << "hash:" << std::hex << key.first;
+        return name.str();
+    }
+    auto nodes = PathIdTag::Decode(key.first, static_cast<uint16_t>(m_nodeNames.size() + 1));
+    for (size_t i = 0; i < nodes.size(); ++i)
+    {
+        name << (i ? ">" : "")
+             << (nodes[i] < m_nodeNames.size() ? m_nodeNames[nodes[i]]
+                                                : std::to_string(nodes[i]));
+    }
+    return name.str();
+}
+
+std::string
+PathStats::InDag(const PathKey& key, uint16_t dstHost) const
+{
+    if (key.second)
+    {
+        return "?";
+    }
+    auto nodes = PathIdTag::Decode(key.first, static_cast<uint16_t>(m_nodeNames.size() + 1));
+    auto dst = std::find(m_nodeNames.begin(), m_nodeNames.end(), m_hosts.GetName(dstHost));
+    size_t dagIndex = dst - m_nodeNames.begin();
+    if (nodes.empty() || dagIndex >= m_dags->GetNNodes())
+    {
+        return "?";
+    }
+
+    // ogni salto deve essere un'azione ammessa dal DAG, l'ultimo router consegna al sink
+    for (size_t i = 0; i + 1 < nodes.size(); ++i)
+    {
+        if (nodes[i] >= m_dags->GetNNodes() || nodes[i + 1] >= m_dags->GetNNodes() ||
+            !m_dags->IsSuccessor(dagIndex, nodes[i], nodes[i + 1]))
+        {
+            return "0";
+        }
+    }
+    return nodes.back() == dagIndex ? "1" : "0";
+}
+
+const PathStats::PathEntry&
+PathStats::Dominant(const PairState& state) const
+{
+    auto it = std::max_element(
+        state.paths.begin(),
+        state.paths.end(),
+        [](const auto& a, const auto& b) { return a.second.packets < b.second.packets; });
+    return it->second;
+}
+
+void
+PathStats::WritePathCsv(std::ostream& os) const
+{
+    os << "src_node,dst_node,path,hops,in_dag,packets,share,mean_latency_ms\n";
+    os << std::fixed << std::setprecision(6);
+
+    for (const auto& [pair, state] : m_pairs)
+    {
+        for (const auto& [key, entry] : state.paths)
+        {
+            os << m_hosts.GetName(pair.first) << "," << m_hosts.GetName(pair.second) << ","
+               << PathName(key) << "," << static_cast<int>(entry.hops) << ","
+               << InDag(key, pair.second) << "," << entry.packets << ","
+               << static_cast<double>(entry.packets) / state.packets << ","
+               << entry.latencySumNs / entry.packets * 1e-6 << "\n";
+        }
+    }
+}
+
+void
+PathStats::WritePairCsv(std::ostream& os) const
+{
+    os << "src_node,dst_node,packets,paths,dominant_share,changes,change_rate,flaps\n";
+    os << std::fixed << std::setprecision(6);
+
+    for (const auto& [pair, state] : m_pairs)
+    {
+        os << m_hosts.GetName(pair.first) << "," << m_hosts.GetName(pair.second) << ","
+           << state.packets << "," << state.paths.size() << ","
+           << static_cast<double>(Dominant(state).packets) / state.packets << ","
+           << state.changes << "," << static_cast<double>(state.changes) / state.packets << ","
+           << state.flaps << "\n";
+    }
+}
+
+void
+PathStats::WriteSummary(std::ostream& os) const
+{
+    uint64_t packets = 0;
+    uint64_t dominantPackets = 0;
+    uint64_t outsideDag = 0;
+    uint64_t changes = 0;
+    uint64_t flaps = 0;
+    size_t paths = 0;
+    size_t multipathPairs = 0;
+    for (const auto& [pair, state] : m_pairs)
+    {
+        packets += state.packets;
+        dominantPackets += Dominant(state).packets;
+        changes += state.changes;
+        flaps += state.flaps;
+        paths += state.paths.size();
+        multipathPairs += state.paths.size() > 1 ? 1 : 0;
+        for (const auto& [key, entry] : state.paths)
+        {
+            outsideDag += InDag(key, pair.second) == "0" ? entry.packets : 0;
+        }
+    }
+
+    os << std::fixed << std::setprecision(4);
+    os << "[PATHSTATS] coppie=" << m_pairs.size() << " multipercorso=" << multipathPairs
+       << " percorsi_medi=" << (m_pairs.empty() ? 0.0 : static_cast<double>(paths) / m_pairs.size())
+       << " quota_dominante="
+       << (packets ? static_cast<double>(dominantPackets) / packets : 0.0)
+       << " cambi=" << changes << " flap=" << flaps
+       << " quota_flap=" << (changes ? static_cast<double>(flaps) / changes : 0.0)
+       << " pacchetti_fuori_dag=" << outsideDag << "\n";
+}
@@ -0,0 +1,75 @@
+#ifndef PATH_STATS_H
+#define PATH_STATS_H
+
+#include "dag_builder.h"
+#include "latency_metrics.h"
+
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <ostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+// Distribuzione dei percorsi seguiti dai pacchetti con PathIdTag, per coppia
+// (host sorgente, host destinazione): pacchetti e latenza media per percorso,
+// e se il percorso rispetta il DAG della destinazione usato dal Q-routing.
+// Per capire se Q-routing usa davvero i percorsi alternativi o oscilla, si
+// contano i cambi di percorso tra pacchetti consecutivi e, tra questi, i
+// ritorni al percorso usato prima dell'ultimo cambio (flap A -> B -> A).
+class PathStats : public LatencyMetricsBackend
+{
+  public:
+    // nodeNames: nomi dei router nell'ordine degli indici usati nel tag,
+    // dags: un DAG per destinazione nello stesso ordine
+    PathStats(const std::vector<std::string>& nodeNames,
+              std::shared_ptr<const DagSet> dags,
+              const HostDirectory& hosts,
+              uint8_t trafficType);
+
+    void OnPacket(const LatencySample& sample) override;
+
+    // una riga per (src, dst, percorso)
+    void WritePathCsv(std::ostream& os) const;
+    // una riga per (src, dst) con cambi di percorso e flap
+    void WritePairCsv(std::ostream& os) const;
+    // aggregato su tutte le coppie ([PATHSTATS])
+    void WriteSummary(std::ostream& os) const;
+
+  private:
+    // (id, hash): un id esatto e un hash con lo stesso valore sono percorsi diversi
+    using PathKey = std::pair<uint64_t, bool>;
+
+    struct PathEntry
+    {
+        uint64_t packets{0};
+        double latencySumNs{0.0};
+        uint8_t hops{0};
+    };
+
+    struct PairState
+    {
+        std::map<PathKey, PathEntry> paths;
+        uint64_t packets{0};
+        uint64_t changes{0};
+        uint64_t flaps{0};
+        bool hasLast{false};
+        bool hasPrevious{false};
+        PathKey last;
+        PathKey previous; // percorso usato prima di last
+    };
+
+    std::string PathName(const PathKey& key) const;
+    // "1" se rispetta il DAG di dst, "0" se no, "?" se l'id non è decodificabile
+    std::string InDag(const PathKey& key, uint16_t dstHost) const;
+    const PathEntry& Dominant(const PairState& state) const;
+
+    std::vector<std::string> m_nodeNames;
+    std::shared_ptr<const DagSet> m_dags;
+    const HostDirectory& m_hosts;
+    uint8_t m_trafficType;
+    std::map<std::pair<uint16_t, uint16_t>, PairState> m_pairs;
+};
+
+#endif // PATH_STATS_H
@@ -0,0 +1,238 @@
+#include "process_runner.h"
+
+#include "ns3/abort.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <filesystem>
+#include <iostream>
+#include <map>
+#include <sys/wait.h>
+#include <thread>
+#include <unistd.h>
+
+std::string
+CurrentExecutable()
+{
+    std::error_code ec;
+    std::filesystem::path exe = std::filesystem::read_symlink("/proc/self/exe", ec);
+    return ec ? std::string() : exe.string();
+}
+
+std::vector<std::string>
+ForwardedArguments(int argc, char* argv[], const std::set<std::string>& drop)
+{
+    std::vector<std::string> args;
+    for (int i = 1; i < argc; ++i)
+    {
+        std::string arg = argv[i];
+        std::string name = arg;
+        while (!name.empty() && name.front() == '-')
+        {
+            name.erase(name.begin());
+        }
+        name = name.substr(0, name.find('='));
+        if (drop.find(name) == drop.end())
+        {
+            args.push_back(arg);
+        }
+    }
+    return args;
+}
+
+std::string
+AbsolutePath(const std::string& path)
+{
+    std::error_code ec;
+    std::filesystem::path abs = std::filesystem::absolute(path, ec);
+    return ec ? path : abs.lexically_normal().string();
+}
+
+std::string
+AbsolutePathList(const std::vector<std::string>& paths)
+{
+    std::string list;
+    for (const auto& path : paths)
+    {
+        list += (list.empty() ? "" : ",") + AbsolutePath(path);
+    }
+    return list;
+}
+
+const std::set<std::string>&
+ChildInputOptions()
+{
+    static const std::set<std::string> options{"demandFiles", "topologyFile", "qWarmStart"};
+    return options;
+}
+
+std::vector<std::string>
+ChildInputArguments(const SimulationParameters& params)
+{
+    std::vector<std::string> args;
+    if (!params.demandFiles.empty())
+    {
+        args.push_back("--demandFiles=" + AbsolutePathList(SplitList(params.demandFiles)));
+    }
+    if (!params.topologyFile.empty())
+    {
+        args.push_back("--topologyFile=" + AbsolutePath(params.topologyFile));
+    }
+    if (!params.qWarmStart.empty())
+    {
+        args.push_back("--qWarmStart=" + AbsolutePathList(SplitList(params.qWarmStart)));
+    }
+    return args;
+}
+
+pid_t
+LaunchChild(const std::vector<std::string>& args,
+            const std::string& workDir,
+            const std::string& logFile)
+{
+    if (args.empty())
+    {
+        return -1;
+    }
+
+    std::error_code ec;
+    std::filesystem::create_directories(workDir, ec);
+    if (ec)
+    {
+        std::cerr << "[RUNNER] impossibile creare " << workDir << ": " << ec.message()
+                  << std::endl;
+        return -1;
+    }
+
+    std::vector<char*> argv;
+    argv.reserve(args.size() + 1);
+    for (const auto& a : args)
+    {
+        argv.push_back(const_cast<char*>(a.c_str()));
+    }
+    argv.push_back(nullptr);
+
+    std::cout.flush();
+    std::cerr.flush();
+
+    pid_t pid = fork();
+    if (pid < 0)
+    {
+        std::cerr << "[RUNNER] fork fallita: " << std::strerror(errno) << std::endl;
+        return -1;
+    }
+
+    if (pid == 0)
+    {
+        // processo figlio: solo chiamate async-signal-safe fino a execv
+        if (chdir(workDir.c_str()) != 0)
+        {
+            _exit(126);
+        }
+        int fd = open(logFile.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+        if (fd >= 0)
+        {
+            dup2(fd, STDOUT_FILENO);
+            dup2(fd, STDERR_FILENO);
+            close(fd);
+        }
+        execv(argv[0], argv.data());
+        _exit(127);
+    }
+
+    return pid;
+}
+
+int
+WaitChild(pid_t pid)
+{
+    int status = 0;
+    while (waitpid(pid, &status, 0) < 0)
+    {
+        if (errno != EINTR)
+        {
+            return -1;
+        }
+    }
+    return WIFEXITED(status) ? WEXITSTATUS(status) : -1;
+}
+
+pid_t
+WaitAnyChild(int& exitStatus)
+{
+    int status = 0;
+    pid_t pid;
+    while ((pid = waitpid(-1, &status, 0)) < 0)
+    {
+        if (errno != EINTR)
+        {
+            return -1;
+        }
+    }
+    exitStatus = WIFEXITED(status) ? WEXITSTATUS(status) : -1;
+    return pid;
+}
+
+int
+RunChild(const std::vector<std::string>& args,
+         const std::string& workDir,
+         const std::string& logFile)
+{
+    pid_t pid = LaunchChild(args, workDir, logFile);
+    return pid < 0 ? -1 : WaitChild(pid);
+}
+
+uint32_t
+ParallelJobs(uint32_t jobs)
+{
+    return std::max<uint32_t>(jobs > 0 ? jobs : std::thread::hardware_concurrency(), 1);
+}
+
+size_t
+RunChildPool(size_t count,
+             uint32_t jobs,
+             const std::function<pid_t(size_t)>& launch,
+             const std::function<bool(size_t, int)>& onExit)
+{
+    std::map<pid_t, size_t> running;
+    size_t next = 0;
+    bool launching = true;
+    while (!running.empty() || (launching && next < count))
+    {
+        while (launching && running.size() < jobs && next < count)
+        {
+            size_t index = next++;
+            pid_t pid = launch(index);
+            if (pid < 0)
+            {
+                launching = onExit(index, -1);
+            }
+            else
+            {
+                running[pid] = index;
+            }
+        }
+
+        if (running.empty())
+        {
+            continue;
+        }
+        int exitStatus = -1;
+        pid_t pid = WaitAnyChild(exitStatus);
+        auto it = running.find(pid);
+        if (it == running.end())
+        {
+            NS_ABORT_MSG_IF(pid < 0, "nessun figlio da attendere");
+            continue; // figlio non lanciato da questo gruppo
+        }
+        size_t index = it->second;
+        running.erase(it);
+        if (!onExit(index, exitStatus))
+        {
+            launching = false;
+        }
+    }
+    return next;
+}
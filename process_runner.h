@@ -0,0 +1,68 @@
+#ifndef PROCESS_RUNNER_H
+#define PROCESS_RUNNER_H
+
+#include "simulation_parameters.h"
+
+#include <cstdint>
+#include <functional>
+#include <set>
+#include <string>
+#include <sys/types.h>
+#include <vector>
+
+// Avvio di simulazioni figlie: lo stesso eseguibile viene rilanciato con
+// argomenti diversi, in una propria directory di lavoro (i file di output
+// relativi finiscono lì) e con stdout/stderr rediretti su un file di log.
+
+// percorso dell'eseguibile in esecuzione
+std::string CurrentExecutable();
+
+// argomenti della riga di comando corrente, senza argv[0] e senza le opzioni
+// il cui nome è in drop (es. "searchScale" elimina --searchScale e --searchScale=...)
+std::vector<std::string> ForwardedArguments(int argc,
+                                            char* argv[],
+                                            const std::set<std::string>& drop);
+
+// percorso assoluto (se path è relativo lo risolve rispetto alla directory corrente)
+std::string AbsolutePath(const std::string& path);
+// percorsi resi assoluti e uniti con virgole (per le opzioni che accettano liste)
+std::string AbsolutePathList(const std::vector<std::string>& paths);
+
+// opzioni con percorsi di file in ingresso (demandFiles, topologyFile, qWarmStart):
+// i figli girano in un'altra directory, quindi vanno tolte da ForwardedArguments
+// e passate con ChildInputArguments
+const std::set<std::string>& ChildInputOptions();
+// le opzioni di ChildInputOptions impostate in params, con i percorsi assoluti
+std::vector<std::string> ChildInputArguments(const SimulationParameters& params);
+
+// crea workDir se necessario e avvia il figlio (logFile, se relativo, è
+// risolto dentro workDir); restituisce il pid, -1 in caso di errore
+pid_t LaunchChild(const std::vector<std::string>& args,
+                  const std::string& workDir,
+                  const std::string& logFile);
+
+// attende il figlio e restituisce il suo exit status (-1 se terminato da un segnale)
+int WaitChild(pid_t pid);
+// attende un figlio qualsiasi: restituisce il pid (-1 se non ce ne sono) e
+// scrive in exitStatus il suo exit status come WaitChild
+pid_t WaitAnyChild(int& exitStatus);
+
+// LaunchChild + WaitChild
+int RunChild(const std::vector<std::string>& args,
+             const std::string& workDir,
+             const std::string& logFile);
+
+// figli in parallelo: jobs, o i core disponibili se 0 (almeno uno)
+uint32_t ParallelJobs(uint32_t jobs);
+
+// esegue count job con al più jobs figli alla volta: launch(i) avvia il job i
+// e restituisce il pid (-1 se l'avvio fallisce), onExit(i, exitStatus) riceve
+// l'esito di ogni job, anche di quelli non avviati (exitStatus -1). Se onExit
+// restituisce false non si avviano altri job, ma quelli in corso vengono
+// attesi. Restituisce il numero di job avviati o falliti all'avvio.
+size_t RunChildPool(size_t count,
+                    uint32_t jobs,
+                    const std::function<pid_t(size_t)>& launch,
+                    const std::function<bool(size_t, int)>& onExit);
+
+#endif // PROCESS_RUNNER_H
@@ -0,0 +1,52 @@
+#ifndef PROGRESS_REPORTER_H
+#define PROGRESS_REPORTER_H
+
+#include "queue_monitor.h"
+#include "receiver_flow_stats.h"
+
+#include "ns3/nstime.h"
+
+#include <chrono>
+#include <cstdint>
+#include <ostream>
+#include <vector>
+
+// Avanzamento delle simulazioni lunghe: ogni interval di tempo simulato si
+// controlla quanto tempo reale è passato dall'ultimo report e, se almeno
+// minWallSeconds, si scrive una riga JSON con tempo simulato, speed-up,
+// eventi al secondo, picco di RSS, occupazione delle code e pacchetti
+// consegnati per classe. Il controllo costa un evento per intervallo, quindi
+// l'intervallo simulato può essere piccolo senza inondare l'output.
+class ProgressReporter
+{
+  public:
+    ProgressReporter(std::ostream& os,
+                     const QueueMonitor& queues,
+                     const ReceiverFlowStats& flowStats,
+                     const std::vector<uint8_t>& trafficClasses);
+
+    // programma il primo controllo; da chiamare prima di Simulator::Run
+    void Start(ns3::Time interval, double minWallSeconds);
+    // ultimo report a fine simulazione, senza limite di tempo reale
+    void Finish();
+
+  private:
+    using Clock = std::chrono::steady_clock;
+
+    void Check();
+    void Report(bool final);
+
+    std::ostream& m_os;
+    const QueueMonitor& m_queues;
+    const ReceiverFlowStats& m_flowStats;
+    std::vector<uint8_t> m_classes;
+
+    ns3::Time m_interval;
+    double m_minWallSeconds{0.0};
+    Clock::time_point m_wallStart;
+    Clock::time_point m_lastWall;
+    double m_lastSimSeconds{0.0};
+    uint64_t m_lastEvents{0};
+};
+
+#endif // PROGRESS_REPORTER_H
@@ -0,0 +1,207 @@
+#include "qregister_checkpoint.h"
+
+#include <cstdio>
+#include <cstring>
+#include <limits>
+#include <unordered_map>
+
+namespace
+{
+
+const char kMagic[4] = {'Q', 'R', 'E', 'G'};
+const uint32_t kVersion = 1;
+const uint32_t kSink = std::numeric_limits<uint32_t>::max();
+
+bool
+WriteString(std::FILE* file, const std::string& s)
+{
+    uint16_t length = static_cast<uint16_t>(s.size());
+    return std::fwrite(&length, sizeof(length), 1, file) == 1 &&
+           std::fwrite(s.data(), 1, length, file) == length;
+}
+
+bool
+ReadString(std::FILE* file, std::string& s)
+{
+    uint16_t length = 0;
+    if (std::fread(&length, sizeof(length), 1, file) != 1)
+    {
+        return false;
+    }
+    s.resize(length);
+    return std::fread(&s[0], 1, length, file) == length;
+}
+
+bool
+WriteU32(std::FILE* file, uint32_t value)
+{
+    return std::fwrite(&value, sizeof(value), 1, file) == 1;
+}
+
+bool
+ReadU32(std::FILE* file, uint32_t& value)
+{
+    return std::fread(&value, sizeof(value), 1, file) == 1;
+}
+
+} // namespace
+
+bool
+WriteQRegisterCheckpoint(const std::string& path,
+                         const std::vector<std::string>& nodeNames,
+                         const std::map<std::string, std::shared_ptr<QRegister>>& qRegisters,
+                         int64_t timeNs,
+                         std::string& error)
+{
+    std::unordered_map<std::string, uint32_t> index;
+    for (uint32_t i = 0; i < nodeNames.size(); ++i)
+    {
+        index[nodeNames[i]] = i;
+    }
+
+    // file temporaneo rinominato alla fine: un salvataggio interrotto non
+    // lascia un checkpoint troncato al posto di quello precedente
+    std::string tmpPath = path + ".tmp";
+    std::FILE* out = std::fopen(tmpPath.c_str(), "wb");
+    if (!out)
+    {
+        error = "impossibile creare " + tmpPath;
+        return false;
+    }
+
+    CheckpointHeader header{};
+    std::memcpy(header.magic, kMagic, sizeof(header.magic));
+    header.version = kVersion;
+    header.timeNs = timeNs;
+    header.nodeNames = nodeNames.size();
+    header.routers = qRegisters.size();
+    bool ok = std::fwrite(&header, sizeof(header), 1, out) == 1;
+    for (const auto& name : nodeNames)
+    {
+        ok = ok && WriteString(out, name);
+    }
+
+    for (const auto& [name, qRegister] : qRegisters)
+    {
+        auto node = index.find(name);
+        if (node == index.end())
+        {
+            error = "router " + name + " assente dalla topologia";
+            ok = false;
+            break;
+        }
+        ok = ok && WriteU32(out, node->second) && WriteU32(out, qRegister->size());
+        for (const auto& row : *qRegister)
+        {
+            ok = ok && WriteU32(out, row.size());
+            for (const auto& action : row)
+            {
+                auto next = index.find(action.idNodeDestination);
+                uint32_t nextIndex = next == index.end() ? kSink : next->second;
+                ok = ok && WriteU32(out, nextIndex) && WriteU32(out, action.q_value);
+            }
+        }
+    }
+
+    ok = std::fclose(out) == 0 && ok;
+    if (!ok || std::rename(tmpPath.c_str(), path.c_str()) != 0)
+    {
+        std::remove(tmpPath.c_str());
+        error = error.empty() ? "scrittura di " + path + " fallita" : error;
+        return false;
+    }
+    return true;
+}
+
+bool
+LoadQRegisterCheckpoint(const std::string& path,
+                        const std::vector<std::string>& nodeNames,
+                        const std::map<std::string, std::shared_ptr<QRegister>>& qRegisters,
+                        std::set<std::string>& restored,
+                        std::string& error)
+{
+    std::FILE* in = std::fopen(path.c_str(), "rb");
+    if (!in)
+    {
+        error = "impossibile aprire " + path;
+        return false;
+    }
+
+    CheckpointHeader header{};
+    bool valid = std::fread(&header, sizeof(header), 1, in) == 1 &&
+                 std::memcmp(header.magic, kMagic, sizeof(header.magic)) == 0 &&
+                 header.version == kVersion && header.nodeNames == nodeNames.size();
+    for (uint32_t i = 0; valid && i < header.nodeNames; ++i)
+    {
+        std::string name;
+        valid = ReadString(in, name) && name == nodeNames[i];
+    }
+    if (!valid)
+    {
+        std::fclose(in);
+        error = path + " non è un checkpoint dei Q-register di questa topologia";
+        return false;
+    }
+
+    auto fail = [&](const std::string& message) {
+        std::fclose(in);
+        error = path + ": " + message;
+        return false;
+    };
+    for (uint32_t r = 0; r < header.routers; ++r)
+    {
+        uint32_t nodeIndex = 0;
+        uint32_t rows = 0;
+        if (!ReadU32(in, nodeIndex) || !ReadU32(in, rows) || nodeIndex >= nodeNames.size())
+        {
+            return fail("file troncato o danneggiato");
+        }
+        const std::string& name = nodeNames[nodeIndex];
+        auto it = qRegisters.find(name);
+        // router remoto: i suoi dati vanno comunque letti per passare al successivo
+        QRegister* qRegister = it == qRegisters.end() ? nullptr : it->second.get();
+        if (qRegister && (rows != qRegister->size() || !restored.insert(name).second))
+        {
+            return fail("Q-register di " + name + " diverso o già caricato");
+        }
+
+        for (uint32_t row = 0; row < rows; ++row)
+        {
+            uint32_t actions = 0;
+            if (!ReadU32(in, actions))
+            {
+                return fail("file troncato o danneggiato");
+            }
+            if (qRegister && actions != (*qRegister)[row].size())
+            {
+                return fail("DAG diversi per " + name + " verso " + nodeNames[row]);
+            }
+            for (uint32_t a = 0; a < actions; ++a)
+            {
+                uint32_t nextIndex = 0;
+                uint32_t q = 0;
+                if (!ReadU32(in, nextIndex) || !ReadU32(in, q))
+                {
+                    return fail("file troncato o danneggiato");
+                }
+                if (!qRegister)
+                {
+                    continue;
+                }
+                // le azioni di una riga sono nell'ordine dei DAG, lo stesso del salvataggio
+                Action& action = (*qRegister)[row][a];
+                bool same = nextIndex == kSink
+                                ? action.idNodeDestination == "sink"
+                                : nextIndex < nodeNames.size() &&
+                                      action.idNodeDestination == nodeNames[nextIndex];
+                if (!same)
+                {
+                    return fail("DAG diversi per " + name + " verso " + nodeNames[row]);
+                }
+                action.q_value = q;
+            }
+        }
+    }
+    std::fclose(in);
+    return true;
+}
@@ -0,0 +1,52 @@
+#ifndef QREGISTER_CHECKPOINT_H
+#define QREGISTER_CHECKPOINT_H
+
+#include "router_table.h"
+
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <set>
+#include <string>
+#include <vector>
+
+// Checkpoint binario dei Q-register, per ripartire da uno stato già
+// convergente invece di rifare ogni volta il riscaldamento.
+//
+// Layout (endianness della macchina che l'ha scritto):
+//   CheckpointHeader | tabella dei nomi | un blocco per router
+// La tabella contiene tutti i router della topologia (lunghezza u16 e
+// caratteri); ogni blocco è indice del router (u32), numero di righe (u32) e
+// per riga numero di azioni (u32) seguito da coppie (indice del vicino, q),
+// con UINT32_MAX al posto del vicino per il sink. Righe e azioni sono quelle
+// dei DAG: un checkpoint vale solo per la stessa topologia e gli stessi DAG.
+//
+// Gli scambi dello stato non hanno numeri di sequenza né altro stato oltre
+// ai Q-register, che sono quindi tutto ciò che serve salvare.
+struct CheckpointHeader
+{
+    char magic[4]; // "QREG"
+    uint32_t version;
+    int64_t timeNs; // istante simulato del salvataggio
+    uint32_t nodeNames;
+    uint32_t routers; // blocchi presenti (con MPI solo i router del rank)
+};
+
+// scrive i Q-register indicati; nodeNames è l'ordine dei router nei DAG
+bool WriteQRegisterCheckpoint(const std::string& path,
+                              const std::vector<std::string>& nodeNames,
+                              const std::map<std::string, std::shared_ptr<QRegister>>& qRegisters,
+                              int64_t timeNs,
+                              std::string& error);
+
+// copia i q del checkpoint nei Q-register presenti in qRegisters (i router
+// remoti sono ignorati) e aggiunge i loro nomi a restored. Fallisce se la
+// topologia o i DAG sono diversi o se un router è già in restored (più
+// checkpoint, ad esempio uno per rank MPI, possono essere caricati insieme).
+bool LoadQRegisterCheckpoint(const std::string& path,
+                             const std::vector<std::string>& nodeNames,
+                             const std::map<std::string, std::shared_ptr<QRegister>>& qRegisters,
+                             std::set<std::string>& restored,
+                             std::string& error);
+
+#endif // QREGISTER_CHECKPOINT_H
@@ -9,8 +9,6 @@ namespace ns3
 NS_LOG_COMPONENT_DEFINE("QRoutingHelper");
 
 QRoutingHelper::QRoutingHelper()
-    : m_nodeMap(nullptr),
-      m_nameToQRegister(nullptr)
 {
 }
 
@@ -19,15 +17,10 @@ QRoutingHelper::~QRoutingHelper()
 }
 
 QRoutingHelper::QRoutingHelper(
-    std::map<std::string, Ptr<Node>>* nodeMap,
-    std::map<std::string, std::shared_ptr<std::vector<std::vector<Action>>>>* nameToQRegister,
-    const std::vector<std::string>& nodeIds,
-    const std::map<Ipv6Address, std::string>& ipv6ToHostName,
-    std::map<std::string, Ptr<Node>>* hostMap)
-    : m_nodeMap(nodeMap),
-      m_nameToQRegister(nameToQRegister),
-      m_nodeIds(nodeIds),
-      m_addrToName(ipv6ToHostName) // ✅ assegnamento diretto
+    std::shared_ptr<const RouterTable> routers,
+    std::shared_ptr<const std::map<Ipv6Address, std::string>> ipv6ToHostName)
+    : m_routers(routers),
+      m_addrToName(ipv6ToHostName)
 {
 }
 
@@ -38,44 +31,24 @@ QRoutingHelper::Create(Ptr<Node> node) const
     Ptr<QRoutingProtocol> proto = CreateObject<QRoutingProtocol>();
     proto->SetIpv6(node->GetObject<Ipv6>());
 
-    // ricava il nome del nodo (cerco nella mappa m_nodeMap per capire quale nome corrisponde a
-    // questo Ptr<Node>)
-    if (m_nodeMap)
-    {
-        for (const auto& entry : *m_nodeMap)
-        {
-            if (entry.second == node)
-            {
-                std::string nodeName = entry.first;
-                proto->SetNodeName(nodeName);
-                break;
-            }
-        }
-    }
-
-    proto->SetNodeIdList(m_nodeIds);
+    proto->SetRouters(m_routers);
 
-    // assegna il q_register relativo a questo node, se presente
-    if (m_nameToQRegister)
+    // nome del nodo e q_register relativo, se presente (solo per i router locali)
+    if (m_routers)
     {
-        if (m_nodeMap)
+        const std::string& nodeName = m_routers->GetName(node);
+        if (!nodeName.empty())
         {
-            for (const auto& entry : *m_nodeMap)
+            proto->SetNodeName(nodeName);
+            auto qRegister = m_routers->GetQRegister(nodeName);
+            if (qRegister)
             {
-                if (entry.second == node)
-                {
-                    auto it = m_nameToQRegister->find(entry.first);
-                    if (it != m_nameToQRegister->end())
-                    {
-                        proto->SetQRegister(it->second);
-                    }
-                    break;
-                }
+                proto->SetQRegister(qRegister);
             }
         }
     }
 
-    // assegna mappa addr->name
+    // mappa addr->name condivisa da tutte le istanze
     proto->SetAddressToNameMap(m_addrToName);
 
     return proto;
@@ -86,11 +59,8 @@ QRoutingHelper::Copy() const
 {
     // ritorna un helper identico (non profondo)
     QRoutingHelper* helper = new QRoutingHelper();
-    helper->m_nodeMap = m_nodeMap;
-    helper->m_nameToQRegister = m_nameToQRegister;
-    helper->m_nodeIds = m_nodeIds;
+    helper->m_routers = m_routers;
     helper->m_addrToName = m_addrToName;
-    helper->m_hostMap = m_hostMap;
     return helper;
 }
 
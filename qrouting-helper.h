@@ -3,6 +3,7 @@
 
 #include "action.h"
 #include "qrouting-protocol.h"
+#include "router_table.h"
 
 #include "ns3/ipv6-routing-helper.h"
 #include "ns3/ipv6.h"
@@ -23,24 +24,18 @@ class QRoutingHelper : public Ipv6RoutingHelper
     virtual ~QRoutingHelper();
 
     // Costruttore alternativo per passare le strutture dal main
-    QRoutingHelper(
-        std::map<std::string, Ptr<Node>>* nodeMap,
-        std::map<std::string, std::shared_ptr<std::vector<std::vector<Action>>>>* nameToQRegister,
-        const std::vector<std::string>& nodeIds,
-        const std::map<Ipv6Address, std::string>& ipv6ToHostName,
-        std::map<std::string, Ptr<Node>>* hostMap);
+    // la tabella indirizzo -> nome è condivisa, non copiata: il main la
+    // completa dopo l'installazione dello stack e prima di simulare
+    QRoutingHelper(std::shared_ptr<const RouterTable> routers,
+                   std::shared_ptr<const std::map<Ipv6Address, std::string>> ipv6ToHostName);
     // Ipv6RoutingHelper API
     virtual Ptr<Ipv6RoutingProtocol> Create(Ptr<Node> node) const override;
     virtual Ipv6RoutingHelper* Copy() const override;
 
   private:
-    // Punteri alle strutture originarie; non vengono copiate per efficienza (il helper vive nel
-    // main)
-    std::map<std::string, Ptr<Node>>* m_nodeMap;
-    std::map<std::string, std::shared_ptr<std::vector<std::vector<Action>>>>* m_nameToQRegister;
-    std::vector<std::string> m_nodeIds;
-    std::map<Ipv6Address, std::string> m_addrToName;
-    std::map<std::string, Ptr<Node>>* m_hostMap;
+    // router e Q-register condivisi con il main (e con le copie dell'helper)
+    std::shared_ptr<const RouterTable> m_routers;
+    std::shared_ptr<const std::map<Ipv6Address, std::string>> m_addrToName;
 };
 
 } // namespace ns3
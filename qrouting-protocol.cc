@@ -10,7 +10,11 @@
 #include "ns3/packet.h"
 #include "ns3/simulator.h"
 #include "ns3/socket.h"
+#include "ns3/tcp-l4-protocol.h"
 #include "ns3/udp-header.h"
+#include "hop-record-tag.h"
+#include "hot_path_profiler.h"
+#include "path-id-tag.h"
 #include "traffic-type-header.h"
 #include "ns3/seq-ts-size-header.h"
 
@@ -38,9 +42,9 @@ QRoutingProtocol::SetNodeName(const std::string& name)
 }
 
 void
-QRoutingProtocol::SetNodeIdList(const std::vector<std::string>& nodeIds)
+QRoutingProtocol::SetRouters(std::shared_ptr<const RouterTable> routers)
 {
-    m_nodeIds = nodeIds;
+    m_routers = routers;
 }
 
 void
@@ -50,28 +54,28 @@ QRoutingProtocol::SetQRegister(std::shared_ptr<std::vector<std::vector<Action>>>
 }
 
 void
-QRoutingProtocol::SetAddressToNameMap(const std::map<Ipv6Address, std::string>& addrToNameHost)
+QRoutingProtocol::SetAddressToNameMap(
+    std::shared_ptr<const std::map<Ipv6Address, std::string>> addrToNameHost)
 {
     m_addrToName = addrToNameHost;
 }
 
 void
-QRoutingProtocol::SetHostMap(const std::map<std::string, Ptr<Node>>& hostMap)
+QRoutingProtocol::SetHopRecording(bool enabled)
 {
-    m_hostMap = hostMap;
+    m_recordHops = enabled;
+}
+
+void
+QRoutingProtocol::SetPathTracing(bool enabled)
+{
+    m_tracePaths = enabled;
 }
 
 int
 QRoutingProtocol::IndexOfNodeNameInNodeIds(const std::string& name) const
 {
-    for (size_t i = 0; i < m_nodeIds.size(); ++i)
-    {
-        if (m_nodeIds[i] == name)
-        {
-            return static_cast<int>(i);
-        }
-    }
-    return -1;
+    return m_routers ? m_routers->GetIndex(name) : -1;
 }
 
 bool
@@ -145,38 +149,50 @@ QRoutingProtocol::RouteInput(Ptr<const Packet> p,
                              const LocalDeliverCallback& lcb,
                              const ErrorCallback& ecb)
 {
+    QSE_PROFILE_SCOPE(ROUTE_INPUT);
     // PrintInternalState();
     Ipv6Address dst = header.GetDestination();
     Ipv6Address src = header.GetSource();
 
-    Ptr<Packet> copy = p->Copy();
-
-    UdpHeader udp;
-    if (copy->PeekHeader(udp))
+    if (header.GetNextHeader() == TcpL4Protocol::PROT_NUMBER)
     {
-        copy->RemoveHeader(udp);
+        // i segmenti TCP portano la classe nel Traffic Class IPv6
+        if (header.GetTrafficClass() != TrafficTypeHeader::DELAY_SENSITIVE_TCLASS)
+        {
+            return false;
+        }
     }
+    else
+    {
+        Ptr<Packet> copy = p->Copy();
 
-    // --- PROVA prima a leggere direttamente il TrafficTypeHeader ---
-    TrafficTypeHeader tHeader;
+        UdpHeader udp;
+        if (copy->PeekHeader(udp))
+        {
+            copy->RemoveHeader(udp);
+        }
 
-    if (!copy->PeekHeader(tHeader))
-    {
-        // se fallisce, probabilmente c'è prima SeqTsSizeHeader
-        SeqTsSizeHeader seq;
-        if (copy->PeekHeader(seq))
+        // --- PROVA prima a leggere direttamente il TrafficTypeHeader ---
+        TrafficTypeHeader tHeader;
+
+        if (!copy->PeekHeader(tHeader))
         {
-            copy->RemoveHeader(seq);
-            copy->PeekHeader(tHeader);
+            // se fallisce, probabilmente c'è prima SeqTsSizeHeader
+            SeqTsSizeHeader seq;
+            if (copy->PeekHeader(seq))
+            {
+                copy->RemoveHeader(seq);
+                copy->PeekHeader(tHeader);
+            }
         }
-    }
 
-    if (copy->PeekHeader(tHeader))
-    {
-        if (tHeader.GetType() == TrafficTypeHeader::NORMAL)
+        if (copy->PeekHeader(tHeader))
         {
-            //std::cout << "[QROUTING] Pacchetto NORMAL -> passo a RIPng\n";
-            return false;
+            if (tHeader.GetType() == TrafficTypeHeader::NORMAL)
+            {
+                //std::cout << "[QROUTING] Pacchetto NORMAL -> passo a RIPng\n";
+                return false;
+            }
         }
     }
 
@@ -208,8 +224,14 @@ QRoutingProtocol::RouteInput(Ptr<const Packet> p,
     }
 
     // 2) Risolvi il nome del nodo di destinazione
-    auto it = m_addrToName.find(dst);
-    if (it == m_addrToName.end())
+    if (!m_addrToName)
+    {
+        if (!ecb.IsNull())
+            ecb(p, header, Socket::ERROR_NOROUTETOHOST);
+        return false;
+    }
+    auto it = m_addrToName->find(dst);
+    if (it == m_addrToName->end())
     {
         std::cout << "[ROUTEINPUT] WARNING INPUT: Destination address not found: " << dst
                   << std::endl;
@@ -264,7 +286,31 @@ QRoutingProtocol::RouteInput(Ptr<const Packet> p,
     }
 
     // 5) Chiama callback di forwarding unicast
-    if (!ucb.IsNull())
+    if (!ucb.IsNull() && (m_recordHops || m_tracePaths))
+    {
+        // i tag si aggiornano su una copia: p è const
+        Ptr<Packet> tagged = p->Copy();
+        uint16_t ownIndex = static_cast<uint16_t>(IndexOfNodeNameInNodeIds(m_nodeName));
+        if (m_recordHops)
+        {
+            HopRecordTag hops;
+            tagged->RemovePacketTag(hops);
+            int nextHop = IndexOfNodeNameInNodeIds(chosen.idNodeDestination);
+            hops.AddHop(ownIndex,
+                        nextHop < 0 ? HopRecordTag::kNoNode : static_cast<uint16_t>(nextHop),
+                        Simulator::Now());
+            tagged->AddPacketTag(hops);
+        }
+        if (m_tracePaths)
+        {
+            PathIdTag path;
+            tagged->RemovePacketTag(path);
+            path.AddHop(ownIndex, static_cast<uint16_t>(m_routers->GetN() + 1));
+            tagged->AddPacketTag(path);
+        }
+        ucb(idev, route, tagged, header);
+    }
+    else if (!ucb.IsNull())
     {
         ucb(idev, route, p, header);
     }
@@ -346,19 +392,23 @@ QRoutingProtocol::PrintInternalState() const
         std::cout << "IPv6 pointer is NULL." << std::endl;
     }
 
-    // m_nodeIds
-    std::cout << "Node IDs list (" << m_nodeIds.size() << "): ";
-    for (const auto& id : m_nodeIds)
+    // nomi dei router nell'ordine dei DAG
+    size_t nRouters = m_routers ? m_routers->GetN() : 0;
+    std::cout << "Node IDs list (" << nRouters << "): ";
+    for (uint32_t i = 0; i < nRouters; ++i)
     {
-        std::cout << id << " ";
+        std::cout << m_routers->GetName(i) << " ";
     }
     std::cout << std::endl;
 
     // m_addrToName
-    std::cout << "Address → Name map (" << m_addrToName.size() << " entries):" << std::endl;
-    for (const auto& [addr, name] : m_addrToName)
+    if (m_addrToName)
     {
-        std::cout << "  " << addr << " → " << name << std::endl;
+        std::cout << "Address → Name map (" << m_addrToName->size() << " entries):" << std::endl;
+        for (const auto& [addr, name] : *m_addrToName)
+        {
+            std::cout << "  " << addr << " → " << name << std::endl;
+        }
     }
 
     // m_qregister
@@ -367,8 +417,8 @@ QRoutingProtocol::PrintInternalState() const
         std::cout << "Q-table size: " << m_qregister->size() << " rows" << std::endl;
         for (size_t i = 0; i < m_qregister->size(); ++i)
         {
-            std::cout << "  Dest index " << i << " (" << (i < m_nodeIds.size() ? m_nodeIds[i] : "?")
-                      << "): ";
+            std::cout << "  Dest index " << i << " ("
+                      << (i < nRouters ? m_routers->GetName(i) : std::string("?")) << "): ";
             const auto& row = (*m_qregister)[i];
             for (size_t j = 0; j < row.size(); ++j)
             {
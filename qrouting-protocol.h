@@ -2,6 +2,7 @@
 #define QROUTING_PROTOCOL_H
 
 #include "action.h"
+#include "router_table.h"
 
 #include "ns3/ipv6-address.h"
 #include "ns3/ipv6-routing-protocol.h"
@@ -24,10 +25,16 @@ class QRoutingProtocol : public Ipv6RoutingProtocol
 
     // Inizializzazione del protocollo con riferimenti necessari
     void SetNodeName(const std::string& name);
-    void SetNodeIdList(const std::vector<std::string>& nodeIds);
+    // registro condiviso dei router: indice di un nome in O(1)
+    void SetRouters(std::shared_ptr<const RouterTable> routers);
     void SetQRegister(std::shared_ptr<std::vector<std::vector<Action>>> qreg);
-    void SetAddressToNameMap(const std::map<Ipv6Address, std::string>& addrToName);
-    void SetHostMap(const std::map<std::string, Ptr<Node>>& hostMap);
+    // tabelle costruite una volta nel main e condivise in sola lettura da
+    // tutte le istanze, invece di una copia per router
+    void SetAddressToNameMap(std::shared_ptr<const std::map<Ipv6Address, std::string>> addrToName);
+    // aggiunge un HopRecordTag ai pacchetti inoltrati
+    void SetHopRecording(bool enabled);
+    // aggiunge un PathIdTag ai pacchetti inoltrati
+    void SetPathTracing(bool enabled);
 
     // Interfaccia Ipv6RoutingProtocol
     virtual Ptr<Ipv6Route> RouteOutput(Ptr<Packet> p,
@@ -95,10 +102,11 @@ class QRoutingProtocol : public Ipv6RoutingProtocol
   private:
     Ptr<Ipv6> m_ipv6;
     std::string m_nodeName;
-    std::vector<std::string> m_nodeIds;
+    std::shared_ptr<const RouterTable> m_routers;
     std::shared_ptr<std::vector<std::vector<Action>>> m_qregister;
-    std::map<Ipv6Address, std::string> m_addrToName;
-    std::map<std::string, Ptr<Node>> m_hostMap;
+    std::shared_ptr<const std::map<Ipv6Address, std::string>> m_addrToName;
+    bool m_recordHops{false};
+    bool m_tracePaths{false};
 
     int IndexOfNodeNameInNodeIds(const std::string& name) const;
     bool FindMinActionForDestinationIndex(int destIndex, Action& outAction) const;
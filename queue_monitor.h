@@ -0,0 +1,63 @@
+#ifndef QUEUE_MONITOR_H
+#define QUEUE_MONITOR_H
+
+#include "ns3/nstime.h"
+#include "ns3/ptr.h"
+#include "ns3/queue-disc.h"
+
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <vector>
+
+// Occupazione delle code guidata dagli eventi: invece di campionare
+// periodicamente, si aggancia alle trace PacketsInQueue e BytesInQueue di
+// ogni QueueDisc. Media pesata nel tempo e massimo sono quindi esatti e il
+// costo dipende solo dal numero di variazioni delle code.
+class QueueMonitor
+{
+  public:
+    // da chiamare prima della simulazione (o comunque all'istante da cui
+    // si vuole calcolare la media); l'etichetta è risolta qui una volta sola
+    void Add(ns3::Ptr<ns3::QueueDisc> qdisc, const std::string& nodeName, uint32_t deviceIndex);
+
+    // registro delle variazioni (Time,NodeName,DeviceIndex,QueueLength,QueueBytes);
+    // nullptr per disattivarlo
+    void SetChangeLog(std::ostream* os);
+
+    // chiude l'intervallo di osservazione all'istante corrente
+    void Finish();
+
+    // una riga per coda con media pesata nel tempo, massimo e numero di variazioni
+    void WriteSummary(std::ostream& os) const;
+
+    // occupazione istantanea (pacchetti) mediata su tutte le code e massima
+    double GetCurrentMeanPackets() const;
+    uint32_t GetCurrentMaxPackets() const;
+
+  private:
+    struct QueueState
+    {
+        std::string nodeName;
+        uint32_t deviceIndex{0};
+        uint32_t packets{0};
+        uint32_t bytes{0};
+        uint32_t maxPackets{0};
+        uint32_t maxBytes{0};
+        uint64_t changes{0};
+        ns3::Time start;
+        ns3::Time lastPacketsChange;
+        ns3::Time lastBytesChange;
+        double packetArea{0.0}; // integrale pacchetti x secondi
+        double byteArea{0.0};   // integrale byte x secondi
+        ns3::Time end;
+    };
+
+    void PacketsChanged(size_t index, uint32_t oldValue, uint32_t newValue);
+    void BytesChanged(size_t index, uint32_t oldValue, uint32_t newValue);
+
+    std::vector<QueueState> m_queues;
+    std::ostream* m_changeLog{nullptr};
+};
+
+#endif // QUEUE_MONITOR_H
@@ -0,0 +1,346 @@
+#include "receiver_flow_stats.h"
+
+#include <algorithm>
+#include <cmath>
+#include <iomanip>
+#include <map>
+
+uint64_t
+ReceiverFlowStats::FlowState::Expected() const
+{
+    return received == 0 ? 0 : static_cast<uint64_t>(highestSeq) + 1;
+}
+
+uint64_t
+ReceiverFlowStats::FlowState::Lost() const
+{
+    uint64_t expected = Expected();
+    return expected > received ? expected - received : 0;
+}
+
+ReceiverFlowStats::FlowKey
+ReceiverFlowStats::MakeKey(uint16_t src, uint16_t dst, uint8_t trafficType)
+{
+    return static_cast<FlowKey>(src) << 24 | static_cast<FlowKey>(dst) << 8 | trafficType;
+}
+
+uint16_t
+ReceiverFlowStats::KeySource(FlowKey key)
+{
+    return static_cast<uint16_t>(key >> 24);
+}
+
+uint16_t
+ReceiverFlowStats::KeyDestination(FlowKey key)
+{
+    return static_cast<uint16_t>(key >> 8);
+}
+
+uint8_t
+ReceiverFlowStats::KeyTrafficType(FlowKey key)
+{
+    return static_cast<uint8_t>(key);
+}
+
+void
+ReceiverFlowStats::SetHostNames(std::vector<std::string> names)
+{
+    m_hostNames = std::move(names);
+}
+
+const std::string&
+ReceiverFlowStats::GetHostName(uint16_t id) const
+{
+    static const std::string unknown = "Unknown";
+    return id < m_hostNames.size() ? m_hostNames[id] : unknown;
+}
+
+void
+ReceiverFlowStats::OnPacket(uint16_t src,
+                            uint16_t dst,
+                            uint8_t trafficType,
+                            uint32_t seq,
+                            ns3::Time sendTime,
+                            ns3::Time receiveTime)
+{
+    FlowState& f = m_flows[MakeKey(src, dst, trafficType)];
+
+    if (f.received > 0 && seq <= f.highestSeq && f.highestSeq - seq < kReorderWindow)
+    {
+        if (f.seen.test(seq % kReorderWindow))
+        {
+            f.duplicates++;
+            return;
+        }
+    }
+
+    int64_t transitNs = (receiveTime - sendTime).GetNanoSeconds();
+    uint64_t arrivalIndex = f.received;
+
+    if (f.received == 0)
+    {
+        f.highestSeq = seq;
+        f.recentInOrder.emplace_back(seq, arrivalIndex);
+        f.seen.set(seq % kReorderWindow);
+    }
+    else
+    {
+        // jitter RFC 3550 tra arrivi consecutivi
+        double d = std::fabs(static_cast<double>(transitNs - f.lastTransitNs)) * 1e-9;
+        f.jitterSeconds += (d - f.jitterSeconds) / 16.0;
+
+        if (seq > f.highestSeq)
+        {
+            // le seq che escono dalla finestra liberano i bit per quelle nuove
+            if (seq - f.highestSeq >= kReorderWindow)
+            {
+                f.seen.reset();
+            }
+            else
+            {
+                for (uint32_t s = f.highestSeq + 1; s < seq; ++s)
+                {
+                    f.seen.reset(s % kReorderWindow);
+                }
+            }
+            f.seen.set(seq % kReorderWindow);
+            f.highestSeq = seq;
+            f.recentInOrder.emplace_back(seq, arrivalIndex);
+            if (f.recentInOrder.size() > kReorderWindow)
+            {
+                f.recentInOrder.pop_front();
+            }
+        }
+        else
+        {
+            // pacchetto riordinato; oltre la finestra un duplicato non si
+            // riconosce più e viene contato qui
+            if (f.highestSeq - seq < kReorderWindow)
+            {
+                f.seen.set(seq % kReorderWindow);
+            }
+            uint32_t depth = f.highestSeq - seq;
+            f.reordered++;
+            f.sumReorderDepth += depth;
+            f.maxReorderDepth = std::max(f.maxReorderDepth, depth);
+
+            // primo arrivo con seq > s: se è uscito dalla finestra si usa il più vecchio
+            // ricordato, che dà un limite inferiore dell'extent
+            auto it = std::upper_bound(
+                f.recentInOrder.begin(),
+                f.recentInOrder.end(),
+                seq,
+                [](uint32_t s, const std::pair<uint32_t, uint64_t>& e) { return s < e.first; });
+            if (it == f.recentInOrder.end())
+            {
+                it = f.recentInOrder.begin();
+            }
+            uint64_t extent = arrivalIndex - it->second;
+            f.sumReorderExtent += extent;
+            f.maxReorderExtent = std::max(f.maxReorderExtent, extent);
+        }
+    }
+
+    f.lastTransitNs = transitNs;
+    f.latency.Record(transitNs);
+    f.intervalLatency.Record(transitNs);
+    f.received++;
+}
+
+const std::unordered_map<ReceiverFlowStats::FlowKey, ReceiverFlowStats::FlowState>&
+ReceiverFlowStats::GetFlows() const
+{
+    return m_flows;
+}
+
+std::vector<ReceiverFlowStats::FlowKey>
+ReceiverFlowStats::SortedKeys() const
+{
+    std::vector<FlowKey> keys;
+    keys.reserve(m_flows.size());
+    for (const auto& [key, f] : m_flows)
+    {
+        keys.push_back(key);
+    }
+    std::sort(keys.begin(), keys.end());
+    return keys;
+}
+
+uint64_t
+ReceiverFlowStats::GetClassReceived(uint8_t trafficType) const
+{
+    uint64_t received = 0;
+    for (const auto& [key, f] : m_flows)
+    {
+        if (KeyTrafficType(key) == trafficType)
+        {
+            received += f.received;
+        }
+    }
+    return received;
+}
+
+double
+ReceiverFlowStats::GetClassLossRate(uint8_t trafficType) const
+{
+    uint64_t expected = 0;
+    uint64_t lost = 0;
+    for (const auto& [key, f] : m_flows)
+    {
+        if (KeyTrafficType(key) == trafficType)
+        {
+            expected += f.Expected();
+            lost += f.Lost();
+        }
+    }
+    return expected ? static_cast<double>(lost) / expected : 0.0;
+}
+
+LatencyHistogram
+ReceiverFlowStats::ClassLatency(uint8_t trafficType) const
+{
+    LatencyHistogram merged;
+    for (const auto& [key, f] : m_flows)
+    {
+        if (KeyTrafficType(key) == trafficType)
+        {
+            merged.Add(f.latency);
+        }
+    }
+    return merged;
+}
+
+double
+ReceiverFlowStats::GetClassLatencyPercentile(uint8_t trafficType, double percentile) const
+{
+    return ClassLatency(trafficType).GetValueAtPercentile(percentile) * 1e-9;
+}
+
+void
+ReceiverFlowStats::WriteFlowCsv(std::ostream& os) const
+{
+    os << "src_node,dst_node,traffic_type,received,expected,lost,loss_rate,duplicates,"
+          "reordered,reorder_ratio,max_reorder_depth,mean_reorder_depth,max_reorder_extent,"
+          "mean_reorder_extent,jitter_ms,mean_latency_ms\n";
+    os << std::fixed << std::setprecision(6);
+
+    for (FlowKey key : SortedKeys())
+    {
+        const FlowState& f = m_flows.at(key);
+        uint8_t type = KeyTrafficType(key);
+        uint64_t expected = f.Expected();
+        double lossRate = expected ? static_cast<double>(f.Lost()) / expected : 0.0;
+        double reorderRatio = f.received ? static_cast<double>(f.reordered) / f.received : 0.0;
+        double meanDepth =
+            f.reordered ? static_cast<double>(f.sumReorderDepth) / f.reordered : 0.0;
+        double meanExtent =
+            f.reordered ? static_cast<double>(f.sumReorderExtent) / f.reordered : 0.0;
+        double meanLatency = f.latency.GetMean() * 1e-9;
+
+        os << GetHostName(KeySource(key)) << "," << GetHostName(KeyDestination(key)) << ","
+           << static_cast<int>(type) << "," << f.received << ","
+           << expected << "," << f.Lost() << "," << lossRate << "," << f.duplicates << ","
+           << f.reordered << ","
+           << reorderRatio << "," << f.maxReorderDepth << "," << meanDepth << ","
+           << f.maxReorderExtent << "," << meanExtent << "," << f.jitterSeconds * 1e3 << ","
+           << meanLatency * 1e3 << "\n";
+    }
+}
+
+void
+ReceiverFlowStats::WriteClassSummary(std::ostream& os) const
+{
+    struct ClassTotals
+    {
+        uint64_t flows{0};
+        uint64_t received{0};
+        uint64_t expected{0};
+        uint64_t duplicates{0};
+        uint64_t reordered{0};
+        uint32_t maxReorderDepth{0};
+        uint64_t maxReorderExtent{0};
+        double weightedJitter{0.0};
+        double maxJitter{0.0};
+        LatencyHistogram latency;
+    };
+
+    std::map<uint8_t, ClassTotals> classes;
+    for (const auto& [key, f] : m_flows)
+    {
+        ClassTotals& c = classes[KeyTrafficType(key)];
+        c.flows++;
+        c.received += f.received;
+        c.expected += f.Expected();
+        c.duplicates += f.duplicates;
+        c.reordered += f.reordered;
+        c.maxReorderDepth = std::max(c.maxReorderDepth, f.maxReorderDepth);
+        c.maxReorderExtent = std::max(c.maxReorderExtent, f.maxReorderExtent);
+        c.weightedJitter += f.jitterSeconds * f.received;
+        c.maxJitter = std::max(c.maxJitter, f.jitterSeconds);
+        c.latency.Add(f.latency);
+    }
+
+    os << std::fixed << std::setprecision(6);
+    for (const auto& [type, c] : classes)
+    {
+        uint64_t lost = c.expected > c.received ? c.expected - c.received : 0;
+        os << "[FLOWSTATS] traffic_type=" << static_cast<int>(type) << " flows=" << c.flows
+           << " received=" << c.received << " lost=" << lost
+           << " loss_rate=" << (c.expected ? static_cast<double>(lost) / c.expected : 0.0)
+           << " duplicates=" << c.duplicates << " reordered=" << c.reordered
+           << " reorder_ratio="
+           << (c.received ? static_cast<double>(c.reordered) / c.received : 0.0)
+           << " max_reorder_depth=" << c.maxReorderDepth
+           << " max_reorder_extent=" << c.maxReorderExtent
+           << " mean_jitter_ms=" << (c.received ? c.weightedJitter / c.received * 1e3 : 0.0)
+           << " max_jitter_ms=" << c.maxJitter * 1e3
+           << " p50_ms=" << c.latency.GetValueAtPercentile(50) * 1e-6
+           << " p99_ms=" << c.latency.GetValueAtPercentile(99) * 1e-6
+           << " p999_ms=" << c.latency.GetValueAtPercentile(99.9) * 1e-6 << "\n";
+    }
+}
+
+void
+ReceiverFlowStats::WritePercentileHeader(std::ostream& os)
+{
+    os << "time,src_node,dst_node,traffic_type,count,mean_ms,p50_ms,p90_ms,p99_ms,p999_ms,"
+          "max_ms\n";
+}
+
+void
+ReceiverFlowStats::WritePercentiles(std::ostream& os, double time, bool interval)
+{
+    auto writeRow = [&os, time](const std::string& src,
+                                const std::string& dst,
+                                uint8_t type,
+                                const LatencyHistogram& h) {
+        os << time << "," << src << "," << dst << "," << static_cast<int>(type) << ","
+           << h.GetCount() << "," << h.GetMean() * 1e-6 << ","
+           << h.GetValueAtPercentile(50) * 1e-6 << "," << h.GetValueAtPercentile(90) * 1e-6
+           << "," << h.GetValueAtPercentile(99) * 1e-6 << ","
+           << h.GetValueAtPercentile(99.9) * 1e-6 << "," << h.GetMax() * 1e-6 << "\n";
+    };
+
+    os << std::fixed << std::setprecision(6);
+    std::map<uint8_t, LatencyHistogram> classes;
+    for (FlowKey key : SortedKeys())
+    {
+        FlowState& f = m_flows.at(key);
+        uint8_t type = KeyTrafficType(key);
+        LatencyHistogram& h = interval ? f.intervalLatency : f.latency;
+        if (h.GetCount() == 0)
+        {
+            continue;
+        }
+        writeRow(GetHostName(KeySource(key)), GetHostName(KeyDestination(key)), type, h);
+        classes[type].Add(h);
+        if (interval)
+        {
+            h.Reset();
+        }
+    }
+    for (const auto& [type, h] : classes)
+    {
+        writeRow("*", "*", type, h);
+    }
+}
@@ -0,0 +1,109 @@
+#ifndef RECEIVER_FLOW_STATS_H
+#define RECEIVER_FLOW_STATS_H
+
+#include "latency_histogram.h"
+
+#include "ns3/nstime.h"
+
+#include <bitset>
+#include <cstdint>
+#include <deque>
+#include <ostream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// Statistiche lato ricevitore per flusso (src, dst, classe di traffico),
+// calcolate a partire dai numeri di sequenza del SeqTsSizeHeader:
+//  - perdita: pacchetti attesi (seq massima + 1) meno pacchetti ricevuti
+//  - riordino: un pacchetto è riordinato se arriva con seq minore della
+//    massima già vista. depth = distanza in numeri di sequenza,
+//    extent = distanza in arrivi (RFC 4737, sezione 4.2)
+//  - duplicati: seq già ricevute nella finestra di riordino; sono contati a
+//    parte e non entrano in ricevuti, riordinati, jitter e latenza
+//  - jitter: stimatore di interarrivo della RFC 3550 (J += (|D| - J) / 16)
+//  - latenza: istogramma logaritmico per flusso, sia cumulativo sia per
+//    intervallo di report, da cui si ricavano i percentili con memoria limitata
+//
+// I flussi sono indicizzati con gli id densi degli host (HostDirectory): i
+// nomi servono solo quando si scrivono i risultati.
+class ReceiverFlowStats
+{
+  public:
+    // numero massimo di arrivi in ordine ricordati per il calcolo dell'extent,
+    // e ampiezza in seq della finestra in cui si riconoscono i duplicati
+    static constexpr std::size_t kReorderWindow = 4096;
+
+    struct FlowState
+    {
+        uint64_t received{0};
+        uint64_t duplicates{0};
+        uint32_t highestSeq{0};
+        uint64_t reordered{0};
+        uint32_t maxReorderDepth{0};
+        uint64_t sumReorderDepth{0};
+        uint64_t maxReorderExtent{0};
+        uint64_t sumReorderExtent{0};
+        double jitterSeconds{0.0};
+        int64_t lastTransitNs{0};
+        LatencyHistogram latency;         // dall'inizio della simulazione
+        LatencyHistogram intervalLatency; // dall'ultimo report per intervallo
+
+        // arrivi che hanno fatto avanzare la seq massima: (seq, indice di arrivo).
+        // Sono ordinati per seq crescente, quindi il primo elemento con seq > s
+        // è il primo arrivo successivo a s nell'ordine di invio
+        std::deque<std::pair<uint32_t, uint64_t>> recentInOrder;
+        // seq ricevute in (highestSeq - kReorderWindow, highestSeq], bit seq % kReorderWindow
+        std::bitset<kReorderWindow> seen;
+
+        uint64_t Expected() const;
+        uint64_t Lost() const;
+    };
+
+    // (src, dst, classe di traffico) in un intero: src << 24 | dst << 8 | classe.
+    // L'ordine numerico è quello della tupla
+    using FlowKey = uint64_t;
+    static FlowKey MakeKey(uint16_t src, uint16_t dst, uint8_t trafficType);
+    static uint16_t KeySource(FlowKey key);
+    static uint16_t KeyDestination(FlowKey key);
+    static uint8_t KeyTrafficType(FlowKey key);
+
+    // nomi degli host per id, usati solo in uscita; un id fuori elenco è "Unknown"
+    void SetHostNames(std::vector<std::string> names);
+    const std::string& GetHostName(uint16_t id) const;
+
+    void OnPacket(uint16_t src,
+                  uint16_t dst,
+                  uint8_t trafficType,
+                  uint32_t seq,
+                  ns3::Time sendTime,
+                  ns3::Time receiveTime);
+
+    const std::unordered_map<FlowKey, FlowState>& GetFlows() const;
+
+    // aggregati per classe di traffico
+    uint64_t GetClassReceived(uint8_t trafficType) const;
+    double GetClassLossRate(uint8_t trafficType) const;
+    // percentile (0-100) della latenza in secondi, 0 se non ci sono campioni
+    double GetClassLatencyPercentile(uint8_t trafficType, double percentile) const;
+
+    // una riga per flusso
+    void WriteFlowCsv(std::ostream& os) const;
+    // aggregato per classe di traffico
+    void WriteClassSummary(std::ostream& os) const;
+
+    // percentili di latenza: una riga per flusso e una per classe (src e dst
+    // "*"). Con interval = true usa gli istogrammi dell'intervallo e li azzera
+    static void WritePercentileHeader(std::ostream& os);
+    void WritePercentiles(std::ostream& os, double time, bool interval);
+
+  private:
+    LatencyHistogram ClassLatency(uint8_t trafficType) const;
+    // chiavi dei flussi in ordine crescente, per un'uscita deterministica
+    std::vector<FlowKey> SortedKeys() const;
+
+    std::unordered_map<FlowKey, FlowState> m_flows;
+    std::vector<std::string> m_hostNames;
+};
+
+#endif // RECEIVER_FLOW_STATS_H
@@ -0,0 +1,288 @@
+#include "replication_runner.h"
+
+#include "process_runner.h"
+#include "run_summary.h"
+
+#include "ns3/rng-seed-manager.h"
+
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <set>
+#include <sstream>
+
+namespace
+{
+
+struct Replication
+{
+    uint64_t rngRun{1};
+    std::string workDir;
+    int exitStatus{-1};
+    bool completed{false};
+    RunSummary summary;
+};
+
+// quantile 0.975 della t di Student con df gradi di libertà
+double
+StudentT975(size_t df)
+{
+    static const double table[] = {12.706, 4.303, 3.182, 2.776, 2.571, 2.447, 2.365, 2.306,
+                                   2.262,  2.228, 2.201, 2.179, 2.160, 2.145, 2.131, 2.120,
+                                   2.110,  2.101, 2.093, 2.086, 2.080, 2.074, 2.069, 2.064,
+                                   2.060,  2.056, 2.052, 2.048, 2.045, 2.042};
+    if (df == 0)
+    {
+        return std::numeric_limits<double>::infinity();
+    }
+    if (df <= sizeof(table) / sizeof(table[0]))
+    {
+        return table[df - 1];
+    }
+    // espansione di Cornish-Fisher attorno alla normale, errore < 1e-3 oltre 30
+    const double z = 1.959964;
+    double d = static_cast<double>(df);
+    return z + (z * z * z + z) / (4 * d) +
+           (5 * std::pow(z, 5) + 16 * z * z * z + 3 * z) / (96 * d * d);
+}
+
+// metriche che decidono l'arresto anticipato
+std::vector<std::string>
+StoppingMetrics()
+{
+    std::vector<std::string> metrics;
+    for (int type : {0, 1})
+    {
+        std::string prefix = "class" + std::to_string(type) + "_";
+        metrics.push_back(prefix + "p50_ms");
+        metrics.push_back(prefix + "p99_ms");
+        metrics.push_back(prefix + "loss");
+    }
+    metrics.push_back("control_bytes");
+    return metrics;
+}
+
+std::vector<double>
+Samples(const std::vector<Replication>& runs, const std::string& key)
+{
+    std::vector<double> samples;
+    for (const auto& run : runs)
+    {
+        if (run.completed && run.summary.Has(key))
+        {
+            samples.push_back(run.summary.Get(key));
+        }
+    }
+    return samples;
+}
+
+// metrica più lontana dalla precisione richiesta, stringa vuota se sono tutte entro
+std::string
+WidestMetric(const std::vector<Replication>& runs, double precision, double& relHalfWidth)
+{
+    std::string widest;
+    relHalfWidth = 0.0;
+    for (const auto& key : StoppingMetrics())
+    {
+        ConfidenceInterval ci = ComputeConfidenceInterval(Samples(runs, key));
+        double rel = ci.RelativeHalfWidth();
+        if (rel > precision && (widest.empty() || rel > relHalfWidth))
+        {
+            widest = key;
+            relHalfWidth = rel;
+        }
+    }
+    return widest;
+}
+
+std::vector<const RunSummary*>
+Summaries(const std::vector<Replication>& runs)
+{
+    std::vector<const RunSummary*> summaries;
+    for (const auto& run : runs)
+    {
+        summaries.push_back(&run.summary);
+    }
+    return summaries;
+}
+
+void
+WriteRuns(const std::string& path, const std::vector<Replication>& runs)
+{
+    std::vector<std::string> columns;
+    for (size_t i = 0; i < runs.size(); ++i)
+    {
+        std::ostringstream row;
+        row << i << "," << runs[i].rngRun << "," << runs[i].exitStatus << ","
+            << runs[i].completed;
+        columns.push_back(row.str());
+    }
+    WriteSummaryCsv(path, "run,rng_run,exit_status,completed", columns, Summaries(runs));
+}
+
+void
+WriteIntervals(const std::string& path, const std::vector<Replication>& runs)
+{
+    std::ofstream csv(path);
+    csv << "metric,n,mean,stddev,ci95_low,ci95_high,half_width,rel_half_width\n";
+    for (const auto& key : SummaryKeys(Summaries(runs)))
+    {
+        ConfidenceInterval ci = ComputeConfidenceInterval(Samples(runs, key));
+        csv << key << "," << ci.n << "," << FormatDouble(ci.mean) << ","
+            << FormatDouble(ci.stddev) << "," << FormatDouble(ci.mean - ci.halfWidth) << ","
+            << FormatDouble(ci.mean + ci.halfWidth) << "," << FormatDouble(ci.halfWidth) << ","
+            << FormatDouble(ci.RelativeHalfWidth()) << "\n";
+    }
+}
+
+} // namespace
+
+double
+ConfidenceInterval::RelativeHalfWidth() const
+{
+    if (halfWidth == 0.0)
+    {
+        return 0.0;
+    }
+    return mean == 0.0 ? std::numeric_limits<double>::infinity() : halfWidth / std::fabs(mean);
+}
+
+ConfidenceInterval
+ComputeConfidenceInterval(const std::vector<double>& samples)
+{
+    ConfidenceInterval ci;
+    ci.n = samples.size();
+    if (ci.n == 0)
+    {
+        ci.halfWidth = std::numeric_limits<double>::infinity();
+        return ci;
+    }
+
+    double sum = 0.0;
+    for (double x : samples)
+    {
+        sum += x;
+    }
+    ci.mean = sum / ci.n;
+    if (ci.n < 2)
+    {
+        ci.halfWidth = std::numeric_limits<double>::infinity();
+        return ci;
+    }
+
+    double squares = 0.0;
+    for (double x : samples)
+    {
+        squares += (x - ci.mean) * (x - ci.mean);
+    }
+    ci.stddev = std::sqrt(squares / (ci.n - 1));
+    ci.halfWidth = StudentT975(ci.n - 1) * ci.stddev / std::sqrt(static_cast<double>(ci.n));
+    return ci;
+}
+
+int
+RunReplications(const SimulationParameters& params, int argc, char* argv[])
+{
+    std::vector<Replication> runs(params.replications);
+    uint64_t firstRun = ns3::RngSeedManager::GetRun();
+    for (size_t i = 0; i < runs.size(); ++i)
+    {
+        runs[i].rngRun = firstRun + i;
+    }
+
+    std::set<std::string> drop{"replications",
+                               "replicationsMin",
+                               "replicationPrecision",
+                               "jobs",
+                               "RngRun",
+                               "summaryFile"};
+    drop.insert(ChildInputOptions().begin(), ChildInputOptions().end());
+    std::vector<std::string> baseArgs{CurrentExecutable()};
+    for (const auto& arg : ForwardedArguments(argc, argv, drop))
+    {
+        baseArgs.push_back(arg);
+    }
+    for (const auto& arg : ChildInputArguments(params))
+    {
+        baseArgs.push_back(arg);
+    }
+
+    uint32_t jobs = ParallelJobs(params.jobs);
+    std::cout << "[REPLICATE] fino a " << runs.size() << " repliche (RngRun " << firstRun << "-"
+              << firstRun + runs.size() - 1 << "), " << jobs << " in parallelo" << std::endl;
+
+    auto launch = [&](size_t index) {
+        Replication& run = runs[index];
+        std::ostringstream dir;
+        dir << "replicate/run_" << std::setw(4) << std::setfill('0') << index;
+        run.workDir = AbsolutePath(dir.str());
+        std::string summaryPath = run.workDir + "/summary.txt";
+        std::remove(summaryPath.c_str());
+
+        std::vector<std::string> args = baseArgs;
+        args.push_back("--RngRun=" + std::to_string(run.rngRun));
+        args.push_back("--summaryFile=" + summaryPath);
+        // servono solo i riepiloghi: niente log voluminosi né avanzamento
+        args.push_back("--latencyLog=");
+        args.push_back("--queueChangeLog=false");
+        args.push_back("--progressInterval=0");
+
+        pid_t pid = LaunchChild(args, run.workDir, "run.log");
+        if (pid < 0)
+        {
+            std::cout << "[REPLICATE] avvio fallito per run_" << index << std::endl;
+        }
+        return pid;
+    };
+
+    size_t completed = 0;
+    bool converged = false;
+    auto onExit = [&](size_t index, int exitStatus) {
+        Replication& run = runs[index];
+        run.exitStatus = exitStatus;
+        run.completed = exitStatus == 0 && run.summary.Read(run.workDir + "/summary.txt");
+        completed += run.completed ? 1 : 0;
+
+        double relHalfWidth = 0.0;
+        std::string widest = WidestMetric(runs, params.replicationPrecision, relHalfWidth);
+        std::cout << "[REPLICATE] " << run.workDir << (run.completed ? " completata" : " fallita")
+                  << ", " << completed << " completate";
+        if (completed >= 2 && !widest.empty())
+        {
+            std::cout << ", intervallo più largo " << widest << " +-" << std::fixed
+                      << std::setprecision(1) << relHalfWidth * 100 << "%" << std::defaultfloat;
+        }
+        std::cout << std::endl;
+
+        if (!converged && params.replicationPrecision > 0 &&
+            completed >= params.replicationsMin && widest.empty())
+        {
+            converged = true;
+            std::cout << "[REPLICATE] intervalli entro +-" << params.replicationPrecision * 100
+                      << "% della media: nessuna nuova replica" << std::endl;
+        }
+        return !converged;
+    };
+
+    size_t next = RunChildPool(runs.size(), jobs, launch, onExit);
+    runs.resize(next);
+    WriteRuns("replications.csv", runs);
+    WriteIntervals("replication_ci.csv", runs);
+
+    std::cout << std::fixed << std::setprecision(6);
+    for (const auto& key : StoppingMetrics())
+    {
+        ConfidenceInterval ci = ComputeConfidenceInterval(Samples(runs, key));
+        std::cout << "[REPLICATE] " << key << " n=" << ci.n << " mean=" << ci.mean
+                  << " ci95=+-" << ci.halfWidth << std::endl;
+    }
+    std::cout << std::defaultfloat;
+
+    size_t failed = next - completed;
+    std::cout << "[REPLICATE] " << completed << " repliche in replication_ci.csv (" << failed
+              << " fallite)" << std::endl;
+    return failed == 0 ? 0 : 1;
+}
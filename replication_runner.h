@@ -0,0 +1,35 @@
+#ifndef REPLICATION_RUNNER_H
+#define REPLICATION_RUNNER_H
+
+#include "simulation_parameters.h"
+
+#include <string>
+#include <vector>
+
+// Intervallo di confidenza al 95% della media di n campioni indipendenti,
+// con la t di Student a n - 1 gradi di libertà
+struct ConfidenceInterval
+{
+    size_t n{0};
+    double mean{0.0};
+    double stddev{0.0};    // deviazione standard campionaria
+    double halfWidth{0.0}; // infinita con meno di due campioni
+
+    // semiampiezza relativa alla media (0 se media e semiampiezza sono nulle)
+    double RelativeHalfWidth() const;
+};
+
+ConfidenceInterval ComputeConfidenceInterval(const std::vector<double>& samples);
+
+// Repliche indipendenti dello stesso scenario: fino a replications
+// simulazioni figlie con RngRun consecutivi a partire da quello corrente,
+// jobs alla volta, in replicate/run_<i>/. Dopo replicationsMin esecuzioni
+// completate non se ne lanciano altre quando, per le metriche principali
+// (p50 e p99 per classe, perdita per classe, byte di controllo), la
+// semiampiezza dell'intervallo è entro replicationPrecision della media.
+// Scrive replications.csv (una riga per esecuzione) e replication_ci.csv
+// (media e intervallo per ogni metrica del riepilogo).
+// Restituisce il codice di uscita del processo.
+int RunReplications(const SimulationParameters& params, int argc, char* argv[]);
+
+#endif // REPLICATION_RUNNER_H
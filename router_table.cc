@@ -0,0 +1,164 @@
+#include "router_table.h"
+
+#include "ns3/abort.h"
+
+using namespace ns3;
+
+RouterTable::RouterTable(std::shared_ptr<const TopologyPartition> partition)
+    : m_partition(partition)
+{
+}
+
+Ptr<Node>
+RouterTable::Add(const std::string& name)
+{
+    NS_ABORT_MSG_IF(m_index.count(name), "router duplicato: " << name);
+    Ptr<Node> node = CreateObject<Node>(m_partition->GetRank(name));
+    uint32_t index = m_names.size();
+    m_routers[name] = node;
+    m_index[name] = index;
+    m_names.push_back(name);
+    m_nodes.push_back(node);
+    m_adjacency.emplace_back();
+    if (node->GetId() >= m_indexByNodeId.size())
+    {
+        m_indexByNodeId.resize(node->GetId() + 1, -1);
+    }
+    m_indexByNodeId[node->GetId()] = index;
+    return node;
+}
+
+Ptr<Node>
+RouterTable::Get(const std::string& name) const
+{
+    int32_t index = GetIndex(name);
+    NS_ABORT_MSG_IF(index < 0, "router sconosciuto: " << name);
+    return m_nodes[index];
+}
+
+const std::string&
+RouterTable::GetName(Ptr<Node> node) const
+{
+    static const std::string empty;
+    int32_t index = GetIndex(node);
+    return index < 0 ? empty : m_names[index];
+}
+
+bool
+RouterTable::IsLocal(const std::string& name) const
+{
+    return m_partition->IsLocal(name);
+}
+
+size_t
+RouterTable::GetN() const
+{
+    return m_names.size();
+}
+
+int32_t
+RouterTable::GetIndex(const std::string& name) const
+{
+    auto it = m_index.find(name);
+    return it == m_index.end() ? -1 : static_cast<int32_t>(it->second);
+}
+
+int32_t
+RouterTable::GetIndex(Ptr<Node> node) const
+{
+    uint32_t id = node->GetId();
+    return id < m_indexByNodeId.size() ? m_indexByNodeId[id] : -1;
+}
+
+const std::string&
+RouterTable::GetName(uint32_t index) const
+{
+    return m_names.at(index);
+}
+
+void
+RouterTable::AddLink(const std::string& a,
+                     const std::string& b,
+                     Ptr<NetDevice> deviceA,
+                     Ptr<NetDevice> deviceB,
+                     Ipv6Address addressA,
+                     Ipv6Address addressB)
+{
+    int32_t indexA = GetIndex(a);
+    int32_t indexB = GetIndex(b);
+    NS_ABORT_MSG_IF(indexA < 0 || indexB < 0,
+                    "collegamento tra router sconosciuti: " << a << "-" << b);
+    NS_ABORT_MSG_IF(m_adjacency[indexA].count(indexB),
+                    "collegamento duplicato: " << a << "-" << b);
+    m_adjacency[indexA][indexB] = Adjacency{deviceA, addressA, addressB};
+    m_adjacency[indexB][indexA] = Adjacency{deviceB, addressB, addressA};
+    m_addressOwner[addressA] = indexA;
+    m_addressOwner[addressB] = indexB;
+}
+
+const RouterTable::Adjacency*
+RouterTable::GetAdjacency(const std::string& name, const std::string& neighbour) const
+{
+    int32_t index = GetIndex(name);
+    int32_t peer = GetIndex(neighbour);
+    if (index < 0 || peer < 0)
+    {
+        return nullptr;
+    }
+    auto it = m_adjacency[index].find(peer);
+    return it == m_adjacency[index].end() ? nullptr : &it->second;
+}
+
+const std::string&
+RouterTable::GetNameByAddress(const Ipv6Address& address) const
+{
+    static const std::string empty;
+    auto it = m_addressOwner.find(address);
+    return it == m_addressOwner.end() ? empty : m_names[it->second];
+}
+
+const std::map<std::string, Ptr<Node>>&
+RouterTable::GetAll() const
+{
+    return m_routers;
+}
+
+std::map<std::string, Ptr<Node>>
+RouterTable::GetLocal() const
+{
+    std::map<std::string, Ptr<Node>> local;
+    for (const auto& [name, node] : m_routers)
+    {
+        if (IsLocal(name))
+        {
+            local.emplace_hint(local.end(), name, node);
+        }
+    }
+    return local;
+}
+
+const TopologyPartition&
+RouterTable::GetPartition() const
+{
+    return *m_partition;
+}
+
+std::shared_ptr<QRegister>
+RouterTable::GetQRegister(const std::string& name) const
+{
+    auto it = m_qRegisters.find(name);
+    return it == m_qRegisters.end() ? nullptr : it->second;
+}
+
+void
+RouterTable::SetQRegister(const std::string& name, std::shared_ptr<QRegister> qRegister)
+{
+    NS_ABORT_MSG_IF(!IsLocal(name), "Q-register per un router remoto: " << name);
+    m_qRegisters[name] = qRegister;
+}
+
+const std::map<std::string, std::shared_ptr<QRegister>>&
+RouterTable::GetQRegisters() const
+{
+    return m_qRegisters;
+}
@@ -0,0 +1,91 @@
+#ifndef ROUTER_TABLE_H
+#define ROUTER_TABLE_H
+
+#include "action.h"
+#include "topology_partition.h"
+
+#include "ns3/ipv6-address.h"
+#include "ns3/net-device.h"
+#include "ns3/node.h"
+#include "ns3/ptr.h"
+
+#include <map>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+using QRegister = std::vector<std::vector<Action>>;
+
+// Registro dei router della topologia e dei Q-register, condiviso tra main e
+// QRoutingHelper tramite shared_ptr al posto dei puntatori grezzi alle mappe
+// del main. Tutti i rank creano tutti i router (requisito del simulatore
+// distribuito), ciascuno con il system id del rank che lo simula; i
+// Q-register esistono solo per i router locali.
+//
+// Le ricerche usate durante il set-up sono O(1): nome, indice, nodo,
+// collegamento verso un vicino e indirizzo delle interfacce tra router.
+// L'indice di un router è l'ordine di Add: il main li aggiunge nell'ordine di
+// topology.nodes, lo stesso dei DAG e delle righe dei Q-register.
+class RouterTable
+{
+  public:
+    // un lato di un collegamento tra router
+    struct Adjacency
+    {
+        ns3::Ptr<ns3::NetDevice> device; // dispositivo di uscita verso il vicino
+        ns3::Ipv6Address localAddress;
+        ns3::Ipv6Address peerAddress;
+    };
+
+    explicit RouterTable(std::shared_ptr<const TopologyPartition> partition);
+
+    // crea il router sul rank assegnato dalla partizione
+    ns3::Ptr<ns3::Node> Add(const std::string& name);
+
+    ns3::Ptr<ns3::Node> Get(const std::string& name) const;
+    // nome del router, stringa vuota se il nodo non è un router
+    const std::string& GetName(ns3::Ptr<ns3::Node> node) const;
+    bool IsLocal(const std::string& name) const;
+
+    size_t GetN() const;
+    // -1 se il nome o il nodo non sono un router
+    int32_t GetIndex(const std::string& name) const;
+    int32_t GetIndex(ns3::Ptr<ns3::Node> node) const;
+    const std::string& GetName(uint32_t index) const;
+
+    // registra il collegamento a-b con i dispositivi e gli indirizzi dei due lati
+    void AddLink(const std::string& a,
+                 const std::string& b,
+                 ns3::Ptr<ns3::NetDevice> deviceA,
+                 ns3::Ptr<ns3::NetDevice> deviceB,
+                 ns3::Ipv6Address addressA,
+                 ns3::Ipv6Address addressB);
+    // nullptr se i due router non sono collegati
+    const Adjacency* GetAdjacency(const std::string& name, const std::string& neighbour) const;
+    // router a cui appartiene un indirizzo tra router, stringa vuota se sconosciuto
+    const std::string& GetNameByAddress(const ns3::Ipv6Address& address) const;
+
+    const std::map<std::string, ns3::Ptr<ns3::Node>>& GetAll() const;
+    std::map<std::string, ns3::Ptr<ns3::Node>> GetLocal() const;
+    const TopologyPartition& GetPartition() const;
+
+    // nullptr se il router è remoto o il registro non è ancora stato creato
+    std::shared_ptr<QRegister> GetQRegister(const std::string& name) const;
+    void SetQRegister(const std::string& name, std::shared_ptr<QRegister> qRegister);
+    // Q-register dei soli router locali
+    const std::map<std::string, std::shared_ptr<QRegister>>& GetQRegisters() const;
+
+  private:
+    std::shared_ptr<const TopologyPartition> m_partition;
+    std::map<std::string, ns3::Ptr<ns3::Node>> m_routers; // in ordine alfabetico
+    std::unordered_map<std::string, uint32_t> m_index;
+    std::vector<std::string> m_names;            // indice -> nome
+    std::vector<ns3::Ptr<ns3::Node>> m_nodes;    // indice -> nodo
+    std::vector<int32_t> m_indexByNodeId;        // Node::GetId() -> indice, -1 per gli host
+    std::vector<std::unordered_map<uint32_t, Adjacency>> m_adjacency; // indice -> vicini
+    std::unordered_map<ns3::Ipv6Address, uint32_t, ns3::Ipv6AddressHash> m_addressOwner;
+    std::map<std::string, std::shared_ptr<QRegister>> m_qRegisters;
+};
+
+#endif // ROUTER_TABLE_H
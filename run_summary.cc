@@ -0,0 +1,139 @@
+#include "run_summary.h"
+
+#include <cstdio>
+#include <fstream>
+#include <iomanip>
+#include <limits>
+#include <sstream>
+
+void
+RunSummary::Set(const std::string& key, double value)
+{
+    m_values[key] = value;
+}
+
+bool
+RunSummary::Has(const std::string& key) const
+{
+    return m_values.find(key) != m_values.end();
+}
+
+double
+RunSummary::Get(const std::string& key, double defaultValue) const
+{
+    auto it = m_values.find(key);
+    return it == m_values.end() ? defaultValue : it->second;
+}
+
+const std::map<std::string, double>&
+RunSummary::GetValues() const
+{
+    return m_values;
+}
+
+bool
+RunSummary::Write(const std::string& path) const
+{
+    // scrittura su file temporaneo e rename: il driver non legge mai un file a metà
+    std::string tmpPath = path + ".tmp";
+    {
+        std::ofstream out(tmpPath, std::ios::trunc);
+        if (!out)
+        {
+            return false;
+        }
+        out << std::setprecision(std::numeric_limits<double>::max_digits10);
+        for (const auto& [key, value] : m_values)
+        {
+            out << key << "=" << value << "\n";
+        }
+        if (!out)
+        {
+            return false;
+        }
+    }
+    return std::rename(tmpPath.c_str(), path.c_str()) == 0;
+}
+
+bool
+RunSummary::Read(const std::string& path)
+{
+    std::ifstream in(path);
+    if (!in)
+    {
+        return false;
+    }
+
+    m_values.clear();
+    std::string line;
+    while (std::getline(in, line))
+    {
+        size_t eq = line.find('=');
+        if (eq == std::string::npos)
+        {
+            continue;
+        }
+        try
+        {
+            m_values[line.substr(0, eq)] = std::stod(line.substr(eq + 1));
+        }
+        catch (const std::exception&)
+        {
+            // valori non numerici (nan/inf scritti male) vengono ignorati
+        }
+    }
+    return true;
+}
+
+std::string
+FormatDouble(double value)
+{
+    std::ostringstream oss;
+    oss << std::setprecision(10) << value;
+    return oss.str();
+}
+
+std::set<std::string>
+SummaryKeys(const std::vector<const RunSummary*>& summaries)
+{
+    std::set<std::string> keys;
+    for (const RunSummary* summary : summaries)
+    {
+        for (const auto& [key, value] : summary->GetValues())
+        {
+            keys.insert(key);
+        }
+    }
+    return keys;
+}
+
+void
+WriteSummaryCsv(const std::string& path,
+                const std::string& header,
+                const std::vector<std::string>& columns,
+                const std::vector<const RunSummary*>& summaries)
+{
+    std::set<std::string> keys = SummaryKeys(summaries);
+
+    std::ofstream csv(path);
+    csv << header;
+    for (const auto& key : keys)
+    {
+        csv << "," << key;
+    }
+    csv << "\n";
+
+    for (size_t i = 0; i < summaries.size(); ++i)
+    {
+        csv << columns[i];
+        for (const auto& key : keys)
+        {
+            csv << ",";
+            if (summaries[i]->Has(key))
+            {
+                csv << FormatDouble(summaries[i]->Get(key));
+            }
+        }
+        csv << "\n";
+    }
+}
@@ -0,0 +1,41 @@
+#ifndef RUN_SUMMARY_H
+#define RUN_SUMMARY_H
+
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+
+// Metriche riassuntive di una singola esecuzione, salvate come righe
+// "chiave=valore". Sono il formato di scambio tra l'esecuzione figlia e i
+// driver che lanciano più simulazioni (ricerca del carico, sweep, repliche).
+class RunSummary
+{
+  public:
+    void Set(const std::string& key, double value);
+    bool Has(const std::string& key) const;
+    double Get(const std::string& key, double defaultValue = 0.0) const;
+    const std::map<std::string, double>& GetValues() const;
+
+    bool Write(const std::string& path) const;
+    bool Read(const std::string& path);
+
+  private:
+    std::map<std::string, double> m_values;
+};
+
+// valore per i CSV e gli argomenti dei figli, con 10 cifre significative
+std::string FormatDouble(double value);
+
+// unione delle chiavi dei riepiloghi, in ordine alfabetico
+std::set<std::string> SummaryKeys(const std::vector<const RunSummary*>& summaries);
+
+// CSV con una riga per esecuzione: le colonne fisse (header e columns, già
+// separate da virgole) e poi una colonna per ogni chiave di SummaryKeys,
+// vuota nelle righe il cui riepilogo non la contiene
+void WriteSummaryCsv(const std::string& path,
+                     const std::string& header,
+                     const std::vector<std::string>& columns,
+                     const std::vector<const RunSummary*>& summaries);
+
+#endif // RUN_SUMMARY_H
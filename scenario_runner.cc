@@ -0,0 +1,287 @@
+#include "scenario_runner.h"
+
+#include "process_runner.h"
+#include "run_summary.h"
+
+#include "ns3/abort.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <set>
+#include <sstream>
+
+namespace
+{
+
+struct ScenarioRun
+{
+    std::string workDir;
+    int exitStatus{-1};
+    bool completed{false};
+    RunSummary summary;
+};
+
+// opzioni che non hanno senso dentro uno scenario
+const std::set<std::string> kForbiddenOptions{"scenario", "convertLatencyLog", "summaryFile"};
+
+std::string
+Trim(const std::string& text)
+{
+    size_t first = text.find_first_not_of(" \t\r");
+    if (first == std::string::npos)
+    {
+        return "";
+    }
+    size_t last = text.find_last_not_of(" \t\r");
+    return text.substr(first, last - first + 1);
+}
+
+// il nome diventa una directory: solo lettere, cifre, '_', '-' e '.'
+bool
+IsValidName(const std::string& name)
+{
+    return !name.empty() && name != "." && name != ".." &&
+           std::all_of(name.begin(), name.end(), [](char c) {
+               return std::isalnum(static_cast<unsigned char>(c)) || c == '_' || c == '-' ||
+                      c == '.';
+           });
+}
+
+// argv in stile C per CommandLine::Parse, valido finché vive args
+std::vector<char*>
+MakeArgv(std::vector<std::string>& args)
+{
+    std::vector<char*> argv;
+    for (auto& arg : args)
+    {
+        argv.push_back(arg.data());
+    }
+    argv.push_back(nullptr);
+    return argv;
+}
+
+void
+WriteResults(const std::string& path,
+             const std::vector<Scenario>& scenarios,
+             const std::vector<ScenarioRun>& runs)
+{
+    std::vector<std::string> columns;
+    std::vector<const RunSummary*> summaries;
+    for (size_t i = 0; i < runs.size(); ++i)
+    {
+        std::ostringstream row;
+        row << scenarios[i].name << "," << scenarios[i].file << "," << runs[i].exitStatus << ","
+            << runs[i].completed;
+        columns.push_back(row.str());
+        summaries.push_back(&runs[i].summary);
+    }
+    WriteSummaryCsv(path, "scenario,file,exit_status,completed", columns, summaries);
+}
+
+} // namespace
+
+std::vector<Scenario>
+LoadScenarios(const std::vector<std::string>& files)
+{
+    std::vector<Scenario> scenarios;
+    std::set<std::string> names;
+    for (const auto& file : files)
+    {
+        std::ifstream in(file);
+        NS_ABORT_MSG_IF(!in, "impossibile leggere lo scenario " << file);
+        std::filesystem::path directory = std::filesystem::path(AbsolutePath(file)).parent_path();
+
+        std::vector<std::string> common;
+        std::vector<Scenario> sections;
+        std::string line;
+        uint32_t lineNumber = 0;
+        while (std::getline(in, line))
+        {
+            lineNumber++;
+            line = Trim(line.substr(0, line.find('#')));
+            if (line.empty())
+            {
+                continue;
+            }
+            if (line.front() == '[')
+            {
+                NS_ABORT_MSG_IF(line.back() != ']',
+                                file << ":" << lineNumber << ": sezione senza ']'");
+                std::string name = Trim(line.substr(1, line.size() - 2));
+                NS_ABORT_MSG_IF(!IsValidName(name),
+                                file << ":" << lineNumber << ": nome di scenario non valido '"
+                                     << name << "'");
+                sections.push_back(Scenario{name, file, common});
+                continue;
+            }
+
+            size_t equal = line.find('=');
+            NS_ABORT_MSG_IF(equal == std::string::npos,
+                            file << ":" << lineNumber << ": serve 'chiave = valore'");
+            std::string key = Trim(line.substr(0, equal));
+            std::string value = Trim(line.substr(equal + 1));
+            NS_ABORT_MSG_IF(key.empty() || key.front() == '-',
+                            file << ":" << lineNumber << ": chiave non valida '" << key << "'");
+            NS_ABORT_MSG_IF(kForbiddenOptions.count(key),
+                            file << ":" << lineNumber << ": " << key
+                                 << " non è ammesso in uno scenario");
+            // i percorsi dei file in ingresso sono relativi al file dello scenario
+            if (ChildInputOptions().count(key) && !value.empty())
+            {
+                std::vector<std::string> paths;
+                for (const auto& item : SplitList(value))
+                {
+                    std::filesystem::path path(item);
+                    paths.push_back(path.is_absolute() ? item : (directory / path).string());
+                }
+                value = AbsolutePathList(paths);
+            }
+            auto& arguments = sections.empty() ? common : sections.back().arguments;
+            arguments.push_back("--" + key + "=" + value);
+        }
+
+        if (sections.empty())
+        {
+            std::string name = std::filesystem::path(file).stem().string();
+            NS_ABORT_MSG_IF(!IsValidName(name),
+                            file << ": il nome del file non è un nome di scenario valido");
+            sections.push_back(Scenario{name, file, common});
+        }
+        for (auto& scenario : sections)
+        {
+            NS_ABORT_MSG_IF(!names.insert(scenario.name).second,
+                            "scenario " << scenario.name << " ripetuto (" << file << ")");
+            scenarios.push_back(std::move(scenario));
+        }
+    }
+    NS_ABORT_MSG_IF(scenarios.empty(), "nessuno scenario in " << files.size() << " file");
+    return scenarios;
+}
+
+std::vector<std::string>
+ScenarioArguments(const Scenario& scenario, int argc, char* argv[])
+{
+    std::vector<std::string> args{argv[0]};
+    args.insert(args.end(), scenario.arguments.begin(), scenario.arguments.end());
+    for (const auto& arg : ForwardedArguments(argc, argv, {"scenario"}))
+    {
+        args.push_back(arg);
+    }
+    return args;
+}
+
+std::vector<SimulationParameters>
+ValidateScenarios(const std::vector<Scenario>& scenarios, int argc, char* argv[])
+{
+    std::vector<SimulationParameters> result;
+    for (const auto& scenario : scenarios)
+    {
+        std::cout << "[SCENARIO] " << scenario.name << " (" << scenario.file << ", "
+                  << scenario.arguments.size() << " valori)" << std::endl;
+        std::vector<std::string> args = ScenarioArguments(scenario, argc, argv);
+        std::vector<char*> scenarioArgv = MakeArgv(args);
+
+        SimulationParameters params;
+        ns3::CommandLine cmd;
+        RegisterCommandLine(cmd, params);
+        cmd.Parse(static_cast<int>(args.size()), scenarioArgv.data());
+        ValidateParameters(params);
+
+        // i file mancanti si scoprono qui e non a metà del batch
+        std::vector<std::string> inputs = SplitList(params.demandFiles);
+        if (!params.topologyFile.empty())
+        {
+            inputs.push_back(params.topologyFile);
+        }
+        for (const auto& checkpoint : SplitList(params.qWarmStart))
+        {
+            inputs.push_back(checkpoint);
+        }
+        for (const auto& input : inputs)
+        {
+            NS_ABORT_MSG_IF(!std::filesystem::exists(input),
+                            "scenario " << scenario.name << ": file inesistente " << input);
+        }
+        result.push_back(params);
+    }
+    return result;
+}
+
+int
+RunScenarioBatch(const std::vector<Scenario>& scenarios,
+                 const std::vector<SimulationParameters>& scenarioParams,
+                 const SimulationParameters& params,
+                 int argc,
+                 char* argv[])
+{
+    for (size_t i = 0; i < scenarios.size(); ++i)
+    {
+        NS_ABORT_MSG_IF(scenarioParams[i].mpi,
+                        "scenario " << scenarios[i].name << ": mpi non è ammesso in un batch");
+    }
+
+    // jobs della riga di comando riguarda il batch; quello di uno scenario
+    // arriva comunque al figlio attraverso i valori del file
+    std::set<std::string> drop{"scenario", "jobs", "summaryFile"};
+    drop.insert(ChildInputOptions().begin(), ChildInputOptions().end());
+    std::vector<std::string> forwarded = ForwardedArguments(argc, argv, drop);
+
+    uint32_t jobs = ParallelJobs(params.jobs);
+    std::cout << "[SCENARIO] " << scenarios.size() << " scenari, " << jobs << " in parallelo"
+              << std::endl;
+
+    std::vector<ScenarioRun> runs(scenarios.size());
+    auto launch = [&](size_t index) {
+        const Scenario& scenario = scenarios[index];
+        ScenarioRun& run = runs[index];
+        run.workDir = AbsolutePath("scenarios/" + scenario.name);
+        std::string summaryPath = run.workDir + "/summary.txt";
+        std::remove(summaryPath.c_str());
+
+        std::vector<std::string> args{CurrentExecutable()};
+        args.insert(args.end(), scenario.arguments.begin(), scenario.arguments.end());
+        args.insert(args.end(), forwarded.begin(), forwarded.end());
+        for (const auto& arg : ChildInputArguments(scenarioParams[index]))
+        {
+            args.push_back(arg);
+        }
+        args.push_back("--summaryFile=" + summaryPath);
+
+        pid_t pid = LaunchChild(args, run.workDir, "run.log");
+        if (pid < 0)
+        {
+            std::cout << "[SCENARIO] avvio fallito per " << scenario.name << std::endl;
+        }
+        return pid;
+    };
+
+    size_t done = 0;
+    auto onExit = [&](size_t index, int exitStatus) {
+        ScenarioRun& run = runs[index];
+        done++;
+        run.exitStatus = exitStatus;
+        // gli scenari con sweep o repliche non scrivono un riepilogo singolo
+        run.summary.Read(run.workDir + "/summary.txt");
+        run.completed = exitStatus == 0;
+        std::cout << "[SCENARIO] " << done << "/" << runs.size() << " " << run.workDir
+                  << (run.completed ? " completato" : " fallito, vedi run.log") << std::endl;
+        return true;
+    };
+
+    RunChildPool(runs.size(), jobs, launch, onExit);
+
+    WriteResults("scenario_results.csv", scenarios, runs);
+
+    size_t failed = 0;
+    for (const auto& run : runs)
+    {
+        failed += run.completed ? 0 : 1;
+    }
+    std::cout << "[SCENARIO] risultati in scenario_results.csv (" << failed
+              << " scenari falliti)" << std::endl;
+    return failed == 0 ? 0 : 1;
+}
@@ -0,0 +1,55 @@
+#ifndef SCENARIO_RUNNER_H
+#define SCENARIO_RUNNER_H
+
+#include "simulation_parameters.h"
+
+#include <string>
+#include <vector>
+
+// Scenari descritti da file di testo, senza ricompilare. Ogni riga è
+// "chiave = valore" con il nome di un'opzione della riga di comando
+// (topologia, fasi del traffico, instradamento, output, RngRun, ...);
+// '#' inizia un commento. Una riga "[nome]" apre uno scenario che eredita
+// le righe precedenti la prima sezione; un file senza sezioni è un solo
+// scenario con il nome del file. I percorsi di ingresso (demandFiles,
+// topologyFile, qWarmStart) sono relativi alla directory del file.
+//
+// Esempio:
+//     topology = fattree
+//     topologySize = 8
+//     [carico_basso]
+//     loadFactor = 0.5
+//     [carico_alto]
+//     loadFactor = 1.5
+struct Scenario
+{
+    std::string name;
+    std::string file;
+    std::vector<std::string> arguments; // "--chiave=valore" nell'ordine del file
+};
+
+// legge i file (in ordine) e termina con errore se una riga non è valida o
+// due scenari hanno lo stesso nome
+std::vector<Scenario> LoadScenarios(const std::vector<std::string>& files);
+
+// argomenti di un'esecuzione dello scenario: argv[0], i valori del file e poi
+// quelli della riga di comando (senza --scenario), che hanno la precedenza
+std::vector<std::string> ScenarioArguments(const Scenario& scenario, int argc, char* argv[]);
+
+// interpreta e convalida tutti gli scenari prima di eseguirne uno: un'opzione
+// sconosciuta o un valore non valido terminano il processo indicando lo scenario
+std::vector<SimulationParameters> ValidateScenarios(const std::vector<Scenario>& scenarios,
+                                                    int argc,
+                                                    char* argv[]);
+
+// Esecuzione in batch: ogni scenario è una simulazione figlia in
+// scenarios/<nome>/, fino a jobs alla volta; i riepiloghi sono uniti in
+// scenario_results.csv, una riga per scenario.
+// Restituisce il codice di uscita del processo (1 se qualche scenario fallisce).
+int RunScenarioBatch(const std::vector<Scenario>& scenarios,
+                     const std::vector<SimulationParameters>& scenarioParams,
+                     const SimulationParameters& params,
+                     int argc,
+                     char* argv[]);
+
+#endif // SCENARIO_RUNNER_H
@@ -0,0 +1,356 @@
+#include "simulation_parameters.h"
+
+#include "packet_size_distribution.h"
+
+#include "ns3/abort.h"
+#include "ns3/queue-disc.h"
+#include "ns3/queue-size.h"
+#include "ns3/type-id.h"
+
+namespace
+{
+
+// la radice è installata con l'attributo MaxSize e, a parte PfifoFast, senza
+// code o classi figlie: le QueueDisc classful non avrebbero dove accodare
+void
+ValidateQueueDisc(const std::string& name, const std::string& option)
+{
+    ns3::TypeId tid;
+    NS_ABORT_MSG_IF(!ns3::TypeId::LookupByNameFailSafe(name, &tid) ||
+                        !tid.IsChildOf(ns3::QueueDisc::GetTypeId()),
+                    option << " non è una QueueDisc: " << name);
+    NS_ABORT_MSG_IF(name == "ns3::PrioQueueDisc" || name == "ns3::MqQueueDisc",
+                    option << ": " << name << " è classful e richiede QueueDisc figlie");
+    ns3::TypeId::AttributeInformation info;
+    NS_ABORT_MSG_IF(!tid.LookupAttributeByName("MaxSize", &info),
+                    option << ": " << name << " non ha l'attributo MaxSize");
+}
+
+} // namespace
+
+void
+RegisterCommandLine(ns3::CommandLine& cmd, SimulationParameters& params)
+{
+    cmd.AddValue("tcpMode", "TCP workload: none, bulk or reqresp", params.tcpMode);
+    cmd.AddValue("tcpScale", "Demand matrix scale factor for TCP", params.tcpScale);
+    cmd.AddValue("tcpPort", "Port of the TCP sinks", params.tcpPort);
+    cmd.AddValue("tcpRequestSize", "Request size in bytes (reqresp)", params.tcpRequestSize);
+    cmd.AddValue("tcpResponseSize", "Response size in bytes (reqresp)", params.tcpResponseSize);
+    cmd.AddValue("tcpThinkTime",
+                 "Seconds between a response and the next request (reqresp)",
+                 params.tcpThinkTime);
+    cmd.AddValue("topology",
+                 "Router topology: abilene, fattree, geometric, waxman, ringofrings or file",
+                 params.topology);
+    cmd.AddValue("topologyFile",
+                 "SNDlib XML or GraphML topology file (topology=file)",
+                 params.topologyFile);
+    cmd.AddValue("topologyCapacityScale",
+                 "Conversion of the capacities in topologyFile to Mbps",
+                 params.topologyCapacityScale);
+    cmd.AddValue("topologySize",
+                 "Routers of a generated topology (fattree: port count k)",
+                 params.topologySize);
+    cmd.AddValue("topologyRings", "Access rings of a ringofrings topology", params.topologyRings);
+    cmd.AddValue("topologyRadius",
+                 "Connection radius of a geometric topology (unit square)",
+                 params.topologyRadius);
+    cmd.AddValue("waxmanAlpha", "Waxman distance decay", params.waxmanAlpha);
+    cmd.AddValue("waxmanBeta", "Waxman link density", params.waxmanBeta);
+    cmd.AddValue("topologyCapacity",
+                 "Link capacity of a generated topology, or of file links without one (Mbps)",
+                 params.topologyCapacity);
+    cmd.AddValue("topologyDelay",
+                 "Link delay of abilene, fattree, ringofrings and coordinate-less file links (ms)",
+                 params.topologyDelay);
+    cmd.AddValue("topologySpanDelay",
+                 "Delay across the unit square side for geometric and waxman topologies (ms)",
+                 params.topologySpanDelay);
+    cmd.AddValue("topologySeed", "Seed of the random topology generators", params.topologySeed);
+    cmd.AddValue("dags",
+                 "Per-destination DAGs: static (hand-written, Abilene only), computed or auto",
+                 params.dags);
+    cmd.AddValue("dagMetric",
+                 "Link cost of computed DAGs: hops, delay or capacity",
+                 params.dagMetric);
+    cmd.AddValue("dagStretch",
+                 "Admit successors whose path costs up to this factor times the shortest",
+                 params.dagStretch);
+    cmd.AddValue("normalRouting",
+                 "Routing of normal traffic: ripng, static (shortest paths) or auto",
+                 params.normalRouting);
+    cmd.AddValue("topologyFlows",
+                 "Random pairs per demand matrix of a generated topology (0 = 2 per router)",
+                 params.topologyFlows);
+    cmd.AddValue("topologyDemand",
+                 "Mean rate per pair of a generated topology (Mbps, before scaling)",
+                 params.topologyDemand);
+    cmd.AddValue("demandFiles",
+                 "Comma-separated SNDlib demand files (native or XML)",
+                 params.demandFiles);
+    cmd.AddValue("demandUnitScale",
+                 "Factor converting demand file values to Mbps",
+                 params.demandUnitScale);
+    cmd.AddValue("normalMatrix", "Matrix index for normal traffic", params.normalMatrix);
+    cmd.AddValue("sensitiveMatrix",
+                 "Matrix index for delay-sensitive traffic",
+                 params.sensitiveMatrix);
+    cmd.AddValue("normalScale", "Demand scale factor for normal traffic", params.normalScale);
+    cmd.AddValue("sensitiveScale",
+                 "Demand scale factor for delay-sensitive traffic",
+                 params.sensitiveScale);
+    cmd.AddValue("loadFactor", "Multiplier applied to both scale factors", params.loadFactor);
+    cmd.AddValue("trafficStart", "Start of the traffic window (s)", params.trafficStart);
+    cmd.AddValue("trafficStop", "End of the traffic window (s)", params.trafficStop);
+    cmd.AddValue("stopTime", "Simulation stop time (s)", params.stopTime);
+    cmd.AddValue("packetSize",
+                 "UDP packet size: bytes, 'imix', 'uniform:MIN:MAX' or 'SIZE:WEIGHT,...'",
+                 params.packetSize);
+    cmd.AddValue("exchangeInterval",
+                 "Interval between queue state exchanges of neighbouring routers (s)",
+                 params.exchangeInterval);
+    cmd.AddValue("exchangeStart",
+                 "Start time of the queue state senders (s)",
+                 params.exchangeStart);
+    cmd.AddValue("queueDisc", "Root queue disc TypeId on router links", params.queueDisc);
+    cmd.AddValue("queueMaxSize",
+                 "MaxSize of the router link queue discs (e.g. 500000p or 10MB)",
+                 params.queueMaxSize);
+    cmd.AddValue("qCheckpointTime",
+                 "Time at which the Q-registers are saved to qCheckpointFile (s, 0 = never)",
+                 params.qCheckpointTime);
+    cmd.AddValue("qCheckpointFile",
+                 "Q-register checkpoint written at qCheckpointTime",
+                 params.qCheckpointFile);
+    cmd.AddValue("qWarmStart",
+                 "Comma-separated Q-register checkpoints loaded at start-up",
+                 params.qWarmStart);
+    cmd.AddValue("histogramInterval",
+                 "Interval of the per-flow latency percentile report (s, 0 = end only)",
+                 params.histogramInterval);
+    cmd.AddValue("hopRecords",
+                 "Record per-hop timestamps and write per-link delays to hop_delay_stats.csv",
+                 params.hopRecords);
+    cmd.AddValue("pathTracing",
+                 "Tag packets with a path id and write per-pair path usage to path_stats.csv",
+                 params.pathTracing);
+    cmd.AddValue("flowMonitor",
+                 "Per-class FlowMonitor statistics in flow_monitor_stats.csv",
+                 params.flowMonitor);
+    cmd.AddValue("capture", "Enable PCAP capture", params.capture);
+    cmd.AddValue("captureLinks",
+                 "Links to capture: 'all' or a list such as 'ATLAng-HSTNng,ATLAng[HOST]'",
+                 params.captureLinks);
+    cmd.AddValue("captureSnaplen", "Bytes recorded per packet", params.captureSnaplen);
+    cmd.AddValue("captureSampling",
+                 "Capture one packet every N per device",
+                 params.captureSampling);
+    cmd.AddValue("captureStart", "Start of the capture window (s)", params.captureStart);
+    cmd.AddValue("captureStop",
+                 "End of the capture window (s, 0 = end of run)",
+                 params.captureStop);
+    cmd.AddValue("captureRing",
+                 "Per-device ring buffer written only around latency triggers (0 = off)",
+                 params.captureRing);
+    cmd.AddValue("captureTriggerMs",
+                 "Latency above which the capture ring is flushed (ms)",
+                 params.captureTriggerMs);
+    cmd.AddValue("captureTriggerClass",
+                 "Traffic class checked by the capture trigger",
+                 params.captureTriggerClass);
+    cmd.AddValue("progressInterval",
+                 "Simulated seconds between progress checks (0 = no progress report)",
+                 params.progressInterval);
+    cmd.AddValue("progressWallInterval",
+                 "Minimum wall-clock seconds between two JSON progress lines",
+                 params.progressWallInterval);
+    cmd.AddValue("queueChangeLog",
+                 "Log every queue occupancy change to queue_lengths.csv (opt-in, large)",
+                 params.queueChangeLog);
+    cmd.AddValue("latencyLog",
+                 "Binary per-packet latency log (empty = disabled)",
+                 params.latencyLog);
+    cmd.AddValue("convertLatencyLog",
+                 "Convert this binary latency log to per-class CSV files and exit",
+                 params.convertLatencyLog);
+    cmd.AddValue("summaryFile", "Write a key=value run summary to this file", params.summaryFile);
+    cmd.AddValue("setupOnly",
+                 "Build the topology and exit before running, reporting set-up times",
+                 params.setupOnly);
+    cmd.AddValue("printQRegisters",
+                 "Print the initial Q-registers of the local routers",
+                 params.printQRegisters);
+    cmd.AddValue("targetClass", "Traffic class of the service target (0 or 1)", params.targetClass);
+    cmd.AddValue("targetPercentile", "Latency percentile of the target", params.targetPercentile);
+    cmd.AddValue("targetLatencyMs",
+                 "Latency target at targetPercentile in ms (0 = ignored)",
+                 params.targetLatencyMs);
+    cmd.AddValue("targetLoss", "Loss rate target (negative = ignored)", params.targetLoss);
+    cmd.AddValue("earlyStopFactor",
+                 "Stop the run once the target is exceeded by this factor (0 = never)",
+                 params.earlyStopFactor);
+    cmd.AddValue("searchScale",
+                 "Bisect loadFactor to find the highest load meeting the target",
+                 params.searchScale);
+    cmd.AddValue("searchLow", "Lower bound of the loadFactor search", params.searchLow);
+    cmd.AddValue("searchHigh", "Upper bound of the loadFactor search", params.searchHigh);
+    cmd.AddValue("searchIterations", "Maximum bisection steps", params.searchIterations);
+    cmd.AddValue("searchTolerance",
+                 "Stop when the interval is this fraction of its upper bound",
+                 params.searchTolerance);
+    cmd.AddValue("searchDuration",
+                 "Traffic duration of each search run (s)",
+                 params.searchDuration);
+    cmd.AddValue("sweep",
+                 "Run the grid of the sweep* lists as parallel child simulations",
+                 params.sweep);
+    cmd.AddValue("sweepLoad", "Comma-separated loadFactor values", params.sweepLoad);
+    cmd.AddValue("sweepMatrix",
+                 "Comma-separated demand matrices: sensitive index or 'normal:sensitive'",
+                 params.sweepMatrix);
+    cmd.AddValue("sweepSeed", "Comma-separated RngRun values", params.sweepSeed);
+    cmd.AddValue("sweepExchange",
+                 "Comma-separated exchangeInterval values (s)",
+                 params.sweepExchange);
+    cmd.AddValue("sweepQueueDisc", "Comma-separated queue disc TypeIds", params.sweepQueueDisc);
+    cmd.AddValue("jobs", "Concurrent child simulations (0 = one per core)", params.jobs);
+    cmd.AddValue("replications",
+                 "Run up to this many replications with consecutive RngRun values (0 = off)",
+                 params.replications);
+    cmd.AddValue("replicationsMin",
+                 "Replications to complete before checking the confidence intervals",
+                 params.replicationsMin);
+    cmd.AddValue("replicationPrecision",
+                 "Stop once every 95% CI half-width is within this fraction of the mean "
+                 "(0 = run all replications)",
+                 params.replicationPrecision);
+    cmd.AddValue("mpi", "Run distributed with MPI, one topology partition per rank", params.mpi);
+    cmd.AddValue("scenario",
+                 "Comma-separated scenario files; more than one scenario runs a batch",
+                 params.scenario);
+}
+
+void
+ValidateParameters(const SimulationParameters& params)
+{
+    NS_ABORT_MSG_IF(params.tcpMode != "none" && params.tcpMode != "bulk" &&
+                        params.tcpMode != "reqresp",
+                    "tcpMode deve essere none, bulk o reqresp: " << params.tcpMode);
+    NS_ABORT_MSG_IF(params.tcpScale <= 0, "tcpScale deve essere positivo");
+    NS_ABORT_MSG_IF(params.tcpRequestSize == 0 || params.tcpResponseSize == 0,
+                    "tcpRequestSize e tcpResponseSize devono essere positivi");
+    NS_ABORT_MSG_IF(params.demandUnitScale <= 0, "demandUnitScale deve essere positivo");
+    NS_ABORT_MSG_IF(params.topology != "abilene" && params.topology != "fattree" &&
+                        params.topology != "geometric" && params.topology != "waxman" &&
+                        params.topology != "ringofrings" && params.topology != "file",
+                    "topologia sconosciuta: " << params.topology);
+    NS_ABORT_MSG_IF((params.topology == "file") == params.topologyFile.empty(),
+                    "topologyFile va indicato se e solo se topology=file");
+    NS_ABORT_MSG_IF(params.topologyCapacityScale <= 0,
+                    "topologyCapacityScale deve essere positivo");
+    NS_ABORT_MSG_IF(params.topology == "fattree" &&
+                        (params.topologySize < 2 || params.topologySize % 2 != 0),
+                    "fattree: topologySize (k) deve essere pari e >= 2");
+    NS_ABORT_MSG_IF(params.topology != "abilene" && params.topology != "fattree" &&
+                        params.topology != "file" && params.topologySize < 2,
+                    "topologySize deve essere almeno 2");
+    NS_ABORT_MSG_IF(params.topology == "ringofrings" &&
+                        (params.topologyRings == 0 ||
+                         params.topologySize < 3 * params.topologyRings),
+                    "ringofrings: servono almeno 3 router per anello");
+    NS_ABORT_MSG_IF(params.topologyRadius <= 0, "topologyRadius deve essere positivo");
+    NS_ABORT_MSG_IF(params.waxmanAlpha <= 0 || params.waxmanBeta <= 0 || params.waxmanBeta > 1,
+                    "serve waxmanAlpha > 0 e 0 < waxmanBeta <= 1");
+    NS_ABORT_MSG_IF(params.topologyCapacity <= 0 || params.topologyDelay < 0 ||
+                        params.topologySpanDelay < 0,
+                    "capacità e ritardi della topologia non validi");
+    NS_ABORT_MSG_IF(params.dags != "auto" && params.dags != "static" && params.dags != "computed",
+                    "dags deve essere auto, static o computed: " << params.dags);
+    NS_ABORT_MSG_IF(params.dags == "static" && params.topology != "abilene",
+                    "i DAG statici esistono solo per la topologia abilene");
+    NS_ABORT_MSG_IF(params.dagMetric != "hops" && params.dagMetric != "delay" &&
+                        params.dagMetric != "capacity",
+                    "dagMetric deve essere hops, delay o capacity: " << params.dagMetric);
+    NS_ABORT_MSG_IF(params.dagStretch < 1.0, "dagStretch deve essere >= 1");
+    NS_ABORT_MSG_IF(params.normalRouting != "auto" && params.normalRouting != "ripng" &&
+                        params.normalRouting != "static",
+                    "normalRouting deve essere auto, ripng o static: " << params.normalRouting);
+    NS_ABORT_MSG_IF(params.topologyDemand < 0, "topologyDemand non può essere negativo");
+    ValidatePacketSizeSpec(params.packetSize);
+    NS_ABORT_MSG_IF(params.normalScale < 0 || params.sensitiveScale < 0 || params.loadFactor < 0,
+                    "i fattori di scala non possono essere negativi");
+    NS_ABORT_MSG_IF(params.trafficStart >= params.trafficStop ||
+                        params.trafficStop > params.stopTime,
+                    "serve trafficStart < trafficStop <= stopTime");
+    NS_ABORT_MSG_IF(params.exchangeInterval <= 0, "exchangeInterval deve essere positivo");
+    NS_ABORT_MSG_IF(params.exchangeStart < 0 || params.exchangeStart >= params.stopTime,
+                    "serve 0 <= exchangeStart < stopTime");
+    ns3::QueueSizeValue maxSize;
+    NS_ABORT_MSG_IF(!maxSize.DeserializeFromString(params.queueMaxSize, nullptr),
+                    "queueMaxSize non valido: " << params.queueMaxSize);
+    NS_ABORT_MSG_IF(params.qCheckpointTime < 0 || params.qCheckpointTime > params.stopTime,
+                    "serve 0 <= qCheckpointTime <= stopTime");
+    NS_ABORT_MSG_IF(params.qCheckpointTime > 0 && params.qCheckpointFile.empty(),
+                    "qCheckpointTime richiede qCheckpointFile");
+    ValidateQueueDisc(params.queueDisc, "queueDisc");
+    for (const auto& queueDisc : SplitList(params.sweepQueueDisc))
+    {
+        ValidateQueueDisc(queueDisc, "sweepQueueDisc");
+    }
+    NS_ABORT_MSG_IF(params.histogramInterval < 0, "histogramInterval non può essere negativo");
+    NS_ABORT_MSG_IF(params.progressInterval < 0 || params.progressWallInterval < 0,
+                    "progressInterval e progressWallInterval non possono essere negativi");
+    NS_ABORT_MSG_IF(params.capture && params.captureSnaplen == 0, "captureSnaplen deve essere > 0");
+    NS_ABORT_MSG_IF(params.capture && params.captureRing > 0 && params.captureTriggerMs <= 0,
+                    "captureRing richiede captureTriggerMs");
+    NS_ABORT_MSG_IF(params.captureStop > 0 && params.captureStop <= params.captureStart,
+                    "serve captureStart < captureStop");
+    NS_ABORT_MSG_IF(params.targetClass > 1, "targetClass deve essere 0 o 1");
+    NS_ABORT_MSG_IF(params.targetPercentile <= 0 || params.targetPercentile > 100,
+                    "targetPercentile deve essere in (0, 100]");
+    NS_ABORT_MSG_IF(params.searchScale && params.targetLatencyMs <= 0 && params.targetLoss < 0,
+                    "la ricerca del carico richiede targetLatencyMs o targetLoss");
+    NS_ABORT_MSG_IF(params.searchScale &&
+                        (params.searchLow <= 0 || params.searchLow >= params.searchHigh),
+                    "serve 0 < searchLow < searchHigh");
+    NS_ABORT_MSG_IF(params.sweep && params.searchScale,
+                    "sweep e searchScale non possono essere usati insieme");
+    NS_ABORT_MSG_IF(params.replications > 0 && (params.sweep || params.searchScale),
+                    "replications non può essere usato con sweep o searchScale");
+    NS_ABORT_MSG_IF(params.replications > 0 && params.replicationsMin < 2,
+                    "replicationsMin deve essere almeno 2");
+    NS_ABORT_MSG_IF(params.replicationPrecision < 0,
+                    "replicationPrecision non può essere negativo");
+    NS_ABORT_MSG_IF(params.mpi && (params.sweep || params.searchScale || params.replications > 0),
+                    "mpi non può essere usato con sweep, searchScale o replications");
+    NS_ABORT_MSG_IF(params.mpi && params.setupOnly, "setupOnly non è supportato con mpi");
+    // i collegamenti tra rank devono avere un ritardo (lookahead) positivo
+    NS_ABORT_MSG_IF(params.mpi && params.topologyDelay <= 0 && params.topology != "geometric" &&
+                        params.topology != "waxman",
+                    "mpi richiede topologyDelay > 0");
+    NS_ABORT_MSG_IF(params.setupOnly && params.searchScale,
+                    "setupOnly non produce le latenze richieste da searchScale");
+    NS_ABORT_MSG_IF(params.mpi && params.earlyStopFactor > 0,
+                    "earlyStopFactor non è supportato con mpi");
+}
+
+std::vector<std::string>
+SplitList(const std::string& list)
+{
+    std::vector<std::string> items;
+    size_t start = 0;
+    while (start <= list.size())
+    {
+        size_t comma = list.find(',', start);
+        if (comma == std::string::npos)
+        {
+            comma = list.size();
+        }
+        if (comma > start)
+        {
+            items.push_back(list.substr(start, comma - start));
+        }
+        start = comma + 1;
+    }
+    return items;
+}
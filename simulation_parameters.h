@@ -0,0 +1,167 @@
+#ifndef SIMULATION_PARAMETERS_H
+#define SIMULATION_PARAMETERS_H
+
+#include "ns3/command-line.h"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Parametri della simulazione modificabili da riga di comando
+struct SimulationParameters
+{
+    // carico TCP delay-sensitive: "none", "bulk" oppure "reqresp"
+    std::string tcpMode{"none"};
+    double tcpScale{0.01};           // scala della matrice di domanda per il TCP
+    uint16_t tcpPort{10000};
+    uint32_t tcpRequestSize{200};    // byte
+    uint32_t tcpResponseSize{20000}; // byte
+    double tcpThinkTime{0.05};       // secondi tra una risposta e la richiesta successiva
+
+    // topologia dei router: "abilene", un generatore di topology_generator.h
+    // ("fattree", "geometric", "waxman", "ringofrings") o "file" (topology_loader.h)
+    std::string topology{"abilene"};
+    std::string topologyFile;          // SNDlib XML o GraphML (topology=file)
+    double topologyCapacityScale{1.0}; // conversione delle capacità del file in Mbps
+    uint32_t topologySize{50};      // router (fattree: numero di porte k)
+    uint32_t topologyRings{5};      // anelli di accesso (ringofrings)
+    double topologyRadius{0.2};     // raggio di connessione (geometric)
+    double waxmanAlpha{0.15};
+    double waxmanBeta{0.2};
+    double topologyCapacity{10.0};  // Mbps per link (file: se manca nel file)
+    double topologyDelay{1.0};      // ms per link (tranne geometric e waxman)
+    double topologySpanDelay{10.0}; // ms per il lato del quadrato (geometric, waxman)
+    uint32_t topologySeed{1};
+    // DAG per destinazione: "static" (dag_database.cc, solo Abilene), "computed"
+    // (dag_builder.h) o "auto" (static per Abilene, computed altrimenti)
+    std::string dags{"auto"};
+    std::string dagMetric{"hops"}; // costo dei link: hops, delay o capacity
+    double dagStretch{1.0};        // 1 = ECMP, > 1 ammette percorsi più lunghi
+    // instradamento del traffico normale: "ripng", "static" (cammini minimi
+    // calcolati dalla topologia, senza limite di salti) o "auto" (ripng se il
+    // diametro è sotto i 16 salti, oltre i quali RIPng considera la rete
+    // irraggiungibile, static altrimenti)
+    std::string normalRouting{"auto"};
+    // matrici di domanda casuali delle topologie generate
+    uint32_t topologyFlows{0};   // coppie per matrice, 0 = due per router
+    double topologyDemand{10.0}; // rate medio per coppia (Mbps, prima delle scale)
+
+    // matrici di domanda da file SNDlib (separate da virgola); se vuoto si usano
+    // quelle compilate in flow_demand_dataset.cc
+    std::string demandFiles;
+    double demandUnitScale{1.0}; // conversione dell'unità del file in Mbps
+    uint32_t normalMatrix{1};    // indice della matrice per il traffico normale
+    uint32_t sensitiveMatrix{0}; // indice della matrice per il traffico delay-sensitive
+
+    // intensità del traffico UDP: scala della matrice per classe, moltiplicata
+    // per un fattore di carico comune
+    double normalScale{0.248};
+    double sensitiveScale{0.023};
+    double loadFactor{1.0};
+    double trafficStart{20.0}; // secondi
+    double trafficStop{80.0};  // secondi
+    double stopTime{140.0};    // secondi
+    // dimensione dei pacchetti UDP: byte, "imix", "uniform:MIN:MAX" o
+    // "DIM:PESO,..." (vedi packet_size_distribution.h)
+    std::string packetSize{"1000"};
+
+    // intervallo di scambio dello stato delle code tra router vicini (s)
+    double exchangeInterval{0.01};
+    double exchangeStart{2.0}; // avvio dei sender dello stato delle code (s)
+    // QueueDisc radice sui collegamenti tra router e sua dimensione massima
+    std::string queueDisc{"ns3::PfifoFastQueueDisc"};
+    std::string queueMaxSize{"500000p"};
+    // checkpoint dei Q-register (vedi qregister_checkpoint.h): salvataggio
+    // all'istante qCheckpointTime (0 = mai) e caricamento all'avvio da
+    // qWarmStart (file separati da virgole, ad esempio uno per rank MPI)
+    double qCheckpointTime{0.0};
+    std::string qCheckpointFile{"qregisters.ckpt"};
+    std::string qWarmStart;
+
+    // percentili di latenza per flusso ogni histogramInterval secondi
+    // (0 = solo a fine simulazione)
+    double histogramInterval{10.0};
+    // registro dei salti nei pacchetti delay-sensitive e ritardi per collegamento
+    bool hopRecords{false};
+    // percorsi seguiti dai pacchetti delay-sensitive per coppia di host
+    bool pathTracing{false};
+    // statistiche FlowMonitor per flusso e classe in flow_monitor_stats.csv
+    bool flowMonitor{false};
+    // cattura PCAP selettiva (disattivata di default)
+    bool capture{false};
+    std::string captureLinks{"all"}; // "A-B" e "A[HOST]" separati da virgole, o "all"
+    uint32_t captureSnaplen{96};     // byte per pacchetto: bastano gli header
+    uint32_t captureSampling{1};     // 1 pacchetto ogni N per dispositivo
+    double captureStart{0.0};        // finestra di cattura, secondi
+    double captureStop{0.0};         // 0 = fino alla fine
+    uint32_t captureRing{0};         // > 0: ring buffer scaricato solo sui trigger
+    double captureTriggerMs{0.0};    // soglia di latenza che fa scattare il trigger
+    uint32_t captureTriggerClass{1};
+
+    // avanzamento in JSON ogni progressInterval secondi simulati (0 = mai),
+    // al massimo uno ogni progressWallInterval secondi reali
+    double progressInterval{1.0};
+    double progressWallInterval{5.0};
+
+    // registro di ogni variazione delle code in queue_lengths.csv: una riga per
+    // accodamento e prelievo, solo su richiesta (le statistiche non lo usano)
+    bool queueChangeLog{false};
+    // log binario delle latenze per pacchetto ("" = disabilitato)
+    std::string latencyLog;
+    // se indicato, converte questo log nei CSV per classe ed esce
+    std::string convertLatencyLog;
+
+    // riepilogo chiave=valore scritto a fine esecuzione (letto dai driver)
+    std::string summaryFile;
+    // solo set-up, senza simulare: misura i tempi di avvio sulle topologie grandi
+    bool setupOnly{false};
+    // stampa dei Q-register iniziali (molto lunga con migliaia di router)
+    bool printQRegisters{true};
+
+    // obiettivo di servizio: percentile di latenza e/o perdita di una classe
+    uint32_t targetClass{1};
+    double targetPercentile{99.0};
+    double targetLatencyMs{0.0}; // 0 = non considerato
+    double targetLoss{0.01};     // negativo = non considerato
+    // interrompe la simulazione quando l'obiettivo è superato di questo fattore
+    // (0 = mai); le esecuzioni della ricerca del carico usano 2 se non indicato
+    double earlyStopFactor{0.0};
+
+    // ricerca per bisezione del massimo loadFactor che rispetta l'obiettivo
+    bool searchScale{false};
+    double searchLow{0.1};
+    double searchHigh{4.0};
+    uint32_t searchIterations{8};
+    double searchTolerance{0.02}; // ampiezza relativa dell'intervallo finale
+    double searchDuration{10.0};  // durata del traffico in ogni prova, secondi
+
+    // sweep di parametri in parallelo (vedi sweep_runner.h): liste separate
+    // da virgole, vuote = valore corrente
+    bool sweep{false};
+    std::string sweepLoad;      // valori di loadFactor
+    std::string sweepMatrix;    // "S" (matrice delay-sensitive) o "N:S"
+    std::string sweepSeed;      // valori di RngRun
+    std::string sweepExchange;  // valori di exchangeInterval
+    std::string sweepQueueDisc; // TypeId di QueueDisc
+    uint32_t jobs{0};           // simulazioni contemporanee, 0 = una per core
+
+    // repliche con RngRun diversi e intervalli di confidenza (vedi replication_runner.h)
+    uint32_t replications{0};          // numero massimo di repliche, 0 = esecuzione singola
+    uint32_t replicationsMin{3};       // repliche prima di valutare l'arresto anticipato
+    double replicationPrecision{0.05}; // semiampiezza relativa richiesta, 0 = tutte le repliche
+    // simulazione distribuita: una partizione della topologia per rank MPI
+    bool mpi{false};
+    // file di scenario separati da virgole (vedi scenario_runner.h); più di
+    // uno scenario in totale = esecuzione in batch
+    std::string scenario;
+};
+
+// divide una lista separata da virgole, ignorando gli elementi vuoti
+std::vector<std::string> SplitList(const std::string& list);
+
+void RegisterCommandLine(ns3::CommandLine& cmd, SimulationParameters& params);
+
+// termina con errore se i parametri non sono coerenti
+void ValidateParameters(const SimulationParameters& params);
+
+#endif // SIMULATION_PARAMETERS_H
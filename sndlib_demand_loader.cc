@@ -0,0 +1,562 @@
+#include "sndlib_demand_loader.h"
+
+#include "topology_loader.h"
+#include "xml_lite.h"
+
+#include "ns3/abort.h"
+
+#include <cstring>
+#include <fcntl.h>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <unordered_map>
+
+namespace
+{
+
+const char kCacheMagic[8] = {'Q', 'D', 'M', 'C', 'A', 'C', 'H', 'E'};
+const uint32_t kCacheVersion = 1;
+
+uint64_t
+AlignTo8(uint64_t v)
+{
+    return (v + 7) & ~static_cast<uint64_t>(7);
+}
+
+bool
+ReadFile(const std::string& path, std::string& content)
+{
+    std::ifstream in(path, std::ios::binary);
+    if (!in)
+    {
+        return false;
+    }
+    std::ostringstream ss;
+    ss << in.rdbuf();
+    content = ss.str();
+    return true;
+}
+
+// tabella dei nomi dei nodi in ordine di prima apparizione
+struct NameTable
+{
+    std::vector<std::string> names;
+    std::unordered_map<std::string, uint32_t> index;
+
+    uint32_t Intern(const std::string& name)
+    {
+        auto [it, inserted] = index.emplace(name, static_cast<uint32_t>(names.size()));
+        if (inserted)
+        {
+            names.push_back(name);
+        }
+        return it->second;
+    }
+};
+
+struct ParsedDemand
+{
+    uint32_t src;
+    uint32_t dst;
+    double value;
+};
+
+// sezione DEMANDS del formato nativo:
+//   <demand_id> ( <source> <target> ) <routing_unit> <demand_value> <max_path_length>
+bool
+ParseNative(const std::string& content,
+            NameTable& names,
+            std::vector<ParsedDemand>& demands,
+            std::string& error)
+{
+    size_t section = content.find("DEMANDS");
+    while (section != std::string::npos)
+    {
+        // la parola deve essere all'inizio di una riga (non in un commento)
+        size_t lineStart = content.rfind('\n', section);
+        lineStart = (lineStart == std::string::npos) ? 0 : lineStart + 1;
+        if (content.find_first_not_of(" \t", lineStart) == section)
+        {
+            break;
+        }
+        section = content.find("DEMANDS", section + 1);
+    }
+    if (section == std::string::npos)
+    {
+        error = "sezione DEMANDS non trovata";
+        return false;
+    }
+
+    // tokenizzazione: le parentesi sono token separati, i commenti '#' arrivano a fine riga
+    std::vector<std::string> tokens;
+    std::string current;
+    bool inComment = false;
+    for (size_t i = section + std::strlen("DEMANDS"); i < content.size(); ++i)
+    {
+        char c = content[i];
+        if (inComment)
+        {
+            inComment = (c != '\n');
+            continue;
+        }
+        if (c == '#' || c == '(' || c == ')' || std::isspace(static_cast<unsigned char>(c)))
+        {
+            if (!current.empty())
+            {
+                tokens.push_back(current);
+                current.clear();
+            }
+            if (c == '#')
+            {
+                inComment = true;
+            }
+            else if (c == '(' || c == ')')
+            {
+                tokens.emplace_back(1, c);
+                // la sezione termina con la ')' che chiude "DEMANDS ("
+                if (c == ')' && tokens.size() % 8 == 2)
+                {
+                    break;
+                }
+            }
+            continue;
+        }
+        current += c;
+    }
+
+    if (tokens.empty() || tokens.front() != "(")
+    {
+        error = "sezione DEMANDS malformata";
+        return false;
+    }
+
+    // dopo la '(' di apertura, gruppi di 8 token fino alla ')' finale
+    size_t i = 1;
+    while (i < tokens.size() && tokens[i] != ")")
+    {
+        if (i + 7 >= tokens.size() || tokens[i + 1] != "(" || tokens[i + 4] != ")")
+        {
+            error = "domanda malformata vicino a '" + tokens[i] + "'";
+            return false;
+        }
+        try
+        {
+            ParsedDemand d;
+            d.src = names.Intern(tokens[i + 2]);
+            d.dst = names.Intern(tokens[i + 3]);
+            d.value = std::stod(tokens[i + 6]);
+            demands.push_back(d);
+        }
+        catch (const std::exception&)
+        {
+            error = "valore non numerico nella domanda " + tokens[i];
+            return false;
+        }
+        i += 8;
+    }
+    return true;
+}
+
+bool
+ParseXmlDemands(const std::string& content,
+                NameTable& names,
+                std::vector<ParsedDemand>& demands,
+                std::string& error)
+{
+    std::unique_ptr<XmlElement> root = ParseXml(content, error);
+    if (!root)
+    {
+        return false;
+    }
+
+    const XmlElement* demandsElement = root->Child("demands");
+    if (!demandsElement)
+    {
+        error = "elemento <demands> non trovato";
+        return false;
+    }
+
+    for (const XmlElement* d : demandsElement->Children("demand"))
+    {
+        std::string src = d->ChildText("source");
+        std::string dst = d->ChildText("target");
+        std::string value = d->ChildText("demandValue");
+        if (src.empty() || dst.empty() || value.empty())
+        {
+            error = "domanda incompleta: " + d->Attribute("id");
+            return false;
+        }
+        try
+        {
+            demands.push_back({names.Intern(src), names.Intern(dst), std::stod(value)});
+        }
+        catch (const std::exception&)
+        {
+            error = "valore non numerico nella domanda " + d->Attribute("id");
+            return false;
+        }
+    }
+    return true;
+}
+
+} // namespace
+
+MappedDemandMatrix::~MappedDemandMatrix()
+{
+    Release();
+}
+
+MappedDemandMatrix::MappedDemandMatrix(MappedDemandMatrix&& other) noexcept
+{
+    *this = std::move(other);
+}
+
+MappedDemandMatrix&
+MappedDemandMatrix::operator=(MappedDemandMatrix&& other) noexcept
+{
+    if (this != &other)
+    {
+        Release();
+        m_mapped = other.m_mapped;
+        m_fromCache = other.m_fromCache;
+        m_ownedImage = std::move(other.m_ownedImage);
+        if (m_mapped)
+        {
+            Attach(other.m_base, other.m_length);
+        }
+        else if (!m_ownedImage.empty())
+        {
+            Attach(m_ownedImage.data(), m_ownedImage.size());
+        }
+        other.m_base = nullptr;
+        other.m_length = 0;
+        other.m_mapped = false;
+        other.m_header = nullptr;
+    }
+    return *this;
+}
+
+void
+MappedDemandMatrix::Release()
+{
+    if (m_mapped && m_base)
+    {
+        munmap(const_cast<uint8_t*>(m_base), m_length);
+    }
+    m_base = nullptr;
+    m_length = 0;
+    m_mapped = false;
+    m_header = nullptr;
+    m_names = nullptr;
+    m_nameChars = nullptr;
+    m_entries = nullptr;
+}
+
+bool
+MappedDemandMatrix::Attach(const uint8_t* base, size_t length)
+{
+    if (length < sizeof(Header))
+    {
+        return false;
+    }
+    const Header* h = reinterpret_cast<const Header*>(base);
+    // la tabella dei nomi segue l'header, poi i nomi e, allineate a 8 byte, le domande
+    if (std::memcmp(h->magic, kCacheMagic, sizeof(kCacheMagic)) != 0 ||
+        h->version != kCacheVersion || h->fileSize != length ||
+        h->namesOffset != sizeof(Header) + uint64_t(h->nodeCount) * sizeof(NameRef) ||
+        h->namesOffset > h->entriesOffset || h->entriesOffset > length ||
+        h->entriesOffset % 8 != 0 ||
+        h->entryCount > (length - h->entriesOffset) / sizeof(Entry))
+    {
+        return false;
+    }
+
+    // il file viene dal disco: nessun indice può uscire dalla propria regione
+    const NameRef* names = reinterpret_cast<const NameRef*>(base + sizeof(Header));
+    uint64_t namesBytes = h->entriesOffset - h->namesOffset;
+    for (uint32_t i = 0; i < h->nodeCount; ++i)
+    {
+        if (uint64_t(names[i].offset) + names[i].length > namesBytes)
+        {
+            return false;
+        }
+    }
+    const Entry* entries = reinterpret_cast<const Entry*>(base + h->entriesOffset);
+    for (uint64_t i = 0; i < h->entryCount; ++i)
+    {
+        if (entries[i].src >= h->nodeCount || entries[i].dst >= h->nodeCount)
+        {
+            return false;
+        }
+    }
+
+    m_base = base;
+    m_length = length;
+    m_header = h;
+    m_names = names;
+    m_nameChars = reinterpret_cast<const char*>(base + h->namesOffset);
+    m_entries = entries;
+    return true;
+}
+
+bool
+MappedDemandMatrix::MapCache(const std::string& cachePath,
+                             uint64_t sourceSize,
+                             int64_t sourceMtimeNs)
+{
+    int fd = open(cachePath.c_str(), O_RDONLY);
+    if (fd < 0)
+    {
+        return false;
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size < static_cast<off_t>(sizeof(Header)))
+    {
+        close(fd);
+        return false;
+    }
+
+    void* addr = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (addr == MAP_FAILED)
+    {
+        return false;
+    }
+
+    const uint8_t* base = static_cast<const uint8_t*>(addr);
+    const Header* h = reinterpret_cast<const Header*>(base);
+    if (!Attach(base, st.st_size) || h->sourceSize != sourceSize ||
+        h->sourceMtimeNs != sourceMtimeNs)
+    {
+        munmap(addr, st.st_size);
+        m_header = nullptr;
+        m_base = nullptr;
+        return false;
+    }
+
+    m_mapped = true;
+    return true;
+}
+
+bool
+MappedDemandMatrix::BuildImage(const std::string& path,
+                               uint64_t sourceSize,
+                               int64_t sourceMtimeNs,
+                               std::vector<uint8_t>& image,
+                               std::string& error)
+{
+    std::string content;
+    if (!ReadFile(path, content))
+    {
+        error = "impossibile leggere " + path;
+        return false;
+    }
+
+    NameTable names;
+    std::vector<ParsedDemand> demands;
+    size_t first = content.find_first_not_of(" \t\r\n");
+    bool isXml = (first != std::string::npos && content[first] == '<');
+    bool ok = isXml ? ParseXmlDemands(content, names, demands, error)
+                    : ParseNative(content, names, demands, error);
+    if (!ok)
+    {
+        error = path + ": " + error;
+        return false;
+    }
+
+    uint64_t namesBytes = 0;
+    for (const auto& n : names.names)
+    {
+        namesBytes += n.size();
+    }
+
+    Header h;
+    std::memcpy(h.magic, kCacheMagic, sizeof(kCacheMagic));
+    h.version = kCacheVersion;
+    h.nodeCount = static_cast<uint32_t>(names.names.size());
+    h.entryCount = demands.size();
+    h.sourceSize = sourceSize;
+    h.sourceMtimeNs = sourceMtimeNs;
+    h.namesOffset = sizeof(Header) + h.nodeCount * sizeof(NameRef);
+    h.entriesOffset = AlignTo8(h.namesOffset + namesBytes);
+    h.fileSize = h.entriesOffset + h.entryCount * sizeof(Entry);
+
+    image.assign(h.fileSize, 0);
+    std::memcpy(image.data(), &h, sizeof(h));
+
+    uint32_t offset = 0;
+    for (uint32_t i = 0; i < h.nodeCount; ++i)
+    {
+        const std::string& n = names.names[i];
+        NameRef ref{offset, static_cast<uint32_t>(n.size())};
+        std::memcpy(image.data() + sizeof(Header) + i * sizeof(NameRef), &ref, sizeof(ref));
+        std::memcpy(image.data() + h.namesOffset + offset, n.data(), n.size());
+        offset += ref.length;
+    }
+
+    for (uint64_t i = 0; i < h.entryCount; ++i)
+    {
+        Entry e{demands[i].src, demands[i].dst, demands[i].value};
+        std::memcpy(image.data() + h.entriesOffset + i * sizeof(Entry), &e, sizeof(e));
+    }
+    return true;
+}
+
+bool
+MappedDemandMatrix::Open(const std::string& path, std::string& error)
+{
+    Release();
+    m_ownedImage.clear();
+    m_fromCache = false;
+
+    std::error_code ec;
+    uint64_t sourceSize = std::filesystem::file_size(path, ec);
+    if (ec)
+    {
+        error = "impossibile leggere " + path + ": " + ec.message();
+        return false;
+    }
+    int64_t sourceMtimeNs = static_cast<int64_t>(
+        std::filesystem::last_write_time(path, ec).time_since_epoch().count());
+
+    std::string cachePath = path + ".qdmc";
+    if (MapCache(cachePath, sourceSize, sourceMtimeNs))
+    {
+        m_fromCache = true;
+        return true;
+    }
+
+    std::vector<uint8_t> image;
+    if (!BuildImage(path, sourceSize, sourceMtimeNs, image, error))
+    {
+        return false;
+    }
+
+    // scrittura atomica: file temporaneo e rename. Il temporaneo è del singolo
+    // processo (pid): i figli di sweep, repliche e scenari possono costruire
+    // la stessa cache insieme e nessuno deve rinominare o mappare un file
+    // scritto a metà da un altro
+    std::string tmpPath = cachePath + ".tmp." + std::to_string(getpid());
+    bool written = false;
+    {
+        std::ofstream out(tmpPath, std::ios::binary | std::ios::trunc);
+        out.write(reinterpret_cast<const char*>(image.data()), image.size());
+        out.close();
+        written = static_cast<bool>(out);
+        if (!written)
+        {
+            std::cout << "[DEMANDS] WARNING: impossibile scrivere la cache " << cachePath
+                      << std::endl;
+        }
+    }
+    if (written)
+    {
+        std::filesystem::rename(tmpPath, cachePath, ec);
+    }
+
+    if (written && !ec && MapCache(cachePath, sourceSize, sourceMtimeNs))
+    {
+        return true;
+    }
+
+    std::filesystem::remove(tmpPath, ec);
+    m_ownedImage = std::move(image);
+    return Attach(m_ownedImage.data(), m_ownedImage.size());
+}
+
+size_t
+MappedDemandMatrix::GetNEntries() const
+{
+    return m_header ? m_header->entryCount : 0;
+}
+
+size_t
+MappedDemandMatrix::GetNNodes() const
+{
+    return m_header ? m_header->nodeCount : 0;
+}
+
+std::string_view
+MappedDemandMatrix::GetNodeName(uint32_t index) const
+{
+    const NameRef& ref = m_names[index];
+    return std::string_view(m_nameChars + ref.offset, ref.length);
+}
+
+std::string_view
+MappedDemandMatrix::GetSource(size_t entry) const
+{
+    return GetNodeName(m_entries[entry].src);
+}
+
+std::string_view
+MappedDemandMatrix::GetTarget(size_t entry) const
+{
+    return GetNodeName(m_entries[entry].dst);
+}
+
+double
+MappedDemandMatrix::GetRateMbps(size_t entry) const
+{
+    return m_entries[entry].rateMbps;
+}
+
+bool
+MappedDemandMatrix::IsFromCache() const
+{
+    return m_fromCache;
+}
+
+std::vector<FlowDemand>
+MappedDemandMatrix::ToFlowDemands(double unitScale) const
+{
+    std::vector<FlowDemand> result;
+    result.reserve(GetNEntries());
+    for (size_t i = 0; i < GetNEntries(); ++i)
+    {
+        // le domande nulle non generano traffico
+        if (m_entries[i].rateMbps <= 0.0 || m_entries[i].src == m_entries[i].dst)
+        {
+            continue;
+        }
+        // stessi nomi dei nodi di una topologia caricata da file
+        result.push_back({SanitizeNodeName(std::string(GetSource(i))),
+                          SanitizeNodeName(std::string(GetTarget(i))),
+                          m_entries[i].rateMbps * unitScale});
+    }
+    return result;
+}
+
+std::vector<FlowDemand>
+LoadSndlibDemands(const std::string& path, double unitScale)
+{
+    MappedDemandMatrix matrix;
+    std::string error;
+    if (!matrix.Open(path, error))
+    {
+        NS_FATAL_ERROR("Matrice di domanda non valida: " << error);
+    }
+
+    std::cout << "[DEMANDS] " << path << ": " << matrix.GetNEntries() << " domande, "
+              << matrix.GetNNodes() << " nodi" << (matrix.IsFromCache() ? " (cache)" : "")
+              << std::endl;
+    return matrix.ToFlowDemands(unitScale);
+}
+
+std::vector<std::vector<FlowDemand>>
+LoadSndlibDemandMatrices(const std::vector<std::string>& paths, double unitScale)
+{
+    std::vector<std::vector<FlowDemand>> matrices;
+    matrices.reserve(paths.size());
+    for (const auto& path : paths)
+    {
+        matrices.push_back(LoadSndlibDemands(path, unitScale));
+    }
+    return matrices;
+}
@@ -0,0 +1,105 @@
+#ifndef SNDLIB_DEMAND_LOADER_H
+#define SNDLIB_DEMAND_LOADER_H
+
+#include "flow_demand_reader.h"
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Matrice di domanda letta da un file SNDlib (formato nativo o XML).
+//
+// La prima lettura di <file> scrive accanto ad esso una cache binaria
+// <file>.qdmc; le esecuzioni successive, se la cache corrisponde ancora a
+// dimensione e data di modifica del file sorgente, la mappano in memoria con
+// mmap e leggono le voci direttamente, senza alcun parsing.
+//
+// Layout della cache (endianness della macchina che l'ha scritta):
+//   Header | nodeCount x NameRef | nomi concatenati | entryCount x Entry
+class MappedDemandMatrix
+{
+  public:
+    MappedDemandMatrix() = default;
+    ~MappedDemandMatrix();
+
+    MappedDemandMatrix(const MappedDemandMatrix&) = delete;
+    MappedDemandMatrix& operator=(const MappedDemandMatrix&) = delete;
+    MappedDemandMatrix(MappedDemandMatrix&& other) noexcept;
+    MappedDemandMatrix& operator=(MappedDemandMatrix&& other) noexcept;
+
+    // apre la matrice, usando la cache se valida e rigenerandola altrimenti.
+    // Restituisce false e scrive error se il file non è leggibile
+    bool Open(const std::string& path, std::string& error);
+
+    size_t GetNEntries() const;
+    size_t GetNNodes() const;
+    std::string_view GetNodeName(uint32_t index) const;
+    std::string_view GetSource(size_t entry) const;
+    std::string_view GetTarget(size_t entry) const;
+    double GetRateMbps(size_t entry) const;
+
+    // true se la matrice è stata mappata da una cache esistente
+    bool IsFromCache() const;
+
+    // conversione nel formato usato dalle funzioni di installazione del traffico,
+    // con i nomi dei nodi trasformati come in LoadTopologyFile (SanitizeNodeName)
+    std::vector<FlowDemand> ToFlowDemands(double unitScale = 1.0) const;
+
+  private:
+    struct Header
+    {
+        char magic[8];
+        uint32_t version;
+        uint32_t nodeCount;
+        uint64_t entryCount;
+        uint64_t sourceSize;
+        int64_t sourceMtimeNs;
+        uint64_t namesOffset;
+        uint64_t entriesOffset;
+        uint64_t fileSize;
+    };
+
+    struct NameRef
+    {
+        uint32_t offset; // relativo all'inizio dei nomi concatenati
+        uint32_t length;
+    };
+
+    struct Entry
+    {
+        uint32_t src;
+        uint32_t dst;
+        double rateMbps;
+    };
+
+    // costruisce l'immagine della cache a partire dal file sorgente
+    static bool BuildImage(const std::string& path,
+                           uint64_t sourceSize,
+                           int64_t sourceMtimeNs,
+                           std::vector<uint8_t>& image,
+                           std::string& error);
+    bool MapCache(const std::string& cachePath, uint64_t sourceSize, int64_t sourceMtimeNs);
+    bool Attach(const uint8_t* base, size_t length);
+    void Release();
+
+    const uint8_t* m_base{nullptr};
+    size_t m_length{0};
+    bool m_mapped{false};             // m_base proviene da mmap
+    std::vector<uint8_t> m_ownedImage; // usata se la cache non può essere scritta
+    const Header* m_header{nullptr};
+    const NameRef* m_names{nullptr};
+    const char* m_nameChars{nullptr};
+    const Entry* m_entries{nullptr};
+    bool m_fromCache{false};
+};
+
+// carica un file SNDlib: formato rilevato dal contenuto (XML se inizia con '<')
+std::vector<FlowDemand> LoadSndlibDemands(const std::string& path, double unitScale = 1.0);
+
+// una matrice per file, nell'ordine dato; termina con errore se un file non è valido
+std::vector<std::vector<FlowDemand>> LoadSndlibDemandMatrices(
+    const std::vector<std::string>& paths,
+    double unitScale = 1.0);
+
+#endif // SNDLIB_DEMAND_LOADER_H
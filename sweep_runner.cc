@@ -0,0 +1,253 @@
+#include "sweep_runner.h"
+
+#include "process_runner.h"
+#include "run_summary.h"
+
+#include "ns3/abort.h"
+#include "ns3/rng-seed-manager.h"
+
+#include <cstdio>
+#include <iomanip>
+#include <iostream>
+#include <set>
+#include <sstream>
+
+namespace
+{
+
+struct SweepRun
+{
+    double loadFactor{1.0};
+    uint32_t normalMatrix{0};
+    uint32_t sensitiveMatrix{0};
+    uint64_t rngRun{1};
+    double exchangeInterval{0.01};
+    std::string queueDisc;
+
+    std::string workDir;
+    int exitStatus{-1};
+    bool completed{false};
+    RunSummary summary;
+};
+
+double
+ParseDouble(const std::string& item, const std::string& option)
+{
+    size_t used = 0;
+    double value = 0.0;
+    try
+    {
+        value = std::stod(item, &used);
+    }
+    catch (const std::exception&)
+    {
+        used = 0;
+    }
+    NS_ABORT_MSG_IF(used == 0 || used != item.size(),
+                    option << ": valore non numerico '" << item << "'");
+    return value;
+}
+
+uint64_t
+ParseUnsigned(const std::string& item, const std::string& option)
+{
+    double value = ParseDouble(item, option);
+    NS_ABORT_MSG_IF(value < 0 || value != static_cast<uint64_t>(value),
+                    option << ": serve un intero non negativo, non '" << item << "'");
+    return static_cast<uint64_t>(value);
+}
+
+// combinazioni nell'ordine delle liste: l'ultimo asse varia più in fretta
+std::vector<SweepRun>
+BuildGrid(const SimulationParameters& params)
+{
+    std::vector<double> loads;
+    for (const auto& item : SplitList(params.sweepLoad))
+    {
+        loads.push_back(ParseDouble(item, "sweepLoad"));
+    }
+    if (loads.empty())
+    {
+        loads.push_back(params.loadFactor);
+    }
+
+    // "S" cambia solo la matrice delay-sensitive, "N:S" entrambe
+    std::vector<std::pair<uint32_t, uint32_t>> matrices;
+    for (const auto& item : SplitList(params.sweepMatrix))
+    {
+        size_t colon = item.find(':');
+        if (colon == std::string::npos)
+        {
+            matrices.emplace_back(params.normalMatrix, ParseUnsigned(item, "sweepMatrix"));
+        }
+        else
+        {
+            matrices.emplace_back(ParseUnsigned(item.substr(0, colon), "sweepMatrix"),
+                                  ParseUnsigned(item.substr(colon + 1), "sweepMatrix"));
+        }
+    }
+    if (matrices.empty())
+    {
+        matrices.emplace_back(params.normalMatrix, params.sensitiveMatrix);
+    }
+
+    std::vector<uint64_t> seeds;
+    for (const auto& item : SplitList(params.sweepSeed))
+    {
+        seeds.push_back(ParseUnsigned(item, "sweepSeed"));
+    }
+    if (seeds.empty())
+    {
+        seeds.push_back(ns3::RngSeedManager::GetRun());
+    }
+
+    std::vector<double> intervals;
+    for (const auto& item : SplitList(params.sweepExchange))
+    {
+        intervals.push_back(ParseDouble(item, "sweepExchange"));
+        NS_ABORT_MSG_IF(intervals.back() <= 0, "sweepExchange: gli intervalli devono essere > 0");
+    }
+    if (intervals.empty())
+    {
+        intervals.push_back(params.exchangeInterval);
+    }
+
+    std::vector<std::string> queueDiscs = SplitList(params.sweepQueueDisc);
+    if (queueDiscs.empty())
+    {
+        queueDiscs.push_back(params.queueDisc);
+    }
+
+    std::vector<SweepRun> runs;
+    for (double load : loads)
+    {
+        for (const auto& [normal, sensitive] : matrices)
+        {
+            for (uint64_t seed : seeds)
+            {
+                for (double interval : intervals)
+                {
+                    for (const auto& queueDisc : queueDiscs)
+                    {
+                        SweepRun run;
+                        run.loadFactor = load;
+                        run.normalMatrix = normal;
+                        run.sensitiveMatrix = sensitive;
+                        run.rngRun = seed;
+                        run.exchangeInterval = interval;
+                        run.queueDisc = queueDisc;
+                        runs.push_back(run);
+                    }
+                }
+            }
+        }
+    }
+    return runs;
+}
+
+void
+WriteResults(const std::string& path, const std::vector<SweepRun>& runs)
+{
+    std::vector<std::string> columns;
+    std::vector<const RunSummary*> summaries;
+    for (size_t i = 0; i < runs.size(); ++i)
+    {
+        const SweepRun& run = runs[i];
+        std::ostringstream row;
+        row << i << "," << FormatDouble(run.loadFactor) << "," << run.normalMatrix << ","
+            << run.sensitiveMatrix << "," << run.rngRun << "," << FormatDouble(run.exchangeInterval)
+            << "," << run.queueDisc << "," << run.exitStatus << "," << run.completed;
+        columns.push_back(row.str());
+        summaries.push_back(&run.summary);
+    }
+    WriteSummaryCsv(path,
+                    "run,load_factor,normal_matrix,sensitive_matrix,rng_run,exchange_interval,"
+                    "queue_disc,exit_status,completed",
+                    columns,
+                    summaries);
+}
+
+} // namespace
+
+int
+RunSweep(const SimulationParameters& params, int argc, char* argv[])
+{
+    std::vector<SweepRun> runs = BuildGrid(params);
+
+    std::set<std::string> drop{"sweep",
+                               "sweepLoad",
+                               "sweepMatrix",
+                               "sweepSeed",
+                               "sweepExchange",
+                               "sweepQueueDisc",
+                               "jobs",
+                               "summaryFile"};
+    drop.insert(ChildInputOptions().begin(), ChildInputOptions().end());
+    std::vector<std::string> baseArgs{CurrentExecutable()};
+    for (const auto& arg : ForwardedArguments(argc, argv, drop))
+    {
+        baseArgs.push_back(arg);
+    }
+    for (const auto& arg : ChildInputArguments(params))
+    {
+        baseArgs.push_back(arg);
+    }
+
+    uint32_t jobs = ParallelJobs(params.jobs);
+    std::cout << "[SWEEP] " << runs.size() << " esecuzioni, " << jobs << " in parallelo"
+              << std::endl;
+
+    auto launch = [&](size_t index) {
+        SweepRun& run = runs[index];
+        std::ostringstream dir;
+        dir << "sweep/run_" << std::setw(4) << std::setfill('0') << index;
+        run.workDir = AbsolutePath(dir.str());
+        std::string summaryPath = run.workDir + "/summary.txt";
+        std::remove(summaryPath.c_str());
+
+        std::vector<std::string> args = baseArgs;
+        args.push_back("--sweep=false");
+        args.push_back("--loadFactor=" + FormatDouble(run.loadFactor));
+        args.push_back("--normalMatrix=" + std::to_string(run.normalMatrix));
+        args.push_back("--sensitiveMatrix=" + std::to_string(run.sensitiveMatrix));
+        args.push_back("--RngRun=" + std::to_string(run.rngRun));
+        args.push_back("--exchangeInterval=" + FormatDouble(run.exchangeInterval));
+        args.push_back("--queueDisc=" + run.queueDisc);
+        args.push_back("--summaryFile=" + summaryPath);
+        // servono solo i riepiloghi: niente log voluminosi né avanzamento
+        args.push_back("--latencyLog=");
+        args.push_back("--queueChangeLog=false");
+        args.push_back("--progressInterval=0");
+
+        pid_t pid = LaunchChild(args, run.workDir, "run.log");
+        if (pid < 0)
+        {
+            std::cout << "[SWEEP] avvio fallito per run_" << index << std::endl;
+        }
+        return pid;
+    };
+
+    size_t done = 0;
+    auto onExit = [&](size_t index, int exitStatus) {
+        SweepRun& run = runs[index];
+        done++;
+        run.exitStatus = exitStatus;
+        run.completed = exitStatus == 0 && run.summary.Read(run.workDir + "/summary.txt");
+        std::cout << "[SWEEP] " << done << "/" << runs.size() << " " << run.workDir
+                  << (run.completed ? " completata" : " fallita, vedi run.log") << std::endl;
+        return true;
+    };
+
+    RunChildPool(runs.size(), jobs, launch, onExit);
+
+    WriteResults("sweep_results.csv", runs);
+
+    size_t failed = 0;
+    for (const auto& run : runs)
+    {
+        failed += run.completed ? 0 : 1;
+    }
+    std::cout << "[SWEEP] risultati in sweep_results.csv (" << failed << " esecuzioni fallite)"
+              << std::endl;
+    return failed == 0 ? 0 : 1;
+}
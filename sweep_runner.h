@@ -0,0 +1,15 @@
+#ifndef SWEEP_RUNNER_H
+#define SWEEP_RUNNER_H
+
+#include "simulation_parameters.h"
+
+// Sweep di parametri: prodotto cartesiano delle liste sweepLoad (loadFactor),
+// sweepMatrix (matrici di domanda), sweepSeed (RngRun), sweepExchange
+// (exchangeInterval) e sweepQueueDisc (queueDisc); una lista vuota lascia il
+// valore corrente. Ogni combinazione è una simulazione figlia indipendente
+// in sweep/run_<i>/, fino a jobs figli alla volta; i riepiloghi sono uniti
+// in sweep_results.csv, una riga per combinazione.
+// Restituisce il codice di uscita del processo (1 se qualche esecuzione fallisce).
+int RunSweep(const SimulationParameters& params, int argc, char* argv[]);
+
+#endif // SWEEP_RUNNER_H
@@ -0,0 +1,545 @@
+#include "tcp-flow-application.h"
+
+#include "hot_path_profiler.h"
+#include "traffic-type-header.h"
+
+#include "ns3/address.h"
+#include "ns3/inet6-socket-address.h"
+#include "ns3/ipv6-address.h"
+#include "ns3/log.h"
+#include "ns3/node.h"
+#include "ns3/packet.h"
+#include "ns3/pointer.h"
+#include "ns3/random-variable-stream.h"
+#include "ns3/simulator.h"
+#include "ns3/socket.h"
+#include "ns3/string.h"
+#include "ns3/tcp-socket-base.h"
+#include "ns3/tcp-socket-factory.h"
+#include "ns3/uinteger.h"
+
+#include <algorithm>
+#include <arpa/inet.h> // Per htonl/ntohl
+#include <cstring>
+
+namespace ns3
+{
+
+NS_LOG_COMPONENT_DEFINE("TcpFlowApplication");
+
+NS_OBJECT_ENSURE_REGISTERED(TcpFlowApplication);
+NS_OBJECT_ENSURE_REGISTERED(TcpFlowSink);
+
+TypeId
+TcpFlowApplication::GetTypeId()
+{
+    static TypeId tid =
+        TypeId("ns3::TcpFlowApplication")
+            .SetParent<Application>()
+            .SetGroupName("Applications")
+            .AddConstructor<TcpFlowApplication>()
+            .AddAttribute("Remote",
+                          "The address of the destination",
+                          AddressValue(),
+                          MakeAddressAccessor(&TcpFlowApplication::m_peer),
+                          MakeAddressChecker())
+            .AddAttribute("Mode",
+                          "0 = bulk transfer, 1 = request/response",
+                          UintegerValue(TcpFlowStats::BULK),
+                          MakeUintegerAccessor(&TcpFlowApplication::m_mode),
+                          MakeUintegerChecker<uint32_t>(0, 1))
+            .AddAttribute("BulkBytes",
+                          "Bytes sent by a bulk transfer",
+                          UintegerValue(1000000),
+                          MakeUintegerAccessor(&TcpFlowApplication::m_bulkBytes),
+                          MakeUintegerChecker<uint64_t>(1))
+            .AddAttribute("RequestSize",
+                          "Size of a request in request/response mode",
+                          UintegerValue(200),
+                          MakeUintegerAccessor(&TcpFlowApplication::m_requestSize),
+                          MakeUintegerChecker<uint32_t>(1))
+            .AddAttribute("ResponseSize",
+                          "Size of a response in request/response mode",
+                          UintegerValue(20000),
+                          MakeUintegerAccessor(&TcpFlowApplication::m_responseSize),
+                          MakeUintegerChecker<uint32_t>(1))
+            .AddAttribute("SendSize",
+                          "Amount of data handed to the socket at each send",
+                          UintegerValue(1448),
+                          MakeUintegerAccessor(&TcpFlowApplication::m_sendSize),
+                          MakeUintegerChecker<uint32_t>(1))
+            .AddAttribute("ThinkTime",
+                          "Pause between a response and the next request, in seconds",
+                          StringValue("ns3::ConstantRandomVariable[Constant=0.05]"),
+                          MakePointerAccessor(&TcpFlowApplication::m_thinkTime),
+                          MakePointerChecker<RandomVariableStream>())
+            .AddAttribute("TrafficType",
+                          "0 = normal, 1 = delay-sensitive",
+                          UintegerValue(1),
+                          MakeUintegerAccessor(&TcpFlowApplication::m_trafficType),
+                          MakeUintegerChecker<uint32_t>(0, 1));
+    return tid;
+}
+
+TcpFlowApplication::TcpFlowApplication()
+    : m_socket(nullptr)
+{
+}
+
+TcpFlowApplication::~TcpFlowApplication()
+{
+}
+
+void
+TcpFlowApplication::SetFlow(std::shared_ptr<TcpFlowStats> stats, uint32_t flowId)
+{
+    m_stats = stats;
+    m_flowId = flowId;
+}
+
+void
+TcpFlowApplication::DoDispose()
+{
+    Simulator::Cancel(m_requestEvent);
+    m_socket = nullptr;
+    Application::DoDispose();
+}
+
+void
+TcpFlowApplication::StartApplication()
+{
+    m_running = true;
+
+    if (!m_socket)
+    {
+        m_socket = Socket::CreateSocket(GetNode(), TcpSocketFactory::GetTypeId());
+        m_socket->Bind6();
+
+        if (m_trafficType == 1)
+        {
+            // marca anche gli ACK del client, oltre ai segmenti dati
+            m_socket->SetIpv6Tclass(TrafficTypeHeader::DELAY_SENSITIVE_TCLASS);
+        }
+
+        m_socket->TraceConnectWithoutContext("Tx",
+                                             MakeCallback(&TcpFlowApplication::TxTrace, this));
+        m_socket->SetConnectCallback(MakeCallback(&TcpFlowApplication::ConnectionSucceeded, this),
+                                     MakeCallback(&TcpFlowApplication::ConnectionFailed, this));
+        m_socket->SetSendCallback(MakeCallback(&TcpFlowApplication::HandleSend, this));
+        m_socket->SetRecvCallback(MakeCallback(&TcpFlowApplication::HandleRead, this));
+        m_socket->Connect(m_peer);
+    }
+}
+
+void
+TcpFlowApplication::StopApplication()
+{
+    m_running = false;
+    Simulator::Cancel(m_requestEvent);
+
+    if (m_socket)
+    {
+        m_socket->Close();
+        m_connected = false;
+    }
+}
+
+void
+TcpFlowApplication::ConnectionSucceeded(Ptr<Socket> socket)
+{
+    m_connected = true;
+    if (m_stats)
+    {
+        m_stats->OnConnected(m_flowId, Simulator::Now());
+    }
+
+    m_pendingPreamble = 4;
+    if (m_mode == TcpFlowStats::BULK)
+    {
+        m_pendingBytes = m_bulkBytes;
+        SendPending();
+    }
+    else
+    {
+        SendRequest();
+    }
+}
+
+void
+TcpFlowApplication::ConnectionFailed(Ptr<Socket> socket)
+{
+    std::cout << "[TCPFLOW] WARNING: connessione fallita per il flusso " << m_flowId
+              << std::endl;
+}
+
+void
+TcpFlowApplication::HandleSend(Ptr<Socket> socket, uint32_t available)
+{
+    if (m_connected)
+    {
+        SendPending();
+    }
+}
+
+void
+TcpFlowApplication::SendPending()
+{
+    if (m_pendingPreamble > 0)
+    {
+        if (m_socket->GetTxAvailable() < m_pendingPreamble)
+        {
+            return;
+        }
+
+        uint32_t idNetwork = htonl(m_flowId);
+        Ptr<Packet> preamble =
+            Create<Packet>(reinterpret_cast<const uint8_t*>(&idNetwork), sizeof(idNetwork));
+        if (m_socket->Send(preamble) < 0)
+        {
+            return;
+        }
+        m_pendingPreamble = 0;
+    }
+
+    while (m_pendingBytes > 0)
+    {
+        uint32_t available = m_socket->GetTxAvailable();
+        if (available == 0)
+        {
+            return; // riprende da HandleSend
+        }
+
+        uint32_t toSend = static_cast<uint32_t>(
+            std::min<uint64_t>({m_pendingBytes, m_sendSize, available}));
+        int sent = m_socket->Send(Create<Packet>(toSend));
+        if (sent < 0)
+        {
+            return;
+        }
+        m_pendingBytes -= sent;
+    }
+
+    if (m_mode == TcpFlowStats::BULK)
+    {
+        // tutti i byte sono nel buffer del socket: la chiusura avviene dopo lo svuotamento
+        m_socket->Close();
+        m_connected = false;
+    }
+}
+
+void
+TcpFlowApplication::SendRequest()
+{
+    if (!m_running || !m_connected)
+    {
+        return;
+    }
+
+    m_requestTime = Simulator::Now();
+    m_responseBytes = 0;
+    m_pendingBytes += m_requestSize;
+    SendPending();
+}
+
+void
+TcpFlowApplication::HandleRead(Ptr<Socket> socket)
+{
+    Ptr<Packet> packet;
+    Address from;
+    while ((packet = socket->RecvFrom(from)))
+    {
+        if (packet->GetSize() == 0)
+        {
+            break;
+        }
+
+        // i byte delle risposte contano come goodput del flusso (in reqresp
+        // il sink non conta le richieste: una sola direzione per flusso)
+        if (m_stats)
+        {
+            m_stats->OnBytesDelivered(m_flowId, packet->GetSize(), Simulator::Now());
+        }
+
+        if (m_mode != TcpFlowStats::REQUEST_RESPONSE)
+        {
+            continue;
+        }
+
+        m_responseBytes += packet->GetSize();
+        if (m_responseBytes >= m_responseSize && !m_requestEvent.IsPending())
+        {
+            if (m_stats)
+            {
+                m_stats->OnTransaction(m_flowId, m_requestTime, Simulator::Now());
+            }
+            m_responseBytes = 0;
+            m_requestEvent = Simulator::Schedule(Seconds(m_thinkTime->GetValue()),
+                                                 &TcpFlowApplication::SendRequest,
+                                                 this);
+        }
+    }
+}
+
+void
+TcpFlowApplication::TxTrace(Ptr<const Packet> packet,
+                            const TcpHeader& header,
+                            Ptr<const TcpSocketBase> socket)
+{
+    if (packet->GetSize() == 0 || !m_stats)
+    {
+        return; // SYN, FIN e ACK puri
+    }
+
+    SequenceNumber32 seq = header.GetSequenceNumber();
+    SequenceNumber32 end = seq + packet->GetSize();
+    bool retransmission = m_anyDataSent && seq < m_highestTxEnd;
+    if (!m_anyDataSent || end > m_highestTxEnd)
+    {
+        m_highestTxEnd = end;
+        m_anyDataSent = true;
+    }
+
+    m_stats->OnDataSegment(m_flowId, packet->GetSize(), retransmission);
+}
+
+TypeId
+TcpFlowSink::GetTypeId()
+{
+    static TypeId tid =
+        TypeId("ns3::TcpFlowSink")
+            .SetParent<Application>()
+            .SetGroupName("Applications")
+            .AddConstructor<TcpFlowSink>()
+            .AddAttribute("Port",
+                          "Port on which the sink listens",
+                          UintegerValue(10000),
+                          MakeUintegerAccessor(&TcpFlowSink::m_port),
+                          MakeUintegerChecker<uint16_t>())
+            .AddAttribute("RequestSize",
+                          "Size of a request; 0 disables the responses",
+                          UintegerValue(0),
+                          MakeUintegerAccessor(&TcpFlowSink::m_requestSize),
+                          MakeUintegerChecker<uint32_t>())
+            .AddAttribute("ResponseSize",
+                          "Bytes sent back for each complete request",
+                          UintegerValue(0),
+                          MakeUintegerAccessor(&TcpFlowSink::m_responseSize),
+                          MakeUintegerChecker<uint32_t>())
+            .AddAttribute("TrafficType",
+                          "0 = normal, 1 = delay-sensitive (responses and ACKs)",
+                          UintegerValue(1),
+                          MakeUintegerAccessor(&TcpFlowSink::m_trafficType),
+                          MakeUintegerChecker<uint32_t>(0, 1));
+    return tid;
+}
+
+TcpFlowSink::TcpFlowSink()
+    : m_listenSocket(nullptr)
+{
+}
+
+TcpFlowSink::~TcpFlowSink()
+{
+}
+
+void
+TcpFlowSink::SetStats(std::shared_ptr<TcpFlowStats> stats)
+{
+    m_stats = stats;
+}
+
+void
+TcpFlowSink::DoDispose()
+{
+    m_listenSocket = nullptr;
+    m_connections.clear();
+    Application::DoDispose();
+}
+
+void
+TcpFlowSink::StartApplication()
+{
+    if (!m_listenSocket)
+    {
+        m_listenSocket = Socket::CreateSocket(GetNode(), TcpSocketFactory::GetTypeId());
+        m_listenSocket->Bind(Inet6SocketAddress(Ipv6Address::GetAny(), m_port));
+        // impostato prima di Listen: i socket accettati lo ereditano dal fork,
+        // quindi anche i segmenti dell'handshake lato server sono EF
+        if (m_trafficType == 1)
+        {
+            m_listenSocket->SetIpv6Tclass(TrafficTypeHeader::DELAY_SENSITIVE_TCLASS);
+        }
+        m_listenSocket->Listen();
+    }
+
+    m_listenSocket->SetAcceptCallback(MakeNullCallback<bool, Ptr<Socket>, const Address&>(),
+                                      MakeCallback(&TcpFlowSink::HandleAccept, this));
+}
+
+void
+TcpFlowSink::StopApplication()
+{
+    for (auto& [key, conn] : m_connections)
+    {
+        conn.socket->Close();
+    }
+    m_connections.clear();
+
+    if (m_listenSocket)
+    {
+        m_listenSocket->Close();
+        m_listenSocket->SetAcceptCallback(MakeNullCallback<bool, Ptr<Socket>, const Address&>(),
+                                          MakeNullCallback<void, Ptr<Socket>, const Address&>());
+    }
+}
+
+void
+TcpFlowSink::HandleAccept(Ptr<Socket> socket, const Address& from)
+{
+    socket->SetRecvCallback(MakeCallback(&TcpFlowSink::HandleRead, this));
+    socket->SetSendCallback(MakeCallback(&TcpFlowSink::HandleSend, this));
+    socket->SetCloseCallbacks(MakeCallback(&TcpFlowSink::HandlePeerClose, this),
+                              MakeCallback(&TcpFlowSink::HandlePeerClose, this));
+    socket->TraceConnectWithoutContext("Tx", MakeCallback(&TcpFlowSink::TxTrace, this));
+
+    Connection conn;
+    conn.socket = socket;
+    m_connections[PeekPointer(socket)] = conn;
+}
+
+void
+TcpFlowSink::HandleRead(Ptr<Socket> socket)
+{
+    QSE_PROFILE_SCOPE(TCP_SINK_READ);
+    auto it = m_connections.find(PeekPointer(socket));
+    if (it == m_connections.end())
+    {
+        return;
+    }
+    Connection& conn = it->second;
+
+    Ptr<Packet> packet;
+    Address from;
+    while ((packet = socket->RecvFrom(from)))
+    {
+        uint32_t size = packet->GetSize();
+        if (size == 0)
+        {
+            break;
+        }
+
+        // preambolo con l'id del flusso, eventualmente spezzato su più segmenti
+        uint32_t consumed = 0;
+        if (conn.preambleLen < sizeof(conn.preamble))
+        {
+            consumed = std::min<uint32_t>(sizeof(conn.preamble) - conn.preambleLen, size);
+            packet->CopyData(conn.preamble + conn.preambleLen, consumed);
+            conn.preambleLen += consumed;
+            if (conn.preambleLen == sizeof(conn.preamble))
+            {
+                uint32_t idNetwork;
+                std::memcpy(&idNetwork, conn.preamble, sizeof(idNetwork));
+                conn.flowId = ntohl(idNetwork);
+            }
+        }
+
+        uint32_t payload = size - consumed;
+        if (payload == 0)
+        {
+            continue;
+        }
+
+        // bulk: il goodput è quello ricevuto qui. In reqresp lo conta il
+        // client sulle risposte, le richieste non si sommano
+        bool requestResponse = m_requestSize > 0 && m_responseSize > 0;
+        if (!requestResponse && m_stats && m_stats->IsValidFlow(conn.flowId))
+        {
+            m_stats->OnBytesDelivered(conn.flowId, payload, Simulator::Now());
+        }
+
+        if (requestResponse)
+        {
+            conn.requestBytes += payload;
+            while (conn.requestBytes >= m_requestSize)
+            {
+                conn.requestBytes -= m_requestSize;
+                conn.pendingReply += m_responseSize;
+            }
+            SendReply(conn);
+        }
+    }
+}
+
+void
+TcpFlowSink::HandleSend(Ptr<Socket> socket, uint32_t available)
+{
+    auto it = m_connections.find(PeekPointer(socket));
+    if (it != m_connections.end())
+    {
+        SendReply(it->second);
+    }
+}
+
+void
+TcpFlowSink::SendReply(Connection& conn)
+{
+    while (conn.pendingReply > 0)
+    {
+        uint32_t available = conn.socket->GetTxAvailable();
+        if (available == 0)
+        {
+            return; // riprende da HandleSend
+        }
+
+        uint32_t toSend =
+            static_cast<uint32_t>(std::min<uint64_t>(conn.pendingReply, available));
+        int sent = conn.socket->Send(Create<Packet>(toSend));
+        if (sent < 0)
+        {
+            return;
+        }
+        conn.pendingReply -= sent;
+    }
+}
+
+void
+TcpFlowSink::HandlePeerClose(Ptr<Socket> socket)
+{
+    auto it = m_connections.find(PeekPointer(socket));
+    if (it != m_connections.end())
+    {
+        socket->Close();
+        m_connections.erase(it);
+    }
+}
+
+void
+TcpFlowSink::TxTrace(Ptr<const Packet> packet,
+                     const TcpHeader& header,
+                     Ptr<const TcpSocketBase> socket)
+{
+    if (packet->GetSize() == 0 || !m_stats)
+    {
+        return;
+    }
+
+    auto it = m_connections.find(PeekPointer(socket));
+    if (it == m_connections.end() || !m_stats->IsValidFlow(it->second.flowId))
+    {
+        return;
+    }
+    Connection& conn = it->second;
+
+    SequenceNumber32 seq = header.GetSequenceNumber();
+    SequenceNumber32 end = seq + packet->GetSize();
+    bool retransmission = conn.anyDataSent && seq < conn.highestTxEnd;
+    if (!conn.anyDataSent || end > conn.highestTxEnd)
+    {
+        conn.highestTxEnd = end;
+        conn.anyDataSent = true;
+    }
+
+    m_stats->OnDataSegment(conn.flowId, packet->GetSize(), retransmission);
+}
+
+} // namespace ns3
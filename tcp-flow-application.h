@@ -0,0 +1,136 @@
+#ifndef TCP_FLOW_APPLICATION_H
+#define TCP_FLOW_APPLICATION_H
+
+#include "tcp_flow_stats.h"
+
+#include "ns3/address.h"
+#include "ns3/application.h"
+#include "ns3/event-id.h"
+#include "ns3/ptr.h"
+#include "ns3/sequence-number.h"
+#include "ns3/tcp-header.h"
+
+#include <map>
+#include <memory>
+
+namespace ns3
+{
+
+class RandomVariableStream;
+class Socket;
+class TcpSocketBase;
+
+// Client TCP del carico di lavoro. Due modalità:
+//  - Bulk: invia BulkBytes byte e chiude la connessione
+//  - RequestResponse: invia richieste da RequestSize byte e attende risposte da
+//    ResponseSize byte, con un tempo di attesa (ThinkTime) tra una transazione e l'altra
+// I primi 4 byte della connessione contengono l'id del flusso in TcpFlowStats.
+// Con TrafficType = 1 il socket marca i segmenti con DELAY_SENSITIVE_TCLASS,
+// così vengono instradati da QRoutingProtocol.
+class TcpFlowApplication : public Application
+{
+  public:
+    static TypeId GetTypeId();
+
+    TcpFlowApplication();
+    ~TcpFlowApplication() override;
+
+    void SetFlow(std::shared_ptr<TcpFlowStats> stats, uint32_t flowId);
+
+  protected:
+    void DoDispose() override;
+
+  private:
+    void StartApplication() override;
+    void StopApplication() override;
+
+    void ConnectionSucceeded(Ptr<Socket> socket);
+    void ConnectionFailed(Ptr<Socket> socket);
+    void HandleSend(Ptr<Socket> socket, uint32_t available);
+    void HandleRead(Ptr<Socket> socket);
+    void TxTrace(Ptr<const Packet> packet,
+                 const TcpHeader& header,
+                 Ptr<const TcpSocketBase> socket);
+
+    void SendPending();
+    void SendRequest();
+
+    Ptr<Socket> m_socket;
+    Address m_peer;
+    uint32_t m_mode{TcpFlowStats::BULK};
+    uint64_t m_bulkBytes{0};
+    uint32_t m_requestSize{0};
+    uint32_t m_responseSize{0};
+    uint32_t m_sendSize{0};
+    uint32_t m_trafficType{1};
+    Ptr<RandomVariableStream> m_thinkTime;
+
+    std::shared_ptr<TcpFlowStats> m_stats;
+    uint32_t m_flowId{0};
+
+    bool m_connected{false};
+    bool m_running{false};
+    uint64_t m_pendingBytes{0};  // byte applicativi ancora da consegnare al socket
+    uint32_t m_pendingPreamble{0};
+    uint64_t m_responseBytes{0}; // byte della risposta corrente già ricevuti
+    Time m_requestTime;
+    EventId m_requestEvent;
+
+    bool m_anyDataSent{false};
+    SequenceNumber32 m_highestTxEnd; // fine del segmento dati con seq più alta inviato
+};
+
+// Sink TCP: accetta le connessioni, attribuisce i byte ricevuti al flusso
+// indicato nel preambolo e, se ResponseSize > 0, risponde ad ogni richiesta
+// completa da RequestSize byte con ResponseSize byte.
+class TcpFlowSink : public Application
+{
+  public:
+    static TypeId GetTypeId();
+
+    TcpFlowSink();
+    ~TcpFlowSink() override;
+
+    void SetStats(std::shared_ptr<TcpFlowStats> stats);
+
+  protected:
+    void DoDispose() override;
+
+  private:
+    struct Connection
+    {
+        Ptr<Socket> socket;
+        uint8_t preamble[4];
+        uint32_t preambleLen{0};
+        uint32_t flowId{0};
+        uint64_t requestBytes{0}; // byte della richiesta corrente
+        uint64_t pendingReply{0}; // byte di risposta non ancora accettati dal socket
+        bool anyDataSent{false};
+        SequenceNumber32 highestTxEnd;
+    };
+
+    void StartApplication() override;
+    void StopApplication() override;
+
+    void HandleAccept(Ptr<Socket> socket, const Address& from);
+    void HandleRead(Ptr<Socket> socket);
+    void HandleSend(Ptr<Socket> socket, uint32_t available);
+    void HandlePeerClose(Ptr<Socket> socket);
+    void TxTrace(Ptr<const Packet> packet,
+                 const TcpHeader& header,
+                 Ptr<const TcpSocketBase> socket);
+
+    void SendReply(Connection& conn);
+
+    Ptr<Socket> m_listenSocket;
+    uint16_t m_port{0};
+    uint32_t m_requestSize{0};
+    uint32_t m_responseSize{0};
+    uint32_t m_trafficType{1};
+    std::shared_ptr<TcpFlowStats> m_stats;
+    std::map<const Socket*, Connection> m_connections;
+};
+
+} // namespace ns3
+
+#endif // TCP_FLOW_APPLICATION_H
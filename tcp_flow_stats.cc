@@ -0,0 +1,158 @@
+#include "tcp_flow_stats.h"
+
+#include <algorithm>
+#include <iomanip>
+
+uint32_t
+TcpFlowStats::RegisterFlow(const std::string& src,
+                           const std::string& dst,
+                           Mode mode,
+                           uint64_t targetBytes)
+{
+    FlowRecord f;
+    f.src = src;
+    f.dst = dst;
+    f.mode = mode;
+    f.targetBytes = targetBytes;
+    m_flows.push_back(f);
+    return static_cast<uint32_t>(m_flows.size() - 1);
+}
+
+bool
+TcpFlowStats::IsValidFlow(uint32_t flowId) const
+{
+    return flowId < m_flows.size();
+}
+
+void
+TcpFlowStats::OnConnected(uint32_t flowId, ns3::Time now)
+{
+    FlowRecord& f = m_flows[flowId];
+    f.connected = true;
+    f.start = now;
+}
+
+void
+TcpFlowStats::OnDataSegment(uint32_t flowId, uint32_t bytes, bool retransmission)
+{
+    FlowRecord& f = m_flows[flowId];
+    f.txSegments++;
+    if (retransmission)
+    {
+        f.retxSegments++;
+        f.retxBytes += bytes;
+    }
+}
+
+void
+TcpFlowStats::OnBytesDelivered(uint32_t flowId, uint64_t bytes, ns3::Time now)
+{
+    FlowRecord& f = m_flows[flowId];
+    if (f.rxBytes == 0)
+    {
+        f.firstRx = now;
+    }
+    f.rxBytes += bytes;
+    f.lastRx = now;
+
+    if (f.mode == BULK && !f.completed && f.targetBytes > 0 && f.rxBytes >= f.targetBytes)
+    {
+        f.completed = true;
+        f.completion = now;
+    }
+}
+
+void
+TcpFlowStats::OnTransaction(uint32_t flowId, ns3::Time requestTime, ns3::Time responseTime)
+{
+    FlowRecord& f = m_flows[flowId];
+    double rt = (responseTime - requestTime).GetSeconds();
+    f.transactions++;
+    f.sumResponseSeconds += rt;
+    f.maxResponseSeconds = std::max(f.maxResponseSeconds, rt);
+}
+
+const std::vector<TcpFlowStats::FlowRecord>&
+TcpFlowStats::GetFlows() const
+{
+    return m_flows;
+}
+
+double
+TcpFlowStats::GoodputMbps(const FlowRecord& f)
+{
+    // dall'apertura della connessione all'ultimo byte consegnato
+    double duration = (f.lastRx - f.start).GetSeconds();
+    return duration > 0 ? f.rxBytes * 8.0 / duration / 1e6 : 0.0;
+}
+
+void
+TcpFlowStats::WriteFlowCsv(std::ostream& os) const
+{
+    os << "flow_id,src_node,dst_node,mode,target_bytes,rx_bytes,goodput_mbps,tx_segments,"
+          "retx_segments,retx_bytes,retx_ratio,completed,fct_s,transactions,mean_response_ms,"
+          "max_response_ms\n";
+    os << std::fixed << std::setprecision(6);
+
+    for (uint32_t id = 0; id < m_flows.size(); ++id)
+    {
+        const FlowRecord& f = m_flows[id];
+        double retxRatio =
+            f.txSegments ? static_cast<double>(f.retxSegments) / f.txSegments : 0.0;
+        double fct = f.completed ? (f.completion - f.start).GetSeconds() : -1.0;
+        double meanRt = f.transactions ? f.sumResponseSeconds / f.transactions * 1e3 : 0.0;
+
+        os << id << "," << f.src << "," << f.dst << ","
+           << (f.mode == BULK ? "bulk" : "reqresp") << "," << f.targetBytes << "," << f.rxBytes
+           << "," << GoodputMbps(f) << "," << f.txSegments << "," << f.retxSegments << ","
+           << f.retxBytes << "," << retxRatio << "," << (f.completed ? 1 : 0) << "," << fct
+           << "," << f.transactions << "," << meanRt << "," << f.maxResponseSeconds * 1e3
+           << "\n";
+    }
+}
+
+void
+TcpFlowStats::WriteSummary(std::ostream& os) const
+{
+    if (m_flows.empty())
+    {
+        return;
+    }
+
+    uint64_t rxBytes = 0;
+    uint64_t txSegments = 0;
+    uint64_t retxSegments = 0;
+    uint64_t completed = 0;
+    uint64_t transactions = 0;
+    double sumGoodput = 0.0;
+    double sumFct = 0.0;
+    double maxFct = 0.0;
+    double sumRt = 0.0;
+
+    for (const auto& f : m_flows)
+    {
+        rxBytes += f.rxBytes;
+        txSegments += f.txSegments;
+        retxSegments += f.retxSegments;
+        sumGoodput += GoodputMbps(f);
+        transactions += f.transactions;
+        sumRt += f.sumResponseSeconds;
+        if (f.completed)
+        {
+            double fct = (f.completion - f.start).GetSeconds();
+            completed++;
+            sumFct += fct;
+            maxFct = std::max(maxFct, fct);
+        }
+    }
+
+    os << std::fixed << std::setprecision(6);
+    os << "[TCPSTATS] flows=" << m_flows.size() << " rx_bytes=" << rxBytes
+       << " mean_goodput_mbps=" << sumGoodput / m_flows.size()
+       << " retx_ratio="
+       << (txSegments ? static_cast<double>(retxSegments) / txSegments : 0.0)
+       << " completed=" << completed
+       << " mean_fct_s=" << (completed ? sumFct / completed : 0.0) << " max_fct_s=" << maxFct
+       << " transactions=" << transactions
+       << " mean_response_ms=" << (transactions ? sumRt / transactions * 1e3 : 0.0) << "\n";
+}
@@ -0,0 +1,69 @@
+#ifndef TCP_FLOW_STATS_H
+#define TCP_FLOW_STATS_H
+
+#include "ns3/nstime.h"
+
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <vector>
+
+// Metriche dei flussi TCP del carico di lavoro: goodput (byte consegnati
+// all'applicazione ricevente), ritrasmissioni (segmenti inviati sotto la
+// sequenza più alta già trasmessa), flow completion time per i trasferimenti
+// bulk e tempo di risposta per le transazioni request/response.
+// Il client registra il flusso e ottiene un id che invia in testa alla
+// connessione, così il sink può attribuirgli i byte ricevuti.
+class TcpFlowStats
+{
+  public:
+    enum Mode : uint8_t
+    {
+        BULK = 0,
+        REQUEST_RESPONSE = 1
+    };
+
+    struct FlowRecord
+    {
+        std::string src;
+        std::string dst;
+        Mode mode{BULK};
+        uint64_t targetBytes{0}; // solo bulk
+        ns3::Time start;
+        ns3::Time firstRx;
+        ns3::Time lastRx;
+        uint64_t rxBytes{0};
+        uint64_t txSegments{0};
+        uint64_t retxSegments{0};
+        uint64_t retxBytes{0};
+        bool connected{false};
+        bool completed{false};
+        ns3::Time completion;
+        uint64_t transactions{0};
+        double sumResponseSeconds{0.0};
+        double maxResponseSeconds{0.0};
+    };
+
+    uint32_t RegisterFlow(const std::string& src,
+                          const std::string& dst,
+                          Mode mode,
+                          uint64_t targetBytes);
+
+    void OnConnected(uint32_t flowId, ns3::Time now);
+    void OnDataSegment(uint32_t flowId, uint32_t bytes, bool retransmission);
+    void OnBytesDelivered(uint32_t flowId, uint64_t bytes, ns3::Time now);
+    void OnTransaction(uint32_t flowId, ns3::Time requestTime, ns3::Time responseTime);
+
+    bool IsValidFlow(uint32_t flowId) const;
+    const std::vector<FlowRecord>& GetFlows() const;
+
+    void WriteFlowCsv(std::ostream& os) const;
+    void WriteSummary(std::ostream& os) const;
+
+  private:
+    static double GoodputMbps(const FlowRecord& f);
+
+    std::vector<FlowRecord> m_flows; // indicizzato per flowId
+};
+
+#endif // TCP_FLOW_STATS_H
@@ -21,8 +21,12 @@
 #include "ns3/trace-source-accessor.h"
 #include "ns3/udp-socket-factory.h"
 #include "ns3/uinteger.h"
+#include "hot_path_profiler.h"
 #include "traffic-type-header.h"
 
+#include <algorithm>
+#include <cmath>
+
 namespace ns3
 {
 
@@ -48,6 +52,12 @@ TimeStampedOnOffApplication::GetTypeId()
                           UintegerValue(512),
                           MakeUintegerAccessor(&TimeStampedOnOffApplication::m_pktSize),
                           MakeUintegerChecker<uint32_t>(1))
+            .AddAttribute("PacketSizeDistribution",
+                          "A RandomVariableStream used to pick the size of each packet. "
+                          "If not set, PacketSize is used for every packet.",
+                          PointerValue(),
+                          MakePointerAccessor(&TimeStampedOnOffApplication::m_pktSizeDist),
+                          MakePointerChecker<RandomVariableStream>())
             .AddAttribute("Remote",
                           "The address of the destination",
                           AddressValue(),
@@ -147,12 +157,23 @@ TimeStampedOnOffApplication::GetSocket() const
     return m_socket;
 }
 
+uint16_t
+TimeStampedOnOffApplication::GetLocalPort() const
+{
+    return m_localPort;
+}
+
 int64_t
 TimeStampedOnOffApplication::AssignStreams(int64_t stream)
 {
     // NS_LOG_FUNCTION(this << stream);
     m_onTime->SetStream(stream);
     m_offTime->SetStream(stream + 1);
+    if (m_pktSizeDist)
+    {
+        m_pktSizeDist->SetStream(stream + 2);
+        return 3;
+    }
     return 2;
 }
 
@@ -221,6 +242,21 @@ TimeStampedOnOffApplication::StartApplication() // Called at time specified by S
         m_socket->Connect(m_peer);
         m_socket->SetAllowBroadcast(true);
         m_socket->ShutdownRecv();
+
+        // Close() in StopApplication libera l'endpoint: la porta locale va
+        // letta adesso (serve a FlowClassMonitor per classificare il flusso)
+        Address local;
+        if (m_socket->GetSockName(local) == 0)
+        {
+            if (Inet6SocketAddress::IsMatchingType(local))
+            {
+                m_localPort = Inet6SocketAddress::ConvertFrom(local).GetPort();
+            }
+            else if (InetSocketAddress::IsMatchingType(local))
+            {
+                m_localPort = InetSocketAddress::ConvertFrom(local).GetPort();
+            }
+        }
     }
     m_cbrRateFailSafe = m_cbrRate;
 
@@ -304,10 +340,9 @@ TimeStampedOnOffApplication::ScheduleNextTx()
 
     if (m_maxBytes == 0 || m_totBytes < m_maxBytes)
     {
-        /*
-        NS_ABORT_MSG_IF(m_residualBits > m_pktSize * 8,
-                        "Calculation to compute next send time will overflow");*/
-        uint32_t bits = m_pktSize * 8 - m_residualBits;
+        // The size stays the same until the packet is sent, so the residual bits
+        // accumulated across Off periods never exceed it
+        uint32_t bits = NextPacketSize() * 8 - m_residualBits;
         // NS_LOG_LOGIC("bits = " << bits);
         Time nextTime(
             Seconds(bits / static_cast<double>(m_cbrRate.GetBitRate()))); // Time till next packet
@@ -320,6 +355,26 @@ TimeStampedOnOffApplication::ScheduleNextTx()
     }
 }
 
+uint32_t
+TimeStampedOnOffApplication::NextPacketSize()
+{
+    if (m_nextPktSize == 0)
+    {
+        m_nextPktSize = m_pktSize;
+        if (m_pktSizeDist)
+        {
+            double drawn = std::round(m_pktSizeDist->GetValue());
+            m_nextPktSize = static_cast<uint32_t>(std::clamp(drawn, 1.0, 65000.0));
+        }
+        if (m_enableSeqTsSizeHeader)
+        {
+            // the payload must at least hold the header
+            m_nextPktSize = std::max(m_nextPktSize, SeqTsSizeHeader().GetSerializedSize());
+        }
+    }
+    return m_nextPktSize;
+}
+
 void
 TimeStampedOnOffApplication::ScheduleStartEvent()
 { // Schedules the event to start sending data (switch to the "On" state)
@@ -345,11 +400,13 @@ TimeStampedOnOffApplication::ScheduleStopEvent()
 void
 TimeStampedOnOffApplication::SendPacket()
 {
+    QSE_PROFILE_SCOPE(ONOFF_SEND);
     // NS_LOG_FUNCTION(this);
 
     // NS_ASSERT(m_sendEvent.IsExpired());
 
     Ptr<Packet> packet;
+    uint32_t pktSize = NextPacketSize();
 
     if (m_unsentPacket)
     {
@@ -363,16 +420,16 @@ TimeStampedOnOffApplication::SendPacket()
         m_socket->GetPeerName(to);
         SeqTsSizeHeader header;
         header.SetSeq(m_seq++);
-        header.SetSize(m_pktSize);
-        NS_ABORT_IF(m_pktSize < header.GetSerializedSize());
-        packet = Create<Packet>(m_pktSize - header.GetSerializedSize());
+        header.SetSize(pktSize);
+        NS_ABORT_IF(pktSize < header.GetSerializedSize());
+        packet = Create<Packet>(pktSize - header.GetSerializedSize());
         // Trace before adding header, for consistency with PacketSink
         m_txTraceWithSeqTsSize(packet, from, to, header);
         packet->AddHeader(header);
     }
     else
     {
-        packet = Create<Packet>(m_pktSize);
+        packet = Create<Packet>(pktSize);
     }
 
     TrafficTypeHeader tHeader;
@@ -394,6 +451,7 @@ TimeStampedOnOffApplication::SendPacket()
         m_txTrace(packet);
         m_totBytes += packet->GetSize();
         m_unsentPacket = nullptr;
+        m_nextPktSize = 0;
         Address localAddress;
         m_socket->GetSockName(localAddress);
         if (InetSocketAddress::IsMatchingType(m_peer))
@@ -419,7 +477,7 @@ TimeStampedOnOffApplication::SendPacket()
     }
     else
     {
-        // NS_LOG_DEBUG("Unable to send packet; actual " << actual << " size " << m_pktSize
+        // NS_LOG_DEBUG("Unable to send packet; actual " << actual << " size " << pktSize
         //                                               << "; caching for later attempt");
         m_unsentPacket = packet;
     }
@@ -61,6 +61,14 @@ class Socket;
  * If the underlying socket type supports broadcast, this application
  * will automatically enable the SetAllowBroadcast(true) socket option.
  *
+ * If the attribute "PacketSizeDistribution" is set, the size of every packet
+ * is drawn from it (rounded to the nearest integer) instead of using
+ * "PacketSize". The size of a packet is drawn when its transmission is
+ * scheduled and kept until the packet is actually sent, also across Off
+ * periods, so the time between two packets is always the time needed to
+ * generate the bits of the next one and the long-term rate matches
+ * "DataRate" exactly for any size mix.
+ *
  * If the attribute "EnableSeqTsSizeHeader" is enabled, the application will
  * use some bytes of the payload to store an header with a sequence number,
  * a timestamp, and the size of the packet sent. Support for extracting
@@ -98,6 +106,15 @@ class TimeStampedOnOffApplication : public Application
      */
     Ptr<Socket> GetSocket() const;
 
+    /**
+     * \brief Return the local port the socket was bound to.
+     *
+     * Recorded in StartApplication, so it stays valid after the socket is
+     * closed at stop time.
+     * \return the local UDP port, 0 if the application never started
+     */
+    uint16_t GetLocalPort() const;
+
     int64_t AssignStreams(int64_t stream) override;
 
   protected:
@@ -147,8 +164,12 @@ class TimeStampedOnOffApplication : public Application
     TypeId m_tid;                        //!< Type of the socket used
     uint32_t m_seq{0};                   //!< Sequence
     Ptr<Packet> m_unsentPacket;          //!< Unsent packet cached for future attempt
+    uint16_t m_localPort{0};             //!< Local port, recorded while the socket is open
     bool m_enableSeqTsSizeHeader{false}; //!< Enable or disable the use of SeqTsSizeHeader
 
+    Ptr<RandomVariableStream> m_pktSizeDist; //!< rng for packet sizes, PacketSize if null
+    uint32_t m_nextPktSize{0};               //!< Size of the next packet, 0 if not drawn yet
+
     /// Traced Callback: transmitted packets.
     TracedCallback<Ptr<const Packet>> m_txTrace;
 
@@ -165,6 +186,11 @@ class TimeStampedOnOffApplication : public Application
      * \brief Schedule the next packet transmission
      */
     void ScheduleNextTx();
+    /**
+     * \brief Size of the next packet, drawn from the size distribution if needed
+     * \return the size of the next packet in bytes
+     */
+    uint32_t NextPacketSize();
     /**
      * \brief Schedule the next On period start
      */
@@ -0,0 +1,194 @@
+#include "topology.h"
+
+#include "ns3/abort.h"
+
+#include <algorithm>
+#include <deque>
+#include <set>
+#include <unordered_map>
+
+namespace
+{
+
+// liste di adiacenza per indice di nodo (topologia già normalizzata)
+std::vector<std::vector<uint32_t>>
+Adjacency(const Topology& topology)
+{
+    std::unordered_map<std::string, uint32_t> index;
+    for (uint32_t i = 0; i < topology.nodes.size(); ++i)
+    {
+        index[topology.nodes[i]] = i;
+    }
+    std::vector<std::vector<uint32_t>> adjacency(topology.nodes.size());
+    for (const auto& link : topology.links)
+    {
+        uint32_t a = index.at(link.source);
+        uint32_t b = index.at(link.target);
+        adjacency[a].push_back(b);
+        adjacency[b].push_back(a);
+    }
+    return adjacency;
+}
+
+// distanze in salti da source, -1 per i nodi non raggiungibili
+std::vector<int32_t>
+HopDistances(const std::vector<std::vector<uint32_t>>& adjacency, uint32_t source)
+{
+    std::vector<int32_t> distance(adjacency.size(), -1);
+    std::deque<uint32_t> queue{source};
+    distance[source] = 0;
+    while (!queue.empty())
+    {
+        uint32_t u = queue.front();
+        queue.pop_front();
+        for (uint32_t v : adjacency[u])
+        {
+            if (distance[v] < 0)
+            {
+                distance[v] = distance[u] + 1;
+                queue.push_back(v);
+            }
+        }
+    }
+    return distance;
+}
+
+} // namespace
+
+Topology
+AbileneTopology()
+{
+    Topology topology;
+    topology.name = "abilene";
+    topology.nodes = {"ATLAM5",
+                      "ATLAng",
+                      "CHINng",
+                      "DNVRng",
+                      "HSTNng",
+                      "IPLSng",
+                      "KSCYng",
+                      "LOSAng",
+                      "NYCMng",
+                      "SNVAng",
+                      "STTLng",
+                      "WASHng"};
+
+    // capacità originali scalate di un fattore 10
+    topology.links = {{"ATLAng", "ATLAM5", 9.92}, // 99.2Mbps
+                      {"HSTNng", "ATLAng", 9.92},
+                      {"IPLSng", "ATLAng", 9.48},
+                      {"WASHng", "ATLAng", 9.92},
+                      {"IPLSng", "CHINng", 9.92},
+                      {"NYCMng", "CHINng", 9.92},
+                      {"KSCYng", "DNVRng", 9.92},
+                      {"SNVAng", "DNVRng", 9.92},
+                      {"STTLng", "DNVRng", 9.92},
+                      {"KSCYng", "HSTNng", 9.92},
+                      {"LOSAng", "HSTNng", 9.92},
+                      {"KSCYng", "IPLSng", 9.92},
+                      {"SNVAng", "LOSAng", 9.92},
+                      {"WASHng", "NYCMng", 9.92},
+                      {"STTLng", "SNVAng", 9.92}};
+    return topology;
+}
+
+void
+NormalizeTopology(Topology& topology)
+{
+    std::sort(topology.nodes.begin(), topology.nodes.end());
+    NS_ABORT_MSG_IF(topology.nodes.size() < 2,
+                    "topologia " << topology.name << ": servono almeno due nodi");
+    auto duplicate = std::adjacent_find(topology.nodes.begin(), topology.nodes.end());
+    NS_ABORT_MSG_IF(duplicate != topology.nodes.end(),
+                    "topologia " << topology.name << ": nodo duplicato " << *duplicate);
+
+    std::set<std::pair<std::string, std::string>> seen;
+    for (const auto& link : topology.links)
+    {
+        for (const auto& end : {link.source, link.target})
+        {
+            NS_ABORT_MSG_IF(
+                !std::binary_search(topology.nodes.begin(), topology.nodes.end(), end),
+                "topologia " << topology.name << ": link verso il nodo sconosciuto " << end);
+        }
+        NS_ABORT_MSG_IF(link.source == link.target,
+                        "topologia " << topology.name << ": link " << link.source
+                                     << " su se stesso");
+        NS_ABORT_MSG_IF(link.capacityMbps <= 0 || link.delayMs < 0,
+                        "topologia " << topology.name << ": capacità o ritardo non validi sul "
+                                     << link.source << "-" << link.target);
+        auto key = std::minmax(link.source, link.target);
+        NS_ABORT_MSG_IF(!seen.emplace(key.first, key.second).second,
+                        "topologia " << topology.name << ": link ripetuto " << link.source << "-"
+                                     << link.target);
+    }
+
+    std::vector<int32_t> distance = HopDistances(Adjacency(topology), 0);
+    auto unreachable = std::find(distance.begin(), distance.end(), -1);
+    NS_ABORT_MSG_IF(unreachable != distance.end(),
+                    "topologia " << topology.name << ": il nodo "
+                                 << topology.nodes[unreachable - distance.begin()]
+                                 << " non è raggiungibile");
+}
+
+int32_t
+TopologyDiameter(const Topology& topology)
+{
+    // diametro esatto con una BFS per nodo, O(N·E): pochi secondi anche a mille nodi
+    auto adjacency = Adjacency(topology);
+    int32_t diameter = 0;
+    for (uint32_t i = 0; i < adjacency.size(); ++i)
+    {
+        auto distance = HopDistances(adjacency, i);
+        diameter = std::max(diameter, *std::max_element(distance.begin(), distance.end()));
+    }
+    return diameter;
+}
+
+void
+WriteTopologySummary(const Topology& topology, int32_t diameter, std::ostream& os)
+{
+    auto adjacency = Adjacency(topology);
+    size_t minDegree = adjacency.empty() ? 0 : adjacency[0].size();
+    size_t maxDegree = 0;
+    for (const auto& neighbours : adjacency)
+    {
+        minDegree = std::min(minDegree, neighbours.size());
+        maxDegree = std::max(maxDegree, neighbours.size());
+    }
+
+    os << "[TOPOLOGY] " << topology.name << " nodi=" << topology.nodes.size()
+       << " link=" << topology.links.size() << " grado_min=" << minDegree << " grado_medio="
+       << (adjacency.empty() ? 0.0 : 2.0 * topology.links.size() / adjacency.size())
+       << " grado_max=" << maxDegree << " diametro=" << diameter << std::endl;
+}
+
+std::vector<std::vector<uint32_t>>
+ShortestPathNextHops(const Topology& topology)
+{
+    auto adjacency = Adjacency(topology);
+    std::vector<std::vector<uint32_t>> nextHops(adjacency.size());
+    for (uint32_t dst = 0; dst < adjacency.size(); ++dst)
+    {
+        auto distance = HopDistances(adjacency, dst);
+        std::vector<uint32_t>& next = nextHops[dst];
+        next.assign(adjacency.size(), dst);
+        for (uint32_t u = 0; u < adjacency.size(); ++u)
+        {
+            if (u == dst)
+            {
+                continue;
+            }
+            uint32_t best = UINT32_MAX;
+            for (uint32_t v : adjacency[u])
+            {
+                if (distance[v] == distance[u] - 1)
+                {
+                    best = std::min(best, v);
+                }
+            }
+            next[u] = best;
+        }
+    }
+    return nextHops;
+}
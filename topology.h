@@ -0,0 +1,47 @@
+#ifndef TOPOLOGY_H
+#define TOPOLOGY_H
+
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <vector>
+
+// collegamento tra due router, con capacità scalata e ritardo di propagazione
+struct Link
+{
+    std::string source;
+    std::string target;
+    double capacityMbps;
+    double delayMs{1.0};
+};
+
+// Topologia dei router: la stessa struttura arriva dalla lista compilata di
+// Abilene o dai generatori sintetici (vedi topology_generator.h)
+struct Topology
+{
+    std::string name;
+    std::vector<std::string> nodes;
+    std::vector<Link> links;
+};
+
+// Abilene (https://sndlib.put.poznan.pl/home.action), 12 nodi e 15 link
+Topology AbileneTopology();
+
+// Ordina i nodi per nome, perché l'indice di un nodo nei DAG e nei Q-register
+// è la sua posizione in ordine alfabetico, e termina con errore se ci sono
+// nomi duplicati, link verso nodi sconosciuti, link ripetuti o se il grafo
+// non è connesso
+void NormalizeTopology(Topology& topology);
+
+// diametro in numero di salti, con una BFS per nodo: O(N·E)
+int32_t TopologyDiameter(const Topology& topology);
+
+// una riga [TOPOLOGY] con nodi, link, grado e diametro (da TopologyDiameter)
+void WriteTopologySummary(const Topology& topology, int32_t diameter, std::ostream& os);
+
+// prossimo salto di ogni nodo verso ogni destinazione su un cammino minimo
+// in salti: [destinazione][nodo], con indici in topology.nodes (la
+// destinazione punta a se stessa). A parità sceglie il vicino di indice minore
+std::vector<std::vector<uint32_t>> ShortestPathNextHops(const Topology& topology);
+
+#endif // TOPOLOGY_H
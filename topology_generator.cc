@@ -0,0 +1,405 @@
+#include "topology_generator.h"
+
+#include "topology_loader.h"
+
+#include "ns3/abort.h"
+
+#include <algorithm>
+#include <cmath>
+#include <iomanip>
+#include <numeric>
+#include <random>
+#include <set>
+#include <sstream>
+#include <tuple>
+
+namespace
+{
+
+// prefisso seguito da index con almeno width cifre
+std::string
+NumberedName(const std::string& prefix, uint32_t index, uint32_t width)
+{
+    std::ostringstream oss;
+    oss << prefix << std::setw(width) << std::setfill('0') << index;
+    return oss.str();
+}
+
+uint32_t
+DigitsFor(uint32_t count)
+{
+    uint32_t digits = 1;
+    for (uint32_t limit = 10; limit < count; limit *= 10)
+    {
+        digits++;
+    }
+    return digits;
+}
+
+struct Point
+{
+    double x;
+    double y;
+};
+
+double
+Distance(const Point& a, const Point& b)
+{
+    return std::hypot(a.x - b.x, a.y - b.y);
+}
+
+class UnionFind
+{
+  public:
+    explicit UnionFind(size_t n)
+        : m_parent(n)
+    {
+        std::iota(m_parent.begin(), m_parent.end(), 0);
+    }
+
+    size_t Find(size_t i)
+    {
+        while (m_parent[i] != i)
+        {
+            m_parent[i] = m_parent[m_parent[i]];
+            i = m_parent[i];
+        }
+        return i;
+    }
+
+    // false se a e b erano già nella stessa componente
+    bool Union(size_t a, size_t b)
+    {
+        a = Find(a);
+        b = Find(b);
+        if (a == b)
+        {
+            return false;
+        }
+        m_parent[a] = b;
+        return true;
+    }
+
+  private:
+    std::vector<size_t> m_parent;
+};
+
+// grafo sul piano: nodi r<i> nelle posizioni date e, se i link estratti lasciano
+// più componenti, le coppie più vicine tra componenti diverse (come in Kruskal)
+Topology
+PlaneTopology(const std::string& name,
+              const std::vector<Point>& points,
+              const std::vector<std::pair<uint32_t, uint32_t>>& edges,
+              double capacityMbps,
+              double spanDelayMs)
+{
+    Topology topology;
+    topology.name = name;
+    uint32_t width = DigitsFor(points.size());
+    for (uint32_t i = 0; i < points.size(); ++i)
+    {
+        topology.nodes.push_back(NumberedName("r", i, width));
+    }
+
+    auto addLink = [&](uint32_t a, uint32_t b) {
+        topology.links.push_back({topology.nodes[a],
+                                  topology.nodes[b],
+                                  capacityMbps,
+                                  spanDelayMs * Distance(points[a], points[b])});
+    };
+
+    UnionFind components(points.size());
+    size_t componentCount = points.size();
+    for (const auto& [a, b] : edges)
+    {
+        addLink(a, b);
+        componentCount -= components.Union(a, b) ? 1 : 0;
+    }
+    if (componentCount == 1)
+    {
+        return topology;
+    }
+
+    std::vector<std::tuple<double, uint32_t, uint32_t>> candidates;
+    for (uint32_t a = 0; a < points.size(); ++a)
+    {
+        for (uint32_t b = a + 1; b < points.size(); ++b)
+        {
+            if (components.Find(a) != components.Find(b))
+            {
+                candidates.emplace_back(Distance(points[a], points[b]), a, b);
+            }
+        }
+    }
+    std::sort(candidates.begin(), candidates.end());
+    for (const auto& [distance, a, b] : candidates)
+    {
+        if (componentCount == 1)
+        {
+            break;
+        }
+        if (components.Union(a, b))
+        {
+            addLink(a, b);
+            componentCount--;
+        }
+    }
+    return topology;
+}
+
+std::vector<Point>
+RandomPoints(uint32_t n, std::mt19937_64& rng)
+{
+    std::uniform_real_distribution<double> coordinate(0.0, 1.0);
+    std::vector<Point> points(n);
+    for (auto& p : points)
+    {
+        p.x = coordinate(rng);
+        p.y = coordinate(rng);
+    }
+    return points;
+}
+
+} // namespace
+
+Topology
+GenerateFatTree(uint32_t k, double capacityMbps, double delayMs)
+{
+    NS_ABORT_MSG_IF(k < 2 || k % 2 != 0, "fat-tree: k deve essere pari e >= 2");
+    uint32_t half = k / 2;
+    uint32_t coreWidth = DigitsFor(half * half);
+    uint32_t podWidth = DigitsFor(k);
+    uint32_t switchWidth = DigitsFor(half);
+
+    Topology topology;
+    topology.name = "fattree";
+    std::vector<std::string> core;
+    for (uint32_t c = 0; c < half * half; ++c)
+    {
+        core.push_back(NumberedName("core", c, coreWidth));
+        topology.nodes.push_back(core.back());
+    }
+
+    for (uint32_t pod = 0; pod < k; ++pod)
+    {
+        std::string podName = NumberedName("pod", pod, podWidth);
+        std::vector<std::string> aggregation;
+        for (uint32_t a = 0; a < half; ++a)
+        {
+            aggregation.push_back(NumberedName(podName + "agg", a, switchWidth));
+            topology.nodes.push_back(aggregation.back());
+            // l'aggregation a del pod è collegato ai core a*k/2 ... a*k/2 + k/2 - 1
+            for (uint32_t c = 0; c < half; ++c)
+            {
+                topology.links.push_back(
+                    {aggregation.back(), core[a * half + c], capacityMbps, delayMs});
+            }
+        }
+        for (uint32_t e = 0; e < half; ++e)
+        {
+            std::string edge = NumberedName(podName + "edge", e, switchWidth);
+            topology.nodes.push_back(edge);
+            for (const auto& agg : aggregation)
+            {
+                topology.links.push_back({edge, agg, capacityMbps, delayMs});
+            }
+        }
+    }
+    return topology;
+}
+
+Topology
+GenerateRandomGeometric(uint32_t n,
+                        double radius,
+                        double capacityMbps,
+                        double spanDelayMs,
+                        uint64_t seed)
+{
+    std::mt19937_64 rng(seed);
+    std::vector<Point> points = RandomPoints(n, rng);
+
+    // griglia di celle di lato radius: si confrontano solo le celle adiacenti
+    uint32_t cells = std::max<uint32_t>(1, static_cast<uint32_t>(1.0 / radius));
+    auto cellOf = [cells](double v) {
+        return std::min(cells - 1, static_cast<uint32_t>(v * cells));
+    };
+    std::vector<std::vector<uint32_t>> grid(cells * cells);
+    for (uint32_t i = 0; i < n; ++i)
+    {
+        grid[cellOf(points[i].y) * cells + cellOf(points[i].x)].push_back(i);
+    }
+
+    std::vector<std::pair<uint32_t, uint32_t>> edges;
+    for (uint32_t i = 0; i < n; ++i)
+    {
+        int32_t cx = cellOf(points[i].x);
+        int32_t cy = cellOf(points[i].y);
+        for (int32_t y = std::max(0, cy - 1); y <= std::min<int32_t>(cells - 1, cy + 1); ++y)
+        {
+            for (int32_t x = std::max(0, cx - 1); x <= std::min<int32_t>(cells - 1, cx + 1); ++x)
+            {
+                for (uint32_t j : grid[y * cells + x])
+                {
+                    if (j > i && Distance(points[i], points[j]) <= radius)
+                    {
+                        edges.emplace_back(i, j);
+                    }
+                }
+            }
+        }
+    }
+    return PlaneTopology("geometric", points, edges, capacityMbps, spanDelayMs);
+}
+
+Topology
+GenerateWaxman(uint32_t n,
+               double alpha,
+               double beta,
+               double capacityMbps,
+               double spanDelayMs,
+               uint64_t seed)
+{
+    std::mt19937_64 rng(seed);
+    std::vector<Point> points = RandomPoints(n, rng);
+    std::uniform_real_distribution<double> draw(0.0, 1.0);
+    const double maxDistance = std::sqrt(2.0);
+
+    std::vector<std::pair<uint32_t, uint32_t>> edges;
+    for (uint32_t i = 0; i < n; ++i)
+    {
+        for (uint32_t j = i + 1; j < n; ++j)
+        {
+            double d = Distance(points[i], points[j]);
+            if (draw(rng) < beta * std::exp(-d / (alpha * maxDistance)))
+            {
+                edges.emplace_back(i, j);
+            }
+        }
+    }
+    return PlaneTopology("waxman", points, edges, capacityMbps, spanDelayMs);
+}
+
+Topology
+GenerateRingOfRings(uint32_t n, uint32_t rings, double capacityMbps, double delayMs)
+{
+    NS_ABORT_MSG_IF(rings < 1 || n < rings * 3,
+                    "ring-of-rings: servono almeno 3 router per anello");
+    uint32_t ringWidth = DigitsFor(rings);
+    uint32_t nodeWidth = DigitsFor(n / rings + 1);
+
+    Topology topology;
+    topology.name = "ringofrings";
+    std::vector<std::string> gateways;
+    for (uint32_t r = 0; r < rings; ++r)
+    {
+        // i router avanzati vanno ai primi anelli
+        uint32_t size = n / rings + (r < n % rings ? 1 : 0);
+        std::string ringName = NumberedName("ring", r, ringWidth);
+        std::vector<std::string> ring;
+        for (uint32_t i = 0; i < size; ++i)
+        {
+            ring.push_back(NumberedName(ringName + "r", i, nodeWidth));
+            topology.nodes.push_back(ring.back());
+        }
+        for (uint32_t i = 0; i < size; ++i)
+        {
+            topology.links.push_back({ring[i], ring[(i + 1) % size], capacityMbps, delayMs});
+        }
+        gateways.push_back(ring.front());
+    }
+
+    // anello di core tra i gateway (un solo link se gli anelli sono due)
+    for (uint32_t r = 0; rings > 1 && r < (rings == 2 ? 1 : rings); ++r)
+    {
+        topology.links.push_back(
+            {gateways[r], gateways[(r + 1) % rings], capacityMbps, delayMs});
+    }
+    return topology;
+}
+
+Topology
+BuildTopology(const SimulationParameters& params)
+{
+    Topology topology;
+    if (params.topology == "abilene")
+    {
+        topology = AbileneTopology();
+        for (auto& link : topology.links)
+        {
+            link.delayMs = params.topologyDelay;
+        }
+    }
+    else if (params.topology == "fattree")
+    {
+        topology =
+            GenerateFatTree(params.topologySize, params.topologyCapacity, params.topologyDelay);
+    }
+    else if (params.topology == "geometric")
+    {
+        topology = GenerateRandomGeometric(params.topologySize,
+                                           params.topologyRadius,
+                                           params.topologyCapacity,
+                                           params.topologySpanDelay,
+                                           params.topologySeed);
+    }
+    else if (params.topology == "waxman")
+    {
+        topology = GenerateWaxman(params.topologySize,
+                                  params.waxmanAlpha,
+                                  params.waxmanBeta,
+                                  params.topologyCapacity,
+                                  params.topologySpanDelay,
+                                  params.topologySeed);
+    }
+    else if (params.topology == "ringofrings")
+    {
+        topology = GenerateRingOfRings(params.topologySize,
+                                       params.topologyRings,
+                                       params.topologyCapacity,
+                                       params.topologyDelay);
+    }
+    else if (params.topology == "file")
+    {
+        topology = LoadTopologyFile(params.topologyFile,
+                                    params.topologyCapacityScale,
+                                    params.topologyCapacity,
+                                    params.topologyDelay);
+    }
+    else
+    {
+        NS_FATAL_ERROR("topologia sconosciuta: " << params.topology);
+    }
+    NormalizeTopology(topology);
+    return topology;
+}
+
+std::vector<std::vector<FlowDemand>>
+GenerateDemandMatrices(const Topology& topology, const SimulationParameters& params)
+{
+    const auto& nodes = topology.nodes;
+    uint64_t pairs = static_cast<uint64_t>(nodes.size()) * (nodes.size() - 1);
+    uint64_t flows = params.topologyFlows > 0 ? params.topologyFlows : 2 * nodes.size();
+    flows = std::min(flows, pairs);
+
+    // il seme dipende da quello della topologia: stesse matrici su ogni replica
+    std::mt19937_64 rng(params.topologySeed * 1000003ULL + 17);
+    std::uniform_int_distribution<size_t> pick(0, nodes.size() - 1);
+    std::uniform_real_distribution<double> rate(0.5, 1.5);
+
+    std::vector<std::vector<FlowDemand>> matrices(
+        std::max(params.normalMatrix, params.sensitiveMatrix) + 1);
+    for (auto& matrix : matrices)
+    {
+        std::set<std::pair<size_t, size_t>> chosen;
+        while (chosen.size() < flows)
+        {
+            size_t src = pick(rng);
+            size_t dst = pick(rng);
+            if (src != dst && chosen.emplace(src, dst).second)
+            {
+                matrix.push_back({nodes[src], nodes[dst], params.topologyDemand * rate(rng)});
+            }
+        }
+    }
+    return matrices;
+}
@@ -0,0 +1,51 @@
+#ifndef TOPOLOGY_GENERATOR_H
+#define TOPOLOGY_GENERATOR_H
+
+#include "flow_demand_reader.h"
+#include "simulation_parameters.h"
+#include "topology.h"
+
+#include <cstdint>
+#include <vector>
+
+// Topologie sintetiche per gli studi di scalabilità. I generatori casuali
+// usano un proprio generatore inizializzato con seed, indipendente da RngRun:
+// le repliche cambiano il traffico ma non la rete. I nomi dei nodi hanno
+// cifre a larghezza fissa, così l'ordine alfabetico segue la numerazione.
+
+// fat-tree a k porte (k pari): (k/2)^2 core, k pod di k/2 aggregation e k/2
+// edge, in totale 5k^2/4 router
+Topology GenerateFatTree(uint32_t k, double capacityMbps, double delayMs);
+
+// grafo geometrico casuale: n punti uniformi nel quadrato unitario, collegati
+// se a distanza <= radius. Il ritardo è proporzionale alla distanza
+// (spanDelayMs per il lato del quadrato)
+Topology GenerateRandomGeometric(uint32_t n,
+                                 double radius,
+                                 double capacityMbps,
+                                 double spanDelayMs,
+                                 uint64_t seed);
+
+// Waxman: n punti uniformi nel quadrato unitario, ogni coppia collegata con
+// probabilità beta * exp(-d / (alpha * L)), L = distanza massima possibile
+Topology GenerateWaxman(uint32_t n,
+                        double alpha,
+                        double beta,
+                        double capacityMbps,
+                        double spanDelayMs,
+                        uint64_t seed);
+
+// n router divisi in rings anelli di accesso; il primo router di ogni anello
+// fa da gateway su un anello di core che li unisce
+Topology GenerateRingOfRings(uint32_t n, uint32_t rings, double capacityMbps, double delayMs);
+
+// topologia scelta da --topology, già normalizzata
+Topology BuildTopology(const SimulationParameters& params);
+
+// matrici di domanda per le topologie generate: ognuna con topologyFlows coppie
+// (src, dst) distinte scelte a caso e rate uniforme in [0.5, 1.5] x topologyDemand.
+// Sono tante quante ne servono a normalMatrix e sensitiveMatrix
+std::vector<std::vector<FlowDemand>> GenerateDemandMatrices(const Topology& topology,
+                                                            const SimulationParameters& params);
+
+#endif // TOPOLOGY_GENERATOR_H
@@ -0,0 +1,310 @@
+#include "topology_loader.h"
+
+#include "xml_lite.h"
+
+#include "ns3/abort.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <unordered_map>
+
+namespace
+{
+
+// ritardo di propagazione in fibra
+const double kMsPerKm = 0.005;
+// ritardo minimo, anche per nodi con le stesse coordinate
+const double kMinDelayMs = 0.01;
+
+struct RawNode
+{
+    std::string name;
+    bool hasCoordinates{false};
+    double latitude{0.0};
+    double longitude{0.0};
+};
+
+// valori negativi = non indicato nel file
+struct RawLink
+{
+    uint32_t a;
+    uint32_t b;
+    double capacityMbps{-1.0};
+    double delayMs{-1.0};
+};
+
+bool
+ReadFile(const std::string& path, std::string& content)
+{
+    std::ifstream in(path, std::ios::binary);
+    if (!in)
+    {
+        return false;
+    }
+    std::ostringstream ss;
+    ss << in.rdbuf();
+    content = ss.str();
+    return true;
+}
+
+// numero in text, fallback se vuoto o non numerico
+double
+ParseNumber(const std::string& text, double fallback)
+{
+    try
+    {
+        size_t used = 0;
+        double value = std::stod(text, &used);
+        return used == text.size() ? value : fallback;
+    }
+    catch (const std::exception&)
+    {
+        return fallback;
+    }
+}
+
+// distanza ortodromica (formula dell'emisenoverso)
+double
+GreatCircleKm(const RawNode& a, const RawNode& b)
+{
+    const double radians = M_PI / 180.0;
+    double dLat = (b.latitude - a.latitude) * radians;
+    double dLon = (b.longitude - a.longitude) * radians;
+    double h = std::sin(dLat / 2) * std::sin(dLat / 2) +
+               std::cos(a.latitude * radians) * std::cos(b.latitude * radians) *
+                   std::sin(dLon / 2) * std::sin(dLon / 2);
+    return 2 * 6371.0 * std::asin(std::min(1.0, std::sqrt(h)));
+}
+
+void
+ParseSndlib(const XmlElement& root,
+            const std::string& path,
+            std::vector<RawNode>& nodes,
+            std::vector<RawLink>& links)
+{
+    const XmlElement* structure = root.Child("networkStructure");
+    const XmlElement* nodesElement = structure ? structure->Child("nodes") : nullptr;
+    const XmlElement* linksElement = structure ? structure->Child("links") : nullptr;
+    NS_ABORT_MSG_IF(!nodesElement || !linksElement,
+                    path << ": <networkStructure> senza <nodes> o <links>");
+    bool geographical = nodesElement->Attribute("coordinatesType") != "pixel";
+
+    std::unordered_map<std::string, uint32_t> index;
+    for (const XmlElement* n : nodesElement->Children("node"))
+    {
+        RawNode node;
+        node.name = n->Attribute("id");
+        NS_ABORT_MSG_IF(node.name.empty(), path << ": nodo senza id");
+        const XmlElement* coordinates = n->Child("coordinates");
+        if (geographical && coordinates)
+        {
+            // SNDlib: x = longitudine, y = latitudine
+            node.longitude = ParseNumber(coordinates->ChildText("x"), NAN);
+            node.latitude = ParseNumber(coordinates->ChildText("y"), NAN);
+            node.hasCoordinates = !std::isnan(node.longitude) && !std::isnan(node.latitude);
+        }
+        index[node.name] = nodes.size();
+        nodes.push_back(node);
+    }
+
+    for (const XmlElement* l : linksElement->Children("link"))
+    {
+        auto source = index.find(l->ChildText("source"));
+        auto target = index.find(l->ChildText("target"));
+        NS_ABORT_MSG_IF(source == index.end() || target == index.end(),
+                        path << ": link " << l->Attribute("id") << " tra nodi sconosciuti");
+        RawLink link{source->second, target->second};
+
+        const XmlElement* preInstalled = l->Child("preInstalledModule");
+        if (preInstalled)
+        {
+            link.capacityMbps = ParseNumber(preInstalled->ChildText("capacity"), -1.0);
+        }
+        const XmlElement* additional = l->Child("additionalModules");
+        if (link.capacityMbps <= 0 && additional)
+        {
+            for (const XmlElement* m : additional->Children("addModule"))
+            {
+                link.capacityMbps =
+                    std::max(link.capacityMbps, ParseNumber(m->ChildText("capacity"), -1.0));
+            }
+        }
+        links.push_back(link);
+    }
+}
+
+void
+ParseGraphml(const XmlElement& root,
+             const std::string& path,
+             std::vector<RawNode>& nodes,
+             std::vector<RawLink>& links)
+{
+    const XmlElement* graph = root.Child("graph");
+    NS_ABORT_MSG_IF(!graph, path << ": <graphml> senza <graph>");
+
+    // id delle chiavi <data> per nome dell'attributo, separati per nodi e archi
+    std::map<std::string, std::string> nodeKeys;
+    std::map<std::string, std::string> edgeKeys;
+    for (const XmlElement* key : root.Children("key"))
+    {
+        std::string target = key->Attribute("for");
+        if (target == "node" || target == "all")
+        {
+            nodeKeys[key->Attribute("id")] = key->Attribute("attr.name");
+        }
+        if (target == "edge" || target == "all")
+        {
+            edgeKeys[key->Attribute("id")] = key->Attribute("attr.name");
+        }
+    }
+    auto readData = [](const XmlElement& element, const std::map<std::string, std::string>& keys) {
+        std::map<std::string, std::string> values;
+        for (const XmlElement* data : element.Children("data"))
+        {
+            auto it = keys.find(data->Attribute("key"));
+            values[it == keys.end() ? data->Attribute("key") : it->second] = data->text;
+        }
+        return values;
+    };
+
+    std::unordered_map<std::string, uint32_t> index;
+    for (const XmlElement* n : graph->Children("node"))
+    {
+        std::string id = n->Attribute("id");
+        NS_ABORT_MSG_IF(id.empty(), path << ": nodo senza id");
+        auto data = readData(*n, nodeKeys);
+        RawNode node;
+        node.name = data["label"].empty() ? id : data["label"];
+        node.latitude = ParseNumber(data["Latitude"], NAN);
+        node.longitude = ParseNumber(data["Longitude"], NAN);
+        node.hasCoordinates = !std::isnan(node.latitude) && !std::isnan(node.longitude);
+        index[id] = nodes.size();
+        nodes.push_back(node);
+    }
+
+    for (const XmlElement* e : graph->Children("edge"))
+    {
+        auto source = index.find(e->Attribute("source"));
+        auto target = index.find(e->Attribute("target"));
+        NS_ABORT_MSG_IF(source == index.end() || target == index.end(),
+                        path << ": arco " << e->Attribute("source") << "-"
+                             << e->Attribute("target") << " tra nodi sconosciuti");
+        auto data = readData(*e, edgeKeys);
+        RawLink link{source->second, target->second};
+        link.capacityMbps = ParseNumber(data["capacity"], -1.0);
+        if (link.capacityMbps <= 0)
+        {
+            double raw = ParseNumber(data["LinkSpeedRaw"], -1.0);
+            link.capacityMbps = raw > 0 ? raw * 1e-6 : -1.0;
+        }
+        link.delayMs = ParseNumber(data["delay"], -1.0);
+        links.push_back(link);
+    }
+}
+
+} // namespace
+
+std::string
+SanitizeNodeName(const std::string& name)
+{
+    std::string result = name;
+    for (char& c : result)
+    {
+        if (!std::isalnum(static_cast<unsigned char>(c)) && c != '_' && c != '.')
+        {
+            c = '_';
+        }
+    }
+    return result.empty() ? "_" : result;
+}
+
+Topology
+LoadTopologyFile(const std::string& path,
+                 double capacityScale,
+                 double defaultCapacityMbps,
+                 double defaultDelayMs)
+{
+    std::string content;
+    NS_ABORT_MSG_IF(!ReadFile(path, content), "impossibile leggere la topologia " << path);
+    std::string error;
+    std::unique_ptr<XmlElement> root = ParseXml(content, error);
+    NS_ABORT_MSG_IF(!root, path << ": " << error);
+
+    std::vector<RawNode> nodes;
+    std::vector<RawLink> links;
+    if (root->name == "network")
+    {
+        ParseSndlib(*root, path, nodes, links);
+    }
+    else if (root->name == "graphml")
+    {
+        ParseGraphml(*root, path, nodes, links);
+    }
+    else
+    {
+        NS_FATAL_ERROR(path << ": radice <" << root->name << "> né SNDlib né GraphML");
+    }
+
+    Topology topology;
+    topology.name = std::filesystem::path(path).stem().string();
+
+    // nomi unici: a un nome ripetuto si aggiunge la posizione del nodo nel file
+    std::unordered_map<std::string, uint32_t> seen;
+    for (uint32_t i = 0; i < nodes.size(); ++i)
+    {
+        std::string name = SanitizeNodeName(nodes[i].name);
+        if (seen.count(name))
+        {
+            name += "_" + std::to_string(i);
+        }
+        seen[name] = i;
+        topology.nodes.push_back(name);
+    }
+
+    std::map<std::pair<uint32_t, uint32_t>, size_t> merged;
+    size_t defaulted = 0;
+    for (const auto& raw : links)
+    {
+        if (raw.a == raw.b)
+        {
+            continue; // anelli su un nodo, presenti in alcuni GraphML
+        }
+        double capacity = raw.capacityMbps > 0 ? raw.capacityMbps * capacityScale
+                                               : defaultCapacityMbps;
+        defaulted += raw.capacityMbps > 0 ? 0 : 1;
+        double delay = defaultDelayMs;
+        if (raw.delayMs >= 0)
+        {
+            delay = raw.delayMs;
+        }
+        else if (nodes[raw.a].hasCoordinates && nodes[raw.b].hasCoordinates)
+        {
+            delay = std::max(kMinDelayMs, GreatCircleKm(nodes[raw.a], nodes[raw.b]) * kMsPerKm);
+        }
+
+        auto key = std::minmax(raw.a, raw.b);
+        auto [it, inserted] = merged.emplace(key, topology.links.size());
+        if (inserted)
+        {
+            topology.links.push_back(
+                {topology.nodes[raw.a], topology.nodes[raw.b], capacity, delay});
+        }
+        else
+        {
+            Link& link = topology.links[it->second];
+            link.capacityMbps += capacity;
+            link.delayMs = std::min(link.delayMs, delay);
+        }
+    }
+
+    std::cout << "[TOPOLOGY] " << path << ": " << nodes.size() << " nodi, " << links.size()
+              << " link nel file, " << topology.links.size() << " dopo l'unione dei paralleli, "
+              << defaulted << " senza capacità" << std::endl;
+    return topology;
+}
@@ -0,0 +1,30 @@
+#ifndef TOPOLOGY_LOADER_H
+#define TOPOLOGY_LOADER_H
+
+#include "topology.h"
+
+#include <string>
+
+// Caricamento di una topologia da file: SNDlib XML (radice <network>) o
+// GraphML (radice <graphml>, es. Internet Topology Zoo), riconosciuto dal
+// contenuto.
+//
+// Le capacità lette dal file (SNDlib: modulo preinstallato o, se assente, il
+// più grande tra quelli aggiuntivi; GraphML: chiave "capacity" in Mbps o
+// "LinkSpeedRaw" in bit/s) sono moltiplicate per capacityScale; i link senza
+// capacità usano defaultCapacityMbps. Il ritardo è la chiave "delay" (ms) se
+// presente, altrimenti la distanza ortodromica tra le coordinate geografiche
+// dei nodi a 5 us/km, altrimenti defaultDelayMs.
+//
+// I nomi dei nodi sono resi validi per i file di output (caratteri diversi
+// da lettere, cifre, '_' e '.' diventano '_'); i link paralleli sono uniti
+// sommandone le capacità. Termina con errore se il file non è valido.
+Topology LoadTopologyFile(const std::string& path,
+                          double capacityScale,
+                          double defaultCapacityMbps,
+                          double defaultDelayMs);
+
+// la trasformazione dei nomi applicata ai nodi, usata anche per le domande
+std::string SanitizeNodeName(const std::string& name);
+
+#endif // TOPOLOGY_LOADER_H
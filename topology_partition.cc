@@ -0,0 +1,129 @@
+#include "topology_partition.h"
+
+#include "ns3/abort.h"
+
+#include <deque>
+
+TopologyPartition::TopologyPartition(
+    const std::vector<std::string>& nodeNames,
+    const std::vector<std::pair<std::string, std::string>>& edges,
+    uint32_t nRanks,
+    uint32_t localRank)
+    : m_nRanks(nRanks),
+      m_localRank(localRank)
+{
+    NS_ABORT_MSG_IF(nRanks == 0 || localRank >= nRanks, "partizione: rank non valido");
+    NS_ABORT_MSG_IF(nRanks > nodeNames.size(),
+                    "partizione: " << nRanks << " rank per soli " << nodeNames.size()
+                                   << " router");
+
+    std::map<std::string, size_t> index;
+    for (size_t i = 0; i < nodeNames.size(); ++i)
+    {
+        index[nodeNames[i]] = i;
+    }
+    std::vector<std::vector<size_t>> adjacency(nodeNames.size());
+    for (const auto& [a, b] : edges)
+    {
+        auto ia = index.find(a);
+        auto ib = index.find(b);
+        NS_ABORT_MSG_IF(ia == index.end() || ib == index.end(),
+                        "partizione: collegamento tra nodi sconosciuti " << a << " - " << b);
+        adjacency[ia->second].push_back(ib->second);
+        adjacency[ib->second].push_back(ia->second);
+    }
+
+    // visita in ampiezza, ripartendo dal primo nodo non visitato se il grafo
+    // non è connesso
+    std::vector<size_t> order;
+    std::vector<bool> visited(nodeNames.size(), false);
+    for (size_t start = 0; start < nodeNames.size(); ++start)
+    {
+        if (visited[start])
+        {
+            continue;
+        }
+        std::deque<size_t> queue{start};
+        visited[start] = true;
+        while (!queue.empty())
+        {
+            size_t node = queue.front();
+            queue.pop_front();
+            order.push_back(node);
+            for (size_t next : adjacency[node])
+            {
+                if (!visited[next])
+                {
+                    visited[next] = true;
+                    queue.push_back(next);
+                }
+            }
+        }
+    }
+
+    // blocchi contigui: i primi (N mod R) rank hanno un router in più
+    size_t base = order.size() / nRanks;
+    size_t extra = order.size() % nRanks;
+    size_t position = 0;
+    for (uint32_t rank = 0; rank < nRanks; ++rank)
+    {
+        size_t blockSize = base + (rank < extra ? 1 : 0);
+        for (size_t i = 0; i < blockSize; ++i)
+        {
+            m_rank[nodeNames[order[position++]]] = rank;
+        }
+    }
+
+    for (const auto& [a, b] : edges)
+    {
+        m_cutEdges += m_rank.at(a) != m_rank.at(b) ? 1 : 0;
+    }
+}
+
+uint32_t
+TopologyPartition::GetRank(const std::string& nodeName) const
+{
+    auto it = m_rank.find(nodeName);
+    NS_ABORT_MSG_IF(it == m_rank.end(), "partizione: nodo sconosciuto " << nodeName);
+    return it->second;
+}
+
+bool
+TopologyPartition::IsLocal(const std::string& nodeName) const
+{
+    return GetRank(nodeName) == m_localRank;
+}
+
+uint32_t
+TopologyPartition::GetNRanks() const
+{
+    return m_nRanks;
+}
+
+uint32_t
+TopologyPartition::GetLocalRank() const
+{
+    return m_localRank;
+}
+
+size_t
+TopologyPartition::GetCutEdges() const
+{
+    return m_cutEdges;
+}
+
+void
+TopologyPartition::WriteSummary(std::ostream& os) const
+{
+    std::vector<size_t> routers(m_nRanks, 0);
+    for (const auto& [name, rank] : m_rank)
+    {
+        routers[rank]++;
+    }
+    for (uint32_t rank = 0; rank < m_nRanks; ++rank)
+    {
+        os << "[MPI] rank=" << rank << " router=" << routers[rank]
+           << (rank == m_localRank ? " (locale)" : "") << "\n";
+    }
+    os << "[MPI] collegamenti tagliati=" << m_cutEdges << std::endl;
+}
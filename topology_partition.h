@@ -0,0 +1,43 @@
+#ifndef TOPOLOGY_PARTITION_H
+#define TOPOLOGY_PARTITION_H
+
+#include <cstdint>
+#include <map>
+#include <ostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+// Suddivisione dei router tra i rank MPI per la simulazione distribuita.
+// I router sono ordinati per visita in ampiezza e divisi in blocchi contigui
+// di dimensione bilanciata, così i vicini tendono a finire sullo stesso rank
+// e i collegamenti tagliati (quelli tra rank diversi, simulati con canali
+// point-to-point remoti) restano pochi. Ogni host segue il proprio router:
+// il collegamento host-router non è mai un confine di partizione.
+class TopologyPartition
+{
+  public:
+    // nodeNames: router nell'ordine di nodeIds; edges: collegamenti tra router
+    TopologyPartition(const std::vector<std::string>& nodeNames,
+                      const std::vector<std::pair<std::string, std::string>>& edges,
+                      uint32_t nRanks,
+                      uint32_t localRank);
+
+    uint32_t GetRank(const std::string& nodeName) const;
+    bool IsLocal(const std::string& nodeName) const;
+    uint32_t GetNRanks() const;
+    uint32_t GetLocalRank() const;
+    // collegamenti con estremi su rank diversi
+    size_t GetCutEdges() const;
+
+    // una riga per rank con numero di router e collegamenti tagliati ([MPI])
+    void WriteSummary(std::ostream& os) const;
+
+  private:
+    std::map<std::string, uint32_t> m_rank;
+    uint32_t m_nRanks;
+    uint32_t m_localRank;
+    size_t m_cutEdges{0};
+};
+
+#endif // TOPOLOGY_PARTITION_H
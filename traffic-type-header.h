@@ -14,6 +14,10 @@ class TrafficTypeHeader : public Header
         DELAY_SENSITIVE = 1
     };
 
+    // Traffic Class IPv6 (DSCP EF) con cui vengono marcati i segmenti TCP
+    // delay-sensitive: il TrafficTypeHeader non sopravvive alla segmentazione TCP
+    static constexpr uint8_t DELAY_SENSITIVE_TCLASS = 0xb8;
+
     TrafficTypeHeader()
         : m_type(NORMAL)
     {
@@ -0,0 +1,289 @@
+#include "xml_lite.h"
+
+#include <cctype>
+
+namespace
+{
+
+std::string
+Trim(const std::string& s)
+{
+    size_t begin = 0;
+    size_t end = s.size();
+    while (begin < end && std::isspace(static_cast<unsigned char>(s[begin])))
+    {
+        begin++;
+    }
+    while (end > begin && std::isspace(static_cast<unsigned char>(s[end - 1])))
+    {
+        end--;
+    }
+    return s.substr(begin, end - begin);
+}
+
+std::string
+StripNamespace(const std::string& name)
+{
+    size_t colon = name.find(':');
+    return colon == std::string::npos ? name : name.substr(colon + 1);
+}
+
+std::string
+DecodeEntities(const std::string& s)
+{
+    static const std::pair<const char*, char> entities[] = {{"&lt;", '<'},
+                                                            {"&gt;", '>'},
+                                                            {"&amp;", '&'},
+                                                            {"&quot;", '"'},
+                                                            {"&apos;", '\''}};
+    std::string out;
+    out.reserve(s.size());
+    for (size_t i = 0; i < s.size();)
+    {
+        bool decoded = false;
+        if (s[i] == '&')
+        {
+            for (const auto& [entity, c] : entities)
+            {
+                if (s.compare(i, std::char_traits<char>::length(entity), entity) == 0)
+                {
+                    out += c;
+                    i += std::char_traits<char>::length(entity);
+                    decoded = true;
+                    break;
+                }
+            }
+        }
+        if (!decoded)
+        {
+            out += s[i++];
+        }
+    }
+    return out;
+}
+
+class XmlParser
+{
+  public:
+    XmlParser(const std::string& content)
+        : m_s(content),
+          m_pos(0)
+    {
+    }
+
+    std::unique_ptr<XmlElement> ParseDocument(std::string& error)
+    {
+        SkipMisc();
+        if (m_pos >= m_s.size() || m_s[m_pos] != '<')
+        {
+            error = "nessun elemento radice";
+            return nullptr;
+        }
+        auto root = ParseElement(error);
+        return error.empty() ? std::move(root) : nullptr;
+    }
+
+  private:
+    // salta spazi, dichiarazioni <?...?>, commenti e <!DOCTYPE>
+    void SkipMisc()
+    {
+        while (m_pos < m_s.size())
+        {
+            if (std::isspace(static_cast<unsigned char>(m_s[m_pos])))
+            {
+                m_pos++;
+            }
+            else if (m_s.compare(m_pos, 2, "<?") == 0)
+            {
+                SkipPast("?>");
+            }
+            else if (m_s.compare(m_pos, 4, "<!--") == 0)
+            {
+                SkipPast("-->");
+            }
+            else if (m_s.compare(m_pos, 2, "<!") == 0)
+            {
+                SkipPast(">");
+            }
+            else
+            {
+                break;
+            }
+        }
+    }
+
+    void SkipPast(const char* token)
+    {
+        size_t found = m_s.find(token, m_pos);
+        m_pos = (found == std::string::npos) ? m_s.size()
+                                             : found + std::char_traits<char>::length(token);
+    }
+
+    std::string ReadName()
+    {
+        size_t begin = m_pos;
+        while (m_pos < m_s.size() && !std::isspace(static_cast<unsigned char>(m_s[m_pos])) &&
+               m_s[m_pos] != '>' && m_s[m_pos] != '/' && m_s[m_pos] != '=')
+        {
+            m_pos++;
+        }
+        return m_s.substr(begin, m_pos - begin);
+    }
+
+    void SkipSpaces()
+    {
+        while (m_pos < m_s.size() && std::isspace(static_cast<unsigned char>(m_s[m_pos])))
+        {
+            m_pos++;
+        }
+    }
+
+    std::unique_ptr<XmlElement> ParseElement(std::string& error)
+    {
+        auto element = std::make_unique<XmlElement>();
+        m_pos++; // '<'
+        std::string rawName = ReadName();
+        element->name = StripNamespace(rawName);
+
+        // attributi
+        while (true)
+        {
+            SkipSpaces();
+            if (m_pos >= m_s.size())
+            {
+                error = "fine del file dentro il tag " + rawName;
+                return nullptr;
+            }
+            if (m_s[m_pos] == '/')
+            {
+                m_pos += 2; // "/>"
+                return element;
+            }
+            if (m_s[m_pos] == '>')
+            {
+                m_pos++;
+                break;
+            }
+
+            std::string key = StripNamespace(ReadName());
+            SkipSpaces();
+            if (m_pos >= m_s.size() || m_s[m_pos] != '=')
+            {
+                error = "attributo senza valore nel tag " + rawName;
+                return nullptr;
+            }
+            m_pos++;
+            SkipSpaces();
+            char quote = m_pos < m_s.size() ? m_s[m_pos] : '\0';
+            if (quote != '"' && quote != '\'')
+            {
+                error = "valore di attributo senza virgolette nel tag " + rawName;
+                return nullptr;
+            }
+            size_t end = m_s.find(quote, m_pos + 1);
+            if (end == std::string::npos)
+            {
+                error = "valore di attributo non terminato nel tag " + rawName;
+                return nullptr;
+            }
+            element->attributes[key] = DecodeEntities(m_s.substr(m_pos + 1, end - m_pos - 1));
+            m_pos = end + 1;
+        }
+
+        // contenuto
+        std::string text;
+        while (m_pos < m_s.size())
+        {
+            if (m_s[m_pos] != '<')
+            {
+                size_t next = m_s.find('<', m_pos);
+                if (next == std::string::npos)
+                {
+                    next = m_s.size();
+                }
+                text += m_s.substr(m_pos, next - m_pos);
+                m_pos = next;
+            }
+            else if (m_s.compare(m_pos, 2, "</") == 0)
+            {
+                SkipPast(">");
+                element->text = DecodeEntities(Trim(text));
+                return element;
+            }
+            else if (m_s.compare(m_pos, 4, "<!--") == 0)
+            {
+                SkipPast("-->");
+            }
+            else if (m_s.compare(m_pos, 2, "<?") == 0)
+            {
+                SkipPast("?>");
+            }
+            else
+            {
+                auto child = ParseElement(error);
+                if (!child)
+                {
+                    return nullptr;
+                }
+                element->children.push_back(std::move(child));
+            }
+        }
+
+        error = "tag " + rawName + " non chiuso";
+        return nullptr;
+    }
+
+    const std::string& m_s;
+    size_t m_pos;
+};
+
+} // namespace
+
+const XmlElement*
+XmlElement::Child(const std::string& childName) const
+{
+    for (const auto& c : children)
+    {
+        if (c->name == childName)
+        {
+            return c.get();
+        }
+    }
+    return nullptr;
+}
+
+std::vector<const XmlElement*>
+XmlElement::Children(const std::string& childName) const
+{
+    std::vector<const XmlElement*> result;
+    for (const auto& c : children)
+    {
+        if (c->name == childName)
+        {
+            result.push_back(c.get());
+        }
+    }
+    return result;
+}
+
+std::string
+XmlElement::ChildText(const std::string& childName) const
+{
+    const XmlElement* c = Child(childName);
+    return c ? c->text : std::string();
+}
+
+std::string
+XmlElement::Attribute(const std::string& key) const
+{
+    auto it = attributes.find(key);
+    return it == attributes.end() ? std::string() : it->second;
+}
+
+std::unique_ptr<XmlElement>
+ParseXml(const std::string& content, std::string& error)
+{
+    error.clear();
+    XmlParser parser(content);
+    return parser.ParseDocument(error);
+}
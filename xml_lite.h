@@ -0,0 +1,32 @@
+#ifndef XML_LITE_H
+#define XML_LITE_H
+
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+// Parser XML minimale per i file SNDlib e GraphML: elementi, attributi e testo.
+// Non gestisce DTD né CDATA; i prefissi dei namespace vengono rimossi dai nomi.
+struct XmlElement
+{
+    std::string name;
+    std::map<std::string, std::string> attributes;
+    std::string text; // testo diretto dell'elemento, senza spazi iniziali e finali
+    std::vector<std::unique_ptr<XmlElement>> children;
+
+    // primo figlio con il nome dato, nullptr se assente
+    const XmlElement* Child(const std::string& childName) const;
+    // tutti i figli con il nome dato
+    std::vector<const XmlElement*> Children(const std::string& childName) const;
+    // testo del figlio con il nome dato, stringa vuota se assente
+    std::string ChildText(const std::string& childName) const;
+    // valore dell'attributo, stringa vuota se assente
+    std::string Attribute(const std::string& key) const;
+};
+
+// restituisce la radice del documento; in caso di errore restituisce nullptr
+// e scrive la descrizione in error
+std::unique_ptr<XmlElement> ParseXml(const std::string& content, std::string& error);
+
+#endif // XML_LITE_H